@@ -76,6 +76,7 @@ class JClassFieldInfo {  /* common java class field info */
 };
 
 using JClassLayout = MapleVector<JClassFieldInfo>;  /* java class layout info */
+using FieldOffsetTable = MapleVector<std::pair<int32, int32>>;  /* indexed by field-id */
 
 class BECommon {
  public:
@@ -199,6 +200,8 @@ class BECommon {
   void ComputeClassTypeSizesAligns(MIRType &ty, const TyIdx &tyIdx, uint8 align = 0);
   void ComputeArrayTypeSizesAligns(MIRType &ty, const TyIdx &tyIdx);
   void ComputeFArrayOrJArrayTypeSizesAligns(MIRType &ty, const TyIdx &tyIdx);
+  const FieldOffsetTable &GetStructFieldOffsets(const MIRStructType &structType);
+  void ComputeStructFieldOffsets(const MIRStructType &structType, FieldOffsetTable &offsets);
 
   MIRModule &mirModule;
   MapleVector<uint64> typeSizeTable;           /* index is TyIdx */
@@ -214,6 +217,11 @@ class BECommon {
    * Note: currently only for java class types.
    */
   MapleUnorderedMap<MIRClassType*, JClassLayout*> jClassLayoutTable;
+  /*
+   * the (byteoffset, bitoffset) pairs returned by GetFieldOffset for the
+   * non-class struct types, built on the first query of each type
+   */
+  MapleUnorderedMap<uint32, FieldOffsetTable*> structFieldOffsetTable;
 }; /* class BECommon */
 }  /* namespace maplebe */
 
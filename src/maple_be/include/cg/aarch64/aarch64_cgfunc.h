@@ -427,6 +427,7 @@ class AArch64CGFunc : public CGFunc {
   AArch64MemOperand &CreateReplacementMemOperand(uint32 bitLen, RegOperand &baseReg, int32 offset);
 
   bool HasStackLoadStore();
+  bool IsFrameAddressEscaped() const;
 
   int32 GetSplitBaseOffset() const {
     return splitStpldpBaseOffset;
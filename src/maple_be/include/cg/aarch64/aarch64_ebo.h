@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLEBE_INCLUDE_CG_AARCH64_AARCH64_EBO_H
+#define MAPLEBE_INCLUDE_CG_AARCH64_AARCH64_EBO_H
+
+#include "ebo.h"
+#include "aarch64_operand.h"
+
+namespace maplebe {
+using namespace maple;
+
+class AArch64Ebo : public Ebo {
+ public:
+  AArch64Ebo(CGFunc &func, MemPool &memPool, bool afterRegAlloc) : Ebo(func, memPool, afterRegAlloc) {}
+
+  ~AArch64Ebo() override = default;
+
+ protected:
+  void OptimizeInsn(Insn &insn, EboState &state) override;
+  bool IsSideEffectFree(const Insn &insn) const override;
+  bool CanTrackStackSlots() const override;
+  bool IsPhysicalRegNO(regno_t regNO) const override;
+  bool CanHoldValue(const RegOperand &regOpnd) const override;
+
+ private:
+  bool IsBarrier(const Insn &insn) const;
+  bool GetStackSlot(const AArch64MemOperand &memOpnd, MOperator loadOp, EboValue &slot) const;
+  void KillDefs(const Insn &insn, EboState &state) const;
+  void OptimizeRematerialization(Insn &insn, EboState &state, const EboValue &value, MOperator copyOp);
+  void OptimizeCopy(const Insn &insn, EboState &state) const;
+  void OptimizeStore(const Insn &insn, EboState &state) const;
+};
+}  /* namespace maplebe */
+
+#endif  /* MAPLEBE_INCLUDE_CG_AARCH64_AARCH64_EBO_H */
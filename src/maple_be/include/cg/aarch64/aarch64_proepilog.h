@@ -27,11 +27,17 @@ using namespace maple;
 
 class AArch64GenProEpilog : public GenProEpilog {
  public:
-  explicit AArch64GenProEpilog(CGFunc &func) : GenProEpilog(func) {}
+  AArch64GenProEpilog(CGFunc &func, MemPool &memPool)
+      : GenProEpilog(func), tmpAlloc(&memPool), tailCallSites(tmpAlloc.Adapter()) {}
   ~AArch64GenProEpilog() override = default;
 
   void Run() override;
+  bool TailCallOpt() override;
  private:
+  bool IsTailCallCandidate(const Insn &insn) const;
+  void CollectTailCallSites(BB &bb, uint32 depth);
+  bool IsTailCallSite(const Insn &insn) const;
+  bool IsUnreachableAfterTailCalls(const BB &bb, uint32 depth) const;
   void GenStackGuard(BB&);
   BB &GenStackGuardCheckInsn(BB&);
   AArch64MemOperand *SplitStpLdpOffsetForCalleeSavedWithAddInstruction(const AArch64MemOperand &mo, uint32 bitLen,
@@ -52,7 +58,10 @@ class AArch64GenProEpilog : public GenProEpilog {
   void AppendInstructionDeallocateCallFrameDebug(AArch64reg reg0, AArch64reg reg1, RegType rty);
   void GeneratePopRegs();
   void AppendJump(const MIRSymbol &func);
+  void AppendCfiRememberState(BB &bb);
+  void AppendFrameTeardown();
   void GenerateEpilog(BB&);
+  void GenerateEpilogForTailCall(Insn &callInsn);
   void GenerateEpilogForCleanup(BB&);
   Insn &CreateAndAppendInstructionForAllocateCallFrame(int64 argsToStkPassSize, AArch64reg reg0, AArch64reg reg1,
                                                        RegType rty);
@@ -60,6 +69,8 @@ class AArch64GenProEpilog : public GenProEpilog {
                                                           RegType rty, bool isAllocate);
   static constexpr const int32 kOffset8MemPos = 8;
   static constexpr const int32 kOffset16MemPos = 16;
+  MapleAllocator tmpAlloc;
+  MapleVector<Insn*> tailCallSites;  /* bl insns to be turned into b after the epilogue */
 };
 }  /* namespace maplebe */
 
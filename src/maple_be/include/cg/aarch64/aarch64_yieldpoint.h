@@ -16,6 +16,7 @@
 #define MAPLEBE_INCLUDE_CG_AARCH64_AARCH64_YIELDPOINT_H
 
 #include "yieldpoint.h"
+#include "loop.h"
 
 namespace maplebe {
 using namespace maple;
@@ -30,6 +31,8 @@ class AArch64YieldPointInsertion : public YieldPointInsertion {
 
  private:
   void InsertYieldPoint();
+  bool IsBoundedCountedLoop(const CGFuncLoops &loop) const;
+  bool FindInductionInit(const BB &preheader, regno_t ivRegNO, bool is64Bit, int64 &initVal) const;
 };
 }  /* namespace maplebe */
 
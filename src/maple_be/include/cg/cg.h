@@ -215,6 +215,14 @@ class CG {
     return cgOption.DoPrologueEpilogue();
   }
 
+  bool DoTailCall() const {
+    return cgOption.DoTailCall();
+  }
+
+  bool DoTailCallInJava() const {
+    return cgOption.DoTailCallInJava();
+  }
+
   bool DoCheckSOE() const {
     return cgOption.DoCheckSOE();
   }
@@ -45,6 +45,9 @@ class CGOptions : public MapleDriverOptionBase {
     kGenYieldPoint = 1ULL << 9,
     kGenLocalRc = 1ULL << 10,
     kProEpilogueOpt = 1ULL << 11,
+    kEBOOpt = 1ULL << 12,
+    kTailCallOpt = 1ULL << 13,
+    kTailCallJava = 1ULL << 14,
     kDebugFriendly = 1ULL << 20,
     kWithLoc = 1ULL << 21,
     kWithDwarf = 1ULL << 22,
@@ -202,6 +205,18 @@ class CGOptions : public MapleDriverOptionBase {
     return (options & kProEpilogueOpt) != 0;
   }
 
+  bool DoEBO() const {
+    return (options & kEBOOpt) != 0;
+  }
+
+  bool DoTailCall() const {
+    return (options & kTailCallOpt) != 0;
+  }
+
+  bool DoTailCallInJava() const {
+    return (options & kTailCallJava) != 0;
+  }
+
   bool AddStackGuard() const {
     return (options & kUseStackGuard) != 0;
   }
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLEBE_INCLUDE_CG_EBO_H
+#define MAPLEBE_INCLUDE_CG_EBO_H
+
+#include <map>
+#include <tuple>
+#include "cgfunc.h"
+#include "cg_phase.h"
+
+namespace maplebe {
+/* A value that can be held by a register: a constant, a symbol address or the content of a stack slot. */
+struct EboValue {
+  enum EboValueKind : uint8 {
+    kEboConst,
+    kEboSymPage,
+    kEboSymAddr,
+    kEboStackSlot
+  };
+
+  EboValueKind kind = kEboConst;
+  MOperator mOp = 0;  /* opcode producing the value, keeps different widths apart */
+  const MIRSymbol *symbol = nullptr;
+  int64 value = 0;    /* immediate, symbol offset or slot offset */
+  int32 relocs = 0;
+  regno_t baseRegNO = 0;
+  uint32 size = 0;    /* slot size in bytes */
+  uint8 vary = 0;
+
+  bool operator<(const EboValue &other) const {
+    return std::tie(kind, mOp, symbol, value, relocs, baseRegNO, size, vary) <
+           std::tie(other.kind, other.mOp, other.symbol, other.value, other.relocs, other.baseRegNO, other.size,
+                    other.vary);
+  }
+
+  bool operator==(const EboValue &other) const {
+    return !(*this < other) && !(other < *this);
+  }
+};
+
+/*
+ * What is known at a program point of an extended basic block. It is copied into every branch of
+ * the block tree, so it lives on the heap and is released as soon as the branch is done.
+ */
+struct EboState {
+  std::map<EboValue, RegOperand*> valueHolders;  /* a register currently holding the value */
+  std::multimap<regno_t, EboValue> regValues;    /* all values a register currently holds */
+};
+
+/*
+ * Extended basic block optimization. Registers are value numbered along each extended basic block
+ * (a tree of blocks whose non-root members have a single predecessor), so that re-materialized
+ * constants, symbol addresses and stack-slot reloads are deleted or turned into register moves,
+ * and stored registers are forwarded to later loads of the same slot.
+ */
+class Ebo {
+ public:
+  Ebo(CGFunc &func, MemPool &memPool, bool afterRegAlloc)
+      : cgFunc(&func),
+        eboAllocator(&memPool),
+        visited(eboAllocator.Adapter()),
+        vRegUseCount(eboAllocator.Adapter()),
+        beforeRegAlloc(!afterRegAlloc) {}
+
+  virtual ~Ebo() = default;
+
+  void Run();
+
+  std::string PhaseName() const {
+    return beforeRegAlloc ? "ebo" : "postebo";
+  }
+
+ protected:
+  /* the tracked values of the state that are invalidated by a def of regNO */
+  void KillReg(EboState &state, regno_t regNO) const;
+  void KillPhysicalRegs(EboState &state) const;
+  void KillStackSlots(EboState &state) const;
+  void KillOverlappedSlots(EboState &state, const EboValue &slot) const;
+  void BindValue(EboState &state, RegOperand &regOpnd, const EboValue &value) const;
+  bool HoldsValue(const EboState &state, regno_t regNO, const EboValue &value) const;
+  RegOperand *FindHolder(const EboState &state, const EboValue &value) const;
+
+  void UpdateUseCount(const Insn &insn, int32 delta);
+  void DeleteInsn(Insn &insn);
+  void ReplaceInsn(Insn &insn, Insn &newInsn);
+
+  /* target hooks */
+  virtual void OptimizeInsn(Insn &insn, EboState &state) = 0;
+  virtual bool IsSideEffectFree(const Insn &insn) const = 0;
+  virtual bool CanTrackStackSlots() const = 0;
+  virtual bool IsPhysicalRegNO(regno_t regNO) const = 0;
+  virtual bool CanHoldValue(const RegOperand &regOpnd) const = 0;
+
+  CGFunc *cgFunc;
+  MapleAllocator eboAllocator;
+  MapleVector<bool> visited;
+  MapleVector<int32> vRegUseCount;
+  bool beforeRegAlloc;
+  bool trackStackSlots = false;
+  uint32 numDeleted = 0;
+  uint32 numReplaced = 0;
+
+ private:
+  void OptimizeBB(BB &bb, EboState &state);
+  void OptimizeEBB(BB &root);
+  bool IsEBBSucc(const BB &bb) const;
+  void CountVRegUses();
+  void RemoveDeadDefs();
+};
+
+CGFUNCPHASE(CgDoEbo, "ebo")
+CGFUNCPHASE(CgDoPostEbo, "postebo")
+}  /* namespace maplebe */
+
+#endif  /* MAPLEBE_INCLUDE_CG_EBO_H */
@@ -29,7 +29,8 @@ BECommon::BECommon(MIRModule &mod)
       tableAlignTable(GlobalTables::GetTypeTable().GetTypeTable().size(), 0, mirModule.GetMPAllocator().Adapter()),
       structFieldCountTable(GlobalTables::GetTypeTable().GetTypeTable().size(),
                             0, mirModule.GetMPAllocator().Adapter()),
-      jClassLayoutTable(mirModule.GetMPAllocator().Adapter()) {
+      jClassLayoutTable(mirModule.GetMPAllocator().Adapter()),
+      structFieldOffsetTable(mirModule.GetMPAllocator().Adapter()) {
     for (uint32 i = 1; i < GlobalTables::GetTypeTable().GetTypeTable().size(); ++i) {
       MIRType *ty = GlobalTables::GetTypeTable().GetTypeTable()[i];
       ComputeTypeSizesAligns(*ty);
@@ -480,9 +481,6 @@ void BECommon::GenObjSize(MIRClassType &classType, FILE &outFile) {
  */
 std::pair<int32, int32> BECommon::GetFieldOffset(MIRStructType &structType, FieldID fieldID) {
   CHECK_FATAL(fieldID <= GetStructFieldCount(structType.GetTypeIndex()), "GetFieldOFfset: fieldID too large");
-  uint64 allocedSize = 0;
-  uint64 allocedSizeInBits = 0;
-  FieldID curFieldID = 1;
   if (fieldID == 0) {
     return std::pair<int32, int32>(0, 0);
   }
@@ -494,14 +492,43 @@ std::pair<int32, int32> BECommon::GetFieldOffset(MIRStructType &structType, Fiel
     return std::pair<int32, int32>(static_cast<int32>(layout[fieldID - 1].GetOffset()), 0);
   }
 
-  /* process the struct fields */
-  FieldVector fields = structType.GetFields();
-  for (uint32 j = 0; j < fields.size(); ++j) {
+  const FieldOffsetTable &offsets = GetStructFieldOffsets(structType);
+  CHECK_FATAL(static_cast<uint32>(fieldID) < offsets.size() && offsets[fieldID].second >= 0,
+              "GetFieldOffset() fails to find field");
+  return offsets[fieldID];
+}
+
+const FieldOffsetTable &BECommon::GetStructFieldOffsets(const MIRStructType &structType) {
+  auto it = structFieldOffsetTable.find(structType.GetTypeIndex());
+  if (it != structFieldOffsetTable.end()) {
+    return *it->second;
+  }
+  /* a bitoffset of -1 marks a field-id not reached by the traversal */
+  FieldOffsetTable *offsets = mirModule.GetMemPool()->New<FieldOffsetTable>(
+      GetStructFieldCount(structType.GetTypeIndex()) + 1, std::pair<int32, int32>(-1, -1),
+      mirModule.GetMPAllocator().Adapter());
+  (*offsets)[0] = std::pair<int32, int32>(0, 0);
+  ComputeStructFieldOffsets(structType, *offsets);
+  structFieldOffsetTable[structType.GetTypeIndex()] = offsets;
+  return *offsets;
+}
+
+/*
+ * lay out the fields the same way as ComputeStructTypeSizesAligns, recording the
+ * offset of every field-id; the field-ids of a nested struct follow its own
+ */
+void BECommon::ComputeStructFieldOffsets(const MIRStructType &structType, FieldOffsetTable &offsets) {
+  uint64 allocedSize = 0;
+  uint64 allocedSizeInBits = 0;
+  FieldID curFieldID = 1;
+  const FieldVector &fields = structType.GetFields();
+  for (uint32 j = 0; j < fields.size() && static_cast<uint32>(curFieldID) < offsets.size(); ++j) {
     TyIdx fieldTyIdx = fields[j].second.first;
     MIRType *fieldType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(fieldTyIdx);
     uint32 fieldTypeSize = GetTypeSize(fieldTyIdx);
     uint8 fieldAlign = GetTypeAlign(fieldTyIdx);
     CHECK_FATAL(fieldAlign != 0, "fieldAlign should not equal 0");
+    uint64 baseOffset = 0;
     if (structType.GetKind() != kTypeUnion) {
       if (fieldType->GetKind() == kTypeBitField) {
         uint32 fieldSize = static_cast<MIRBitFieldType*>(fieldType)->GetFieldSize();
@@ -514,57 +541,32 @@ std::pair<int32, int32> BECommon::GetFieldOffset(MIRStructType &structType, Fiel
           allocedSizeInBits = RoundUp(allocedSizeInBits, fieldAlign * kBitsPerByte);
         }
         /* allocate the bitfield */
-        if (curFieldID == fieldID) {
-          return std::pair<int32, int32>((allocedSizeInBits / (fieldAlign * 8u)) * fieldAlign,
-                                         allocedSizeInBits % (fieldAlign * 8u));
-        } else if (fieldType->GetKind() == kTypeStruct) {
-          if ((curFieldID + GetStructFieldCount(fieldTyIdx)) >= fieldID) {
-            MIRStructType *subStructType = static_cast<MIRStructType*>(fieldType);
-            std::pair<int32, int32> result = GetFieldOffset(*subStructType, fieldID - curFieldID);
-            return std::pair<int32, int32>(result.first + allocedSize, result.second);
-          }
-          curFieldID += GetStructFieldCount(fieldTyIdx) + 1;
-        } else {
-          ++curFieldID;
-        }
+        offsets[curFieldID] = std::pair<int32, int32>((allocedSizeInBits / (fieldAlign * 8u)) * fieldAlign,
+                                                      allocedSizeInBits % (fieldAlign * 8u));
+        ++curFieldID;
         allocedSizeInBits += fieldSize;
         allocedSize = std::max(allocedSize, RoundUp(allocedSizeInBits, fieldAlign * kBitsPerByte) / kBitsPerByte);
-      } else {
-        allocedSize = RoundUp(allocedSize, fieldAlign);
-
-        if (curFieldID == fieldID) {
-          return std::pair<int32, int32>(allocedSize, 0);
-        } else if (fieldType->GetKind() == kTypeStruct) {
-          if ((curFieldID + GetStructFieldCount(fieldTyIdx)) >= fieldID) {
-            MIRStructType *subStructType = static_cast<MIRStructType*>(fieldType);
-            std::pair<int32, int32> result = GetFieldOffset(*subStructType, fieldID - curFieldID);
-            return std::pair<int32, int32>(result.first + allocedSize, result.second);
-          }
-          curFieldID += GetStructFieldCount(fieldTyIdx) + 1;
-        } else {
-          ++curFieldID;
-        }
-
-        allocedSize += fieldTypeSize;
-        allocedSizeInBits = allocedSize * kBitsPerByte;
+        continue;
       }
-    } else {  /* for unions, bitfields are treated as non-bitfields */
-      if (curFieldID == fieldID) {
-        return std::pair<int32, int32>(0, 0);
-      } else if (fieldType->GetKind() == kTypeStruct) {
-        /* union cannot be kTypeClass */
-        if ((curFieldID + GetStructFieldCount(fieldTyIdx)) >= fieldID) {
-          return GetFieldOffset(static_cast<MIRStructType&>(*fieldType), fieldID - curFieldID);
+      allocedSize = RoundUp(allocedSize, fieldAlign);
+      baseOffset = allocedSize;
+      allocedSize += fieldTypeSize;
+      allocedSizeInBits = allocedSize * kBitsPerByte;
+    }
+    /* for unions, bitfields are treated as non-bitfields */
+    offsets[curFieldID] = std::pair<int32, int32>(baseOffset, 0);
+    if (fieldType->GetKind() == kTypeStruct) {
+      const FieldOffsetTable &subOffsets = GetStructFieldOffsets(static_cast<MIRStructType&>(*fieldType));
+      for (uint32 i = 1; i < subOffsets.size() && curFieldID + i < offsets.size(); ++i) {
+        if (subOffsets[i].second >= 0) {
+          offsets[curFieldID + i] = std::pair<int32, int32>(subOffsets[i].first + baseOffset, subOffsets[i].second);
         }
-        curFieldID += GetStructFieldCount(fieldTyIdx) + 1;
-      } else {
-        ++curFieldID;
       }
+      curFieldID += GetStructFieldCount(fieldTyIdx) + 1;
+    } else {
+      ++curFieldID;
     }
   }
-  CHECK_FATAL(false, "GetFieldOffset() fails to find field");
-
-  return std::pair<int32, int32>(0, 0);
 }
 
 bool BECommon::TyIsInSizeAlignTable(const MIRType &ty) const {
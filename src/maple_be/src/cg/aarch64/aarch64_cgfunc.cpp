@@ -19,6 +19,7 @@
 #include "cfi.h"
 #include "mpl_logging.h"
 #include "aarch64_rt.h"
+#include "aarch64_cg.h"
 #include "opcode_info.h"
 #include "mir_builder.h"
 #include "mpl_atomic.h"
@@ -3938,6 +3939,52 @@ bool AArch64CGFunc::HasStackLoadStore() {
   return false;
 }
 
+/*
+ * Return true if the address of any stack slot may be taken, i.e. some insn reads a frame
+ * register and defines another register with it, stores it to memory, or passes it to a call.
+ */
+bool AArch64CGFunc::IsFrameAddressEscaped() const {
+  auto isFrameReg = [](const RegOperand &regOpnd) {
+    regno_t regNO = regOpnd.GetRegisterNumber();
+    return regNO == RSP || regNO == RFP || regOpnd.IsOfVary();
+  };
+  FOR_ALL_BB_CONST(bb, this) {
+    FOR_BB_INSNS_CONST(insn, bb) {
+      if (!insn->IsMachineInstruction()) {
+        continue;
+      }
+      const AArch64MD *md = &AArch64CG::kMd[insn->GetMachineOpcode()];
+      bool useFrameReg = false;
+      bool defOtherReg = false;
+      for (uint32 i = 0; i < insn->GetOperandSize(); ++i) {
+        Operand &opnd = insn->GetOperand(i);
+        if (opnd.IsList()) {
+          /* the registers a call reads its arguments from */
+          for (const RegOperand *argOpnd : static_cast<ListOperand&>(opnd).GetOperands()) {
+            useFrameReg = useFrameReg || isFrameReg(*argOpnd);
+          }
+          continue;
+        }
+        if (!opnd.IsRegister()) {
+          continue;
+        }
+        auto &regOpnd = static_cast<RegOperand&>(opnd);
+        if (md->GetOperand(i)->IsRegUse() && isFrameReg(regOpnd)) {
+          useFrameReg = true;
+        }
+        if (md->GetOperand(i)->IsRegDef() && !isFrameReg(regOpnd)) {
+          defOtherReg = true;
+        }
+      }
+      /* a frame register as base of a memory operand is not a register operand, only stored values are */
+      if (useFrameReg && (defOtherReg || md->IsStore() || insn->IsCall() || insn->IsTailCall())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 void AArch64CGFunc::GenerateYieldpoint(BB &bb) {
   /* ldr wzr, [RYP]  # RYP hold address of the polling page. */
   auto &wzr = AArch64RegOperand::Get32bitZeroRegister();
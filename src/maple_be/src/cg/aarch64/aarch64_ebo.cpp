@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "aarch64_ebo.h"
+#include <vector>
+#include "aarch64_cg.h"
+#include "aarch64_cgfunc.h"
+
+namespace maplebe {
+using namespace maple;
+namespace {
+constexpr uint32 kPairSlotNum = 2;
+
+/* the register copy replacing a reload of a slot written or read by opcode mOp */
+MOperator GetCopyOpForLoad(MOperator mOp) {
+  switch (mOp) {
+    case MOP_wldr:
+      return MOP_wmovrr;
+    case MOP_xldr:
+      return MOP_xmovrr;
+    case MOP_sldr:
+      return MOP_xvmovs;
+    case MOP_dldr:
+      return MOP_xvmovd;
+    default:
+      return MOP_undef;
+  }
+}
+
+/* the load reading back exactly what the store wrote */
+MOperator GetLoadForStore(MOperator mOp) {
+  switch (mOp) {
+    case MOP_wstr:
+      return MOP_wldr;
+    case MOP_xstr:
+      return MOP_xldr;
+    case MOP_sstr:
+      return MOP_sldr;
+    case MOP_dstr:
+      return MOP_dldr;
+    default:
+      return MOP_undef;
+  }
+}
+
+bool IsFrameReg(const RegOperand &regOpnd) {
+  regno_t regNO = regOpnd.GetRegisterNumber();
+  return regNO == RFP || regNO == RSP || regOpnd.IsOfVary();
+}
+}  /* namespace */
+
+bool AArch64Ebo::IsPhysicalRegNO(regno_t regNO) const {
+  return AArch64isa::IsPhysicalRegister(regNO);
+}
+
+/* scratch registers may be clobbered by code inserted after regalloc, so they never keep a value */
+bool AArch64Ebo::CanHoldValue(const RegOperand &regOpnd) const {
+  if (regOpnd.IsVirtualRegister()) {
+    return true;
+  }
+  regno_t regNO = regOpnd.GetRegisterNumber();
+  return regNO != R16 && regNO != R17 && regNO != RLR && regNO != RFP && regNO != RSP && regNO != RZR &&
+         regNO != RYP;
+}
+
+/* without an escaping frame address, only direct fp/sp based accesses can touch a stack slot */
+bool AArch64Ebo::CanTrackStackSlots() const {
+  return !static_cast<AArch64CGFunc*>(cgFunc)->IsFrameAddressEscaped();
+}
+
+/* insns clobbering caller-saved registers or memory beyond their operands, or where the GC may run */
+bool AArch64Ebo::IsBarrier(const Insn &insn) const {
+  const AArch64MD *md = &AArch64CG::kMd[insn.GetMachineOpcode()];
+  return insn.IsCall() || insn.IsTailCall() || insn.IsClinit() || insn.IsSpecialIntrinsic() || insn.IsAtomic() ||
+         insn.IsMemAccessBar() || insn.IsDMBInsn() || insn.IsYieldPoint() || md->HasLoop();
+}
+
+bool AArch64Ebo::IsSideEffectFree(const Insn &insn) const {
+  switch (insn.GetMachineOpcode()) {
+    case MOP_xmovri32:
+    case MOP_xmovri64:
+    case MOP_xadrp:
+    case MOP_xadrpl12:
+    case MOP_wmovrr:
+    case MOP_xmovrr:
+    case MOP_xvmovs:
+    case MOP_xvmovd:
+      return true;
+    case MOP_wldr:
+    case MOP_xldr:
+    case MOP_sldr:
+    case MOP_dldr: {
+      /* a stack slot load never faults */
+      EboValue slot;
+      auto &memOpnd = static_cast<AArch64MemOperand&>(insn.GetOperand(kInsnSecondOpnd));
+      return GetStackSlot(memOpnd, insn.GetMachineOpcode(), slot);
+    }
+    default:
+      return false;
+  }
+}
+
+bool AArch64Ebo::GetStackSlot(const AArch64MemOperand &memOpnd, MOperator loadOp, EboValue &slot) const {
+  RegOperand *baseOpnd = memOpnd.GetBaseRegister();
+  if (memOpnd.GetAddrMode() != AArch64MemOperand::kAddrModeBOi || !memOpnd.IsIntactIndexed() ||
+      baseOpnd == nullptr || !IsFrameReg(*baseOpnd) || memOpnd.GetSymbol() != nullptr) {
+    return false;
+  }
+  AArch64OfstOperand *ofstOpnd = memOpnd.GetOffsetImmediate();
+  if (ofstOpnd == nullptr || ofstOpnd->IsSymOffset()) {
+    return false;
+  }
+  const AArch64MD *md = &AArch64CG::kMd[loadOp];
+  slot.kind = EboValue::kEboStackSlot;
+  slot.mOp = loadOp;
+  slot.value = ofstOpnd->GetOffsetValue();
+  slot.baseRegNO = baseOpnd->GetRegisterNumber();
+  slot.size = md->GetOperandSize() / kBitsPerByte;
+  if (md->IsLoadPair() || md->IsStorePair()) {
+    slot.size = (md->GetOperand(kInsnFirstOpnd)->GetOperandSize() / kBitsPerByte) * kPairSlotNum;
+  }
+  slot.vary = static_cast<uint8>(ofstOpnd->GetVary());
+  return true;
+}
+
+void AArch64Ebo::KillDefs(const Insn &insn, EboState &state) const {
+  for (uint32 i = 0; i < insn.GetOperandSize(); ++i) {
+    Operand &opnd = insn.GetOperand(i);
+    if (opnd.IsRegister() && insn.OpndIsDef(i)) {
+      KillReg(state, static_cast<RegOperand&>(opnd).GetRegisterNumber());
+    } else if (opnd.IsMemoryAccessOperand()) {
+      auto &memOpnd = static_cast<AArch64MemOperand&>(opnd);
+      if (memOpnd.GetAddrMode() == AArch64MemOperand::kAddrModeBOi && !memOpnd.IsIntactIndexed() &&
+          memOpnd.GetBaseRegister() != nullptr) {
+        KillReg(state, memOpnd.GetBaseRegister()->GetRegisterNumber());
+      }
+    }
+  }
+}
+
+/*
+ * insn computes value into its first operand. Drop it if the register already holds the value,
+ * or turn it into copyOp from another register holding it.
+ */
+void AArch64Ebo::OptimizeRematerialization(Insn &insn, EboState &state, const EboValue &value, MOperator copyOp) {
+  auto &destOpnd = static_cast<RegOperand&>(insn.GetOperand(kInsnFirstOpnd));
+  regno_t destNO = destOpnd.GetRegisterNumber();
+  if (!insn.GetDoNotRemove()) {
+    if (HoldsValue(state, destNO, value)) {
+      DeleteInsn(insn);
+      return;
+    }
+    RegOperand *holder = FindHolder(state, value);
+    /* before regalloc, do not stretch the live range of a physical register */
+    if (copyOp != MOP_undef && holder != nullptr && holder->GetRegisterNumber() != destNO &&
+        (!beforeRegAlloc || holder->IsVirtualRegister()) && holder->GetSize() == destOpnd.GetSize() &&
+        holder->GetRegisterType() == destOpnd.GetRegisterType()) {
+      Insn &copyInsn = cgFunc->GetCG()->BuildInstruction<AArch64Insn>(copyOp, destOpnd, *holder);
+      ReplaceInsn(insn, copyInsn);
+      KillReg(state, destNO);
+      BindValue(state, destOpnd, value);
+      return;
+    }
+  }
+  KillDefs(insn, state);
+  BindValue(state, destOpnd, value);
+}
+
+/* a full 64-bit copy also holds every value of its source */
+void AArch64Ebo::OptimizeCopy(const Insn &insn, EboState &state) const {
+  auto &destOpnd = static_cast<RegOperand&>(insn.GetOperand(kInsnFirstOpnd));
+  auto &srcOpnd = static_cast<RegOperand&>(insn.GetOperand(kInsnSecondOpnd));
+  if (destOpnd.GetRegisterNumber() == srcOpnd.GetRegisterNumber()) {
+    return;
+  }
+  std::vector<EboValue> srcValues;
+  auto range = state.regValues.equal_range(srcOpnd.GetRegisterNumber());
+  for (auto it = range.first; it != range.second; ++it) {
+    srcValues.push_back(it->second);
+  }
+  KillDefs(insn, state);
+  for (const EboValue &value : srcValues) {
+    BindValue(state, destOpnd, value);
+  }
+}
+
+void AArch64Ebo::OptimizeStore(const Insn &insn, EboState &state) const {
+  if (!trackStackSlots) {
+    return;
+  }
+  AArch64MemOperand *memOpnd = nullptr;
+  for (uint32 i = 0; i < insn.GetOperandSize(); ++i) {
+    if (insn.GetOperand(i).IsMemoryAccessOperand()) {
+      memOpnd = static_cast<AArch64MemOperand*>(&insn.GetOperand(i));
+      break;
+    }
+  }
+  /* with no escaping frame address, a store not based on a frame register cannot reach a slot */
+  if (memOpnd == nullptr || memOpnd->GetBaseRegister() == nullptr || !IsFrameReg(*memOpnd->GetBaseRegister())) {
+    return;
+  }
+  MOperator mOp = insn.GetMachineOpcode();
+  MOperator loadOp = GetLoadForStore(mOp);
+  EboValue slot;
+  if (!GetStackSlot(*memOpnd, (loadOp == MOP_undef) ? mOp : loadOp, slot)) {
+    KillStackSlots(state);
+    return;
+  }
+  KillOverlappedSlots(state, slot);
+  auto &srcOpnd = static_cast<RegOperand&>(insn.GetOperand(kInsnFirstOpnd));
+  if (loadOp != MOP_undef && !srcOpnd.IsZeroRegister()) {
+    BindValue(state, srcOpnd, slot);
+  }
+}
+
+void AArch64Ebo::OptimizeInsn(Insn &insn, EboState &state) {
+  if (IsBarrier(insn)) {
+    KillDefs(insn, state);
+    KillPhysicalRegs(state);
+    KillStackSlots(state);
+    return;
+  }
+  MOperator mOp = insn.GetMachineOpcode();
+  EboValue value;
+  switch (mOp) {
+    case MOP_xmovri32:
+    case MOP_xmovri64: {
+      Operand &srcOpnd = insn.GetOperand(kInsnSecondOpnd);
+      if (!srcOpnd.IsIntImmediate()) {
+        break;
+      }
+      value.kind = EboValue::kEboConst;
+      value.mOp = mOp;
+      value.value = static_cast<ImmOperand&>(srcOpnd).GetValue();
+      OptimizeRematerialization(insn, state, value, MOP_undef);
+      return;
+    }
+    case MOP_xadrp: {
+      Operand &srcOpnd = insn.GetOperand(kInsnSecondOpnd);
+      if (!srcOpnd.IsStImmediate()) {
+        break;
+      }
+      auto &stImmOpnd = static_cast<StImmOperand&>(srcOpnd);
+      value.kind = EboValue::kEboSymPage;
+      value.mOp = mOp;
+      value.symbol = stImmOpnd.GetSymbol();
+      value.value = stImmOpnd.GetOffset();
+      value.relocs = stImmOpnd.GetRelocs();
+      OptimizeRematerialization(insn, state, value, MOP_undef);
+      return;
+    }
+    case MOP_xadrpl12: {
+      /* add xd, xs, :lo12:sym is the address of sym only if xs holds its page */
+      auto &baseOpnd = static_cast<RegOperand&>(insn.GetOperand(kInsnSecondOpnd));
+      Operand &symOpnd = insn.GetOperand(kInsnThirdOpnd);
+      if (!symOpnd.IsStImmediate()) {
+        break;
+      }
+      auto &stImmOpnd = static_cast<StImmOperand&>(symOpnd);
+      value.kind = EboValue::kEboSymPage;
+      value.mOp = MOP_xadrp;
+      value.symbol = stImmOpnd.GetSymbol();
+      value.value = stImmOpnd.GetOffset();
+      value.relocs = stImmOpnd.GetRelocs();
+      if (!HoldsValue(state, baseOpnd.GetRegisterNumber(), value)) {
+        break;
+      }
+      value.kind = EboValue::kEboSymAddr;
+      value.mOp = mOp;
+      /* after regalloc a copy is no cheaper than the add itself */
+      OptimizeRematerialization(insn, state, value, beforeRegAlloc ? MOP_xmovrr : MOP_undef);
+      return;
+    }
+    case MOP_wldrsb:
+    case MOP_wldrb:
+    case MOP_wldrsh:
+    case MOP_wldrh:
+    case MOP_wldr:
+    case MOP_xldr:
+    case MOP_sldr:
+    case MOP_dldr: {
+      auto &memOpnd = static_cast<AArch64MemOperand&>(insn.GetOperand(kInsnSecondOpnd));
+      if (!trackStackSlots || !GetStackSlot(memOpnd, mOp, value)) {
+        break;
+      }
+      OptimizeRematerialization(insn, state, value, GetCopyOpForLoad(mOp));
+      return;
+    }
+    case MOP_xmovrr:
+      OptimizeCopy(insn, state);
+      return;
+    default:
+      if (insn.IsStore() || insn.IsStorePair()) {
+        OptimizeStore(insn, state);
+      }
+      break;
+  }
+  KillDefs(insn, state);
+}
+}  /* namespace maplebe */
@@ -13,6 +13,7 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "aarch64_proepilog.h"
+#include "aarch64_cg.h"
 #include "cg_option.h"
 
 namespace maplebe {
@@ -20,6 +21,8 @@ using namespace maple;
 
 namespace {
 constexpr int32 kSoeChckOffset = 8192;
+/* how many empty fallthru blocks to look through when searching the call sites in front of an exit bb. */
+constexpr uint32 kMaxTailCallSearchDepth = 4;
 
 enum RegsPushPop : uint8 {
   kRegsPushOp,
@@ -662,6 +665,105 @@ void AArch64GenProEpilog::GenerateProlog(BB &bb) {
   cgFunc.SetCurBB(*formerCurBB);
 }
 
+bool AArch64GenProEpilog::IsTailCallCandidate(const Insn &insn) const {
+  if (!insn.IsMachineInstruction() || insn.GetMachineOpcode() != MOP_xbl) {
+    return false;
+  }
+  Insn &callInsn = const_cast<Insn&>(insn);
+  if (callInsn.IsCallToFunctionThatNeverReturns()) {
+    return false;
+  }
+  const BB *bb = insn.GetBB();
+  if (bb == nullptr || !bb->GetEhSuccs().empty() || bb->GetSuccs().size() > 1) {
+    return false;
+  }
+  auto *target = static_cast<FuncNameOperand*>(callInsn.GetCallTargetOperand());
+  if (target == nullptr || target->GetFunctionSymbol()->GetSKind() != kStFunc) {
+    return false;
+  }
+  const MIRFunction &caller = cgFunc.GetFunction();
+  if (!caller.IsJava()) {
+    return true;
+  }
+  /*
+   * The frame of a Java caller would be missing from exception stack traces and stack walks, so
+   * it is left out unless asked for. Caller-sensitive methods find their caller by walking the
+   * stack, and so may the runtime and library entries not compiled in this module, so only
+   * sibling-call Java methods with a body here.
+   */
+  if (!cgFunc.GetCG()->DoTailCallInJava()) {
+    return false;
+  }
+  const MIRFunction *callee = target->GetFunctionSymbol()->GetFunction();
+  return callee != nullptr && callee->GetBody() != nullptr && !callee->IsAnyNative() &&
+         !callee->GetAttr(FUNCATTR_callersensitive) && !caller.GetAttr(FUNCATTR_callersensitive);
+}
+
+/* bb has no code of its own and falls into an exit bb, look for calls right in front of it. */
+void AArch64GenProEpilog::CollectTailCallSites(BB &bb, uint32 depth) {
+  for (BB *pred : bb.GetPreds()) {
+    Insn *lastInsn = pred->GetLastMachineInsn();
+    if (lastInsn == nullptr) {
+      if (depth < kMaxTailCallSearchDepth && pred->GetSuccs().size() == 1) {
+        CollectTailCallSites(*pred, depth + 1);
+      }
+      continue;
+    }
+    if (IsTailCallCandidate(*lastInsn)) {
+      tailCallSites.push_back(lastInsn);
+    }
+  }
+}
+
+bool AArch64GenProEpilog::IsTailCallSite(const Insn &insn) const {
+  return std::find(tailCallSites.begin(), tailCallSites.end(), &insn) != tailCallSites.end();
+}
+
+/* control reached bb only through calls that became sibling calls, looking as far as CollectTailCallSites does */
+bool AArch64GenProEpilog::IsUnreachableAfterTailCalls(const BB &bb, uint32 depth) const {
+  if (&bb == cgFunc.GetFirstBB() || !bb.GetEhPreds().empty() || depth > kMaxTailCallSearchDepth) {
+    return false;
+  }
+  for (const BB *pred : bb.GetPreds()) {
+    if (!IsUnreachableAfterTailCalls(*pred, depth + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Sibling call optimization: a call directly followed by the function return is turned into
+ * a branch after the epilogue. It is done only if
+ *   1. no argument is passed on the stack, the outgoing area would be popped with our frame;
+ *   2. no cleanup (local ref rc, stack guard check, debug trace) runs after the call;
+ *   3. the call is not covered by a try block and no frame address escapes;
+ *   4. the caller is not Java, or --tailcall-java is given and neither the caller nor the callee
+ *      looks for its caller on the stack (see IsTailCallCandidate).
+ */
+bool AArch64GenProEpilog::TailCallOpt() {
+  CG *currCG = cgFunc.GetCG();
+  auto &aarchCGFunc = static_cast<AArch64CGFunc&>(cgFunc);
+  tailCallSites.clear();
+  if (!currCG->DoTailCall()) {
+    return false;
+  }
+  if (cgFunc.HasVLAOrAlloca() || currCG->AddStackGuard() || currCG->InstrumentWithDebugTraceCall() ||
+      cgFunc.GetMemlayout()->SizeOfArgsToStackPass() > 0 || aarchCGFunc.NeedCleanup() ||
+      aarchCGFunc.IsFrameAddressEscaped()) {
+    return false;
+  }
+  for (BB *exitBB : cgFunc.GetExitBBsVec()) {
+    Insn *lastInsn = exitBB->GetLastMachineInsn();
+    if (lastInsn == nullptr) {
+      CollectTailCallSites(*exitBB, 0);
+    } else if (IsTailCallCandidate(*lastInsn)) {
+      tailCallSites.push_back(lastInsn);
+    }
+  }
+  return !tailCallSites.empty();
+}
+
 void AArch64GenProEpilog::GenerateRet(BB &bb) {
   CG *currCG = cgFunc.GetCG();
   bb.AppendInsn(currCG->BuildInstruction<AArch64Insn>(MOP_xret));
@@ -934,46 +1036,34 @@ void AArch64GenProEpilog::AppendJump(const MIRSymbol &funcSymbol) {
   cgFunc.GetCurBB()->AppendInsn(currCG->BuildInstruction<AArch64Insn>(MOP_xuncond, targetOpnd));
 }
 
-void AArch64GenProEpilog::GenerateEpilog(BB &bb) {
-  if (!cgFunc.GetHasProEpilogue()) {
-    if (bb.GetPreds().empty() || !TestPredsOfRetBB(bb)) {
-      GenerateRet(bb);
-    }
+/*
+ * Hack: exit bb should always be reachable, since we need its existance for ".cfi_remember_state".
+ * The epilogue changes the cfa rules, so restore them at the head of the next non-empty bb.
+ */
+void AArch64GenProEpilog::AppendCfiRememberState(BB &bb) {
+  CG *currCG = cgFunc.GetCG();
+  if (&bb == cgFunc.GetLastBB() || bb.GetNext() == nullptr) {
     return;
   }
+  BB *nextBB = bb.GetNext();
+  do {
+    if (nextBB == cgFunc.GetLastBB() || !nextBB->IsEmpty()) {
+      break;
+    }
+    nextBB = nextBB->GetNext();
+  } while (nextBB != nullptr);
+  if (nextBB != nullptr && !nextBB->IsEmpty()) {
+    cgFunc.GetCurBB()->AppendInsn(currCG->BuildInstruction<cfi::CfiInsn>(cfi::OP_CFI_remember_state));
+    nextBB->InsertInsnBefore(*nextBB->GetFirstInsn(),
+                             currCG->BuildInstruction<cfi::CfiInsn>(cfi::OP_CFI_restore_state));
+  }
+}
 
-  /* generate stack protected instruction */
-  BB &epilogBB = GenStackGuardCheckInsn(bb);
-
+/* restore the callee-saved registers and pop the activation frame, insns are appended to the current bb. */
+void AArch64GenProEpilog::AppendFrameTeardown() {
   auto &aarchCGFunc = static_cast<AArch64CGFunc&>(cgFunc);
   CG *currCG = cgFunc.GetCG();
-  BB *formerCurBB = cgFunc.GetCurBB();
-  aarchCGFunc.GetDummyBB()->ClearInsns();
-  cgFunc.SetCurBB(*aarchCGFunc.GetDummyBB());
-
   Operand &spOpnd = aarchCGFunc.GetOrCreatePhysicalRegisterOperand(RSP, k64BitSize, kRegTyInt);
-  Operand &fpOpnd = aarchCGFunc.GetOrCreatePhysicalRegisterOperand(RFP, k64BitSize, kRegTyInt);
-
-  if (cgFunc.HasVLAOrAlloca()) {
-    aarchCGFunc.SelectCopy(spOpnd, PTY_u64, fpOpnd, PTY_u64);
-  }
-
-  /* Hack: exit bb should always be reachable, since we need its existance for ".cfi_remember_state" */
-  if (&epilogBB != cgFunc.GetLastBB() && epilogBB.GetNext() != nullptr) {
-    BB *nextBB = epilogBB.GetNext();
-    do {
-      if (nextBB == cgFunc.GetLastBB() || !nextBB->IsEmpty()) {
-        break;
-      }
-      nextBB = nextBB->GetNext();
-    } while (nextBB != nullptr);
-    if (nextBB != nullptr && !nextBB->IsEmpty()) {
-      cgFunc.GetCurBB()->AppendInsn(currCG->BuildInstruction<cfi::CfiInsn>(cfi::OP_CFI_remember_state));
-      nextBB->InsertInsnBefore(*nextBB->GetFirstInsn(),
-                               currCG->BuildInstruction<cfi::CfiInsn>(cfi::OP_CFI_restore_state));
-    }
-  }
-
   const MapleVector<AArch64reg> &regsToSave = aarchCGFunc.GetCalleeSavedRegs();
   if (!regsToSave.empty()) {
     GeneratePopRegs();
@@ -995,6 +1085,40 @@ void AArch64GenProEpilog::GenerateEpilog(BB &bb) {
       }
     }
   }
+}
+
+void AArch64GenProEpilog::GenerateEpilog(BB &bb) {
+  if (!cgFunc.GetHasProEpilogue()) {
+    if (bb.GetPreds().empty() || !TestPredsOfRetBB(bb)) {
+      GenerateRet(bb);
+    }
+    return;
+  }
+
+  /* the exit bb ends with a sibling call, which already has its epilogue in front of it. */
+  Insn *lastInsn = bb.GetLastMachineInsn();
+  if (lastInsn != nullptr && lastInsn->GetMachineOpcode() == MOP_tail_call_opt_xbl) {
+    return;
+  }
+
+  /* generate stack protected instruction */
+  BB &epilogBB = GenStackGuardCheckInsn(bb);
+
+  auto &aarchCGFunc = static_cast<AArch64CGFunc&>(cgFunc);
+  CG *currCG = cgFunc.GetCG();
+  BB *formerCurBB = cgFunc.GetCurBB();
+  aarchCGFunc.GetDummyBB()->ClearInsns();
+  cgFunc.SetCurBB(*aarchCGFunc.GetDummyBB());
+
+  Operand &spOpnd = aarchCGFunc.GetOrCreatePhysicalRegisterOperand(RSP, k64BitSize, kRegTyInt);
+  Operand &fpOpnd = aarchCGFunc.GetOrCreatePhysicalRegisterOperand(RFP, k64BitSize, kRegTyInt);
+
+  if (cgFunc.HasVLAOrAlloca()) {
+    aarchCGFunc.SelectCopy(spOpnd, PTY_u64, fpOpnd, PTY_u64);
+  }
+
+  AppendCfiRememberState(epilogBB);
+  AppendFrameTeardown();
 
   if (currCG->InstrumentWithDebugTraceCall()) {
     AppendJump(*(currCG->GetDebugTraceExitFunction()));
@@ -1006,6 +1130,39 @@ void AArch64GenProEpilog::GenerateEpilog(BB &bb) {
   cgFunc.SetCurBB(*formerCurBB);
 }
 
+/*
+ * bl callee        =>   <epilogue>
+ * <epilogue>            b callee
+ * ret
+ * The callee returns to our caller directly and reuses our stack space.
+ */
+void AArch64GenProEpilog::GenerateEpilogForTailCall(Insn &callInsn) {
+  auto &aarchCGFunc = static_cast<AArch64CGFunc&>(cgFunc);
+  CG *currCG = cgFunc.GetCG();
+  BB &callBB = *callInsn.GetBB();
+  BB *formerCurBB = cgFunc.GetCurBB();
+  aarchCGFunc.GetDummyBB()->ClearInsns();
+  cgFunc.SetCurBB(*aarchCGFunc.GetDummyBB());
+
+  AppendCfiRememberState(callBB);
+  AppendFrameTeardown();
+  Insn &tailCallInsn = currCG->BuildInstruction<AArch64Insn>(MOP_tail_call_opt_xbl,
+                                                            callInsn.GetOperand(kInsnFirstOpnd),
+                                                            callInsn.GetOperand(kInsnSecondOpnd));
+  cgFunc.GetCurBB()->AppendInsn(tailCallInsn);
+
+  callBB.RemoveInsn(callInsn);
+  callBB.AppendBBInsns(*cgFunc.GetCurBB());
+  /* control no longer falls into the exit bb. */
+  for (BB *succ : callBB.GetSuccs()) {
+    succ->RemovePreds(callBB);
+  }
+  callBB.ClearSuccs();
+  callBB.SetKind(BB::kBBReturn);
+
+  cgFunc.SetCurBB(*formerCurBB);
+}
+
 void AArch64GenProEpilog::GenerateEpilogForCleanup(BB &bb) {
   auto &aarchCGFunc = static_cast<AArch64CGFunc&>(cgFunc);
   CG *currCG = cgFunc.GetCG();
@@ -1037,9 +1194,22 @@ void AArch64GenProEpilog::Run() {
     }
   }
 
+  bool doTailCall = TailCallOpt();
+
   GenerateProlog(*(cgFunc.GetFirstBB()));
 
+  /* the sibling calls go first, they cut the edges into the exit bbs they replace */
+  if (doTailCall) {
+    for (Insn *callInsn : tailCallSites) {
+      GenerateEpilogForTailCall(*callInsn);
+    }
+  }
+
   for (auto *exitBB : cgFunc.GetExitBBsVec()) {
+    /* all the paths into the exit bb ended in sibling calls, nothing returns through it any more. */
+    if (doTailCall && IsUnreachableAfterTailCalls(*exitBB, 0)) {
+      continue;
+    }
     GenerateEpilog(*exitBB);
   }
 
@@ -14,9 +14,95 @@
  */
 #include "aarch64_yieldpoint.h"
 #include "aarch64_cgfunc.h"
+#include "aarch64_cg.h"
 
 namespace maplebe {
 using namespace maple;
+namespace {
+/*
+ * A call-free innermost loop whose trip count is proven to be no more than this
+ * limit finishes in bounded time, so its back-edge yieldpoint can be elided.
+ */
+constexpr int64 kMaxTripCountToElideYieldPoint = 256;
+/* how many single-predecessor blocks to walk up when looking for the initial value of an iv. */
+constexpr uint32 kMaxInitSearchDepth = 4;
+
+bool IsRegDefinedByInsn(const Insn &insn, regno_t regNO) {
+  if (insn.IsCall()) {
+    return true;
+  }
+  const AArch64MD *md = &AArch64CG::kMd[static_cast<const AArch64Insn&>(insn).GetMachineOpcode()];
+  uint32 opndNum = insn.GetOperandSize();
+  for (uint32 i = 0; i < opndNum; ++i) {
+    Operand &opnd = insn.GetOperand(i);
+    if (opnd.IsMemoryAccessOperand()) {
+      auto &memOpnd = static_cast<AArch64MemOperand&>(opnd);
+      RegOperand *base = memOpnd.GetBaseRegister();
+      if ((memOpnd.IsPostIndexed() || memOpnd.IsPreIndexed()) && base != nullptr &&
+          base->GetRegisterNumber() == regNO) {
+        return true;
+      }
+      continue;
+    }
+    if (opnd.IsRegister() && md->GetOperand(i)->IsRegDef() &&
+        static_cast<RegOperand&>(opnd).GetRegisterNumber() == regNO) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* sign- or zero-extend val according to the width of the compared register. */
+int64 NormalizeValue(int64 val, bool is64Bit, bool isUnsigned) {
+  if (is64Bit) {
+    return val;
+  }
+  return isUnsigned ? static_cast<int64>(static_cast<uint32>(val)) : static_cast<int64>(static_cast<int32>(val));
+}
+
+/* return true if the condition of branch mOp holds for "cmp lhs, rhs", set valid to false if mOp is unknown. */
+bool EvalCondBranch(MOperator mOp, int64 lhs, int64 rhs, bool is64Bit, bool &valid) {
+  valid = true;
+  int64 sLhs = NormalizeValue(lhs, is64Bit, false);
+  int64 sRhs = NormalizeValue(rhs, is64Bit, false);
+  uint64 uLhs = static_cast<uint64>(NormalizeValue(lhs, is64Bit, true));
+  uint64 uRhs = static_cast<uint64>(NormalizeValue(rhs, is64Bit, true));
+  switch (mOp) {
+    case MOP_beq:
+      return uLhs == uRhs;
+    case MOP_bne:
+      return uLhs != uRhs;
+    case MOP_blt:
+      return sLhs < sRhs;
+    case MOP_ble:
+      return sLhs <= sRhs;
+    case MOP_bgt:
+      return sLhs > sRhs;
+    case MOP_bge:
+      return sLhs >= sRhs;
+    case MOP_blo:
+      return uLhs < uRhs;
+    case MOP_bls:
+      return uLhs <= uRhs;
+    case MOP_bhi:
+      return uLhs > uRhs;
+    case MOP_bhs:
+      return uLhs >= uRhs;
+    default:
+      valid = false;
+      return false;
+  }
+}
+
+Insn *GetPrevMachineInsn(Insn &insn) {
+  for (Insn *prev = insn.GetPrev(); prev != nullptr; prev = prev->GetPrev()) {
+    if (prev->IsMachineInstruction()) {
+      return prev;
+    }
+  }
+  return nullptr;
+}
+}  /* namespace */
 
 void AArch64YieldPointInsertion::Run() {
   InsertYieldPoint();
@@ -55,6 +141,11 @@ void AArch64YieldPointInsertion::InsertYieldPoint() {
     if (Globals::GetInstance()->GetOptimLevel() > 0) {
       /* insert a yieldpoint before the last jump instruction of a goto BB. */
       if (bb->IsBackEdgeDest()) {
+        CGFuncLoops *loop = bb->GetLoop();
+        if (loop != nullptr && loop->GetHeader() == bb && IsBoundedCountedLoop(*loop)) {
+          /* the loop finishes in bounded time without calls, gc is reached again after it exits. */
+          continue;
+        }
         aarchCGFunc->GetDummyBB()->ClearInsns();
         aarchCGFunc->GenerateYieldpoint(*aarchCGFunc->GetDummyBB());
         bb->InsertAtBeginning(*aarchCGFunc->GetDummyBB());
@@ -98,4 +189,138 @@ void AArch64YieldPointInsertion::InsertYieldPoint() {
     }
   }
 }
-} /* namespace maplebe */
+
+/*
+ * Given a loop with a single latch ending in
+ *   cmp  wIV, #bound
+ *   b.cc header (or falling through to header)
+ * where wIV is changed only by one "add/sub wIV, wIV, #step" in the header or latch and is
+ * initialized by "mov wIV, #init" before the loop, simulate the iv to prove the trip count bound.
+ */
+bool AArch64YieldPointInsertion::IsBoundedCountedLoop(const CGFuncLoops &loop) const {
+  if (!loop.GetInnerLoops().empty() || loop.GetBackedge().size() != 1) {
+    return false;
+  }
+  BB *header = const_cast<BB*>(loop.GetHeader());
+  BB *latch = loop.GetBackedge().front();
+  for (BB *member : loop.GetLoopMembers()) {
+    if (member->HasCall()) {
+      return false;
+    }
+    FOR_BB_INSNS(insn, member) {
+      if (insn->IsMachineInstruction() && insn->IsCall()) {
+        return false;
+      }
+    }
+  }
+  /* the exit test in the latch. */
+  Insn *branch = latch->GetLastInsn();
+  if (branch == nullptr || !branch->IsMachineInstruction() || !branch->IsCondBranch()) {
+    return false;
+  }
+  Operand *target = branch->GetOpnd(branch->GetOpndNum() - 1);
+  if (target == nullptr || !target->IsLabelOpnd()) {
+    return false;
+  }
+  bool continueOnTaken = false;
+  if (static_cast<LabelOperand*>(target)->GetLabelIndex() == header->GetLabIdx()) {
+    continueOnTaken = true;
+  } else if (latch->GetNext() != header) {
+    return false;
+  }
+  Insn *cmp = GetPrevMachineInsn(*branch);
+  if (cmp == nullptr) {
+    return false;
+  }
+  MOperator cmpOp = cmp->GetMachineOpcode();
+  if (cmpOp != MOP_wcmpri && cmpOp != MOP_xcmpri) {
+    return false;
+  }
+  bool is64Bit = (cmpOp == MOP_xcmpri);
+  regno_t ivRegNO = static_cast<RegOperand&>(cmp->GetOperand(kInsnSecondOpnd)).GetRegisterNumber();
+  int64 bound = static_cast<ImmOperand&>(cmp->GetOperand(kInsnThirdOpnd)).GetValue();
+
+  /* the only def of the iv in the loop must be executed once per iteration. */
+  Insn *ivDef = nullptr;
+  for (BB *member : loop.GetLoopMembers()) {
+    FOR_BB_INSNS(insn, member) {
+      if (!insn->IsMachineInstruction() || !IsRegDefinedByInsn(*insn, ivRegNO)) {
+        continue;
+      }
+      if (ivDef != nullptr || (member != header && member != latch)) {
+        return false;
+      }
+      ivDef = insn;
+    }
+  }
+  if (ivDef == nullptr) {
+    return false;
+  }
+  MOperator defOp = ivDef->GetMachineOpcode();
+  bool isAdd = (defOp == MOP_waddrri12 || defOp == MOP_xaddrri12);
+  bool isSub = (defOp == MOP_wsubrri12 || defOp == MOP_xsubrri12);
+  if ((!isAdd && !isSub) || ((defOp == MOP_xaddrri12 || defOp == MOP_xsubrri12) != is64Bit) ||
+      static_cast<RegOperand&>(ivDef->GetOperand(kInsnSecondOpnd)).GetRegisterNumber() != ivRegNO) {
+    return false;
+  }
+  int64 step = static_cast<ImmOperand&>(ivDef->GetOperand(kInsnThirdOpnd)).GetValue();
+  step = isSub ? -step : step;
+  if (step == 0) {
+    return false;
+  }
+
+  /* the preheader is the only predecessor of header out of the loop. */
+  BB *preheader = nullptr;
+  for (BB *pred : header->GetPreds()) {
+    if (std::find(loop.GetLoopMembers().begin(), loop.GetLoopMembers().end(), pred) != loop.GetLoopMembers().end()) {
+      continue;
+    }
+    if (preheader != nullptr) {
+      return false;
+    }
+    preheader = pred;
+  }
+  int64 ivVal = 0;
+  if (preheader == nullptr || !FindInductionInit(*preheader, ivRegNO, is64Bit, ivVal)) {
+    return false;
+  }
+  for (int64 tripCount = 1; tripCount <= kMaxTripCountToElideYieldPoint; ++tripCount) {
+    ivVal = NormalizeValue(ivVal + step, is64Bit, false);
+    bool valid = true;
+    bool taken = EvalCondBranch(branch->GetMachineOpcode(), ivVal, bound, is64Bit, valid);
+    if (!valid) {
+      return false;
+    }
+    if (taken != continueOnTaken) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AArch64YieldPointInsertion::FindInductionInit(const BB &preheader, regno_t ivRegNO, bool is64Bit,
+                                                   int64 &initVal) const {
+  const BB *bb = &preheader;
+  for (uint32 depth = 0; depth < kMaxInitSearchDepth; ++depth) {
+    for (const Insn *insn = bb->GetLastInsn(); insn != nullptr; insn = insn->GetPrev()) {
+      if (!insn->IsMachineInstruction() || !IsRegDefinedByInsn(*insn, ivRegNO)) {
+        continue;
+      }
+      MOperator mOp = insn->GetMachineOpcode();
+      if (mOp != MOP_xmovri32 && mOp != MOP_xmovri64) {
+        return false;
+      }
+      int64 val = static_cast<ImmOperand&>(insn->GetOperand(kInsnSecondOpnd)).GetValue();
+      /* a 32-bit mov clears the upper half of the register. */
+      initVal = (mOp == MOP_xmovri32) ? NormalizeValue(val, false, true) : val;
+      initVal = NormalizeValue(initVal, is64Bit, false);
+      return true;
+    }
+    if (bb->GetPreds().size() != 1 || bb->GetPreds().front() == &preheader) {
+      return false;
+    }
+    bb = bb->GetPreds().front();
+  }
+  return false;
+}
+}  /* namespace maplebe */
@@ -97,6 +97,9 @@ enum OptionIndex : uint64 {
   kCGO1,
   kCGO2,
   kProepilogue,
+  kEbo,
+  kTailCall,
+  kTailCallJava,
   kYieldPoing,
   kLocalRc,
   kCalleeCFI,
@@ -234,6 +237,37 @@ const Descriptor kUsage[] = {
     "  --no-proepilogue\n",
     "mplcg",
     {} },
+  { kEbo,
+    kEnable,
+    nullptr,
+    "ebo",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --ebo                       \tPerform redundancy elimination over extended basic blocks, off by default\n"
+    "  --no-ebo\n",
+    "mplcg",
+    {} },
+  { kTailCall,
+    kEnable,
+    nullptr,
+    "tailcall",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --tailcall                  \tTurn calls right before the return into sibling calls\n"
+    "  --no-tailcall\n",
+    "mplcg",
+    {} },
+  { kTailCallJava,
+    kEnable,
+    nullptr,
+    "tailcall-java",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --tailcall-java             \tAlso turn calls in Java methods into sibling calls, leaving the caller\n"
+    "                              \tout of exception stack traces\n"
+    "  --no-tailcall-java\n",
+    "mplcg",
+    {} },
   { kLocalRc,
     kEnable,
     nullptr,
@@ -809,6 +843,15 @@ bool CGOptions::SolveOptions(const std::vector<Option> &opts, bool isDebug) {
         (opt.Type() == kEnable) ? SetOption(CGOptions::kProEpilogueOpt)
                                 : ClearOption(CGOptions::kProEpilogueOpt);
         break;
+      case kEbo:
+        (opt.Type() == kEnable) ? SetOption(CGOptions::kEBOOpt) : ClearOption(CGOptions::kEBOOpt);
+        break;
+      case kTailCall:
+        (opt.Type() == kEnable) ? SetOption(CGOptions::kTailCallOpt) : ClearOption(CGOptions::kTailCallOpt);
+        break;
+      case kTailCallJava:
+        (opt.Type() == kEnable) ? SetOption(CGOptions::kTailCallJava) : ClearOption(CGOptions::kTailCallJava);
+        break;
       case kCGO0:
         // Already handled above in DecideMplcgRealLevel
         break;
@@ -891,18 +934,24 @@ void CGOptions::SetDefaultOptions(const maple::MIRModule &mod) {
 
 void CGOptions::EnableO0() {
   optimizeLevel = kLevel0;
+  ClearOption(kEBOOpt);
+  ClearOption(kTailCallOpt);
   SetOption(kUseStackGuard);
 }
 
 void CGOptions::EnableO1() {
   optimizeLevel = kLevel1;
   ClearOption(kProEpilogueOpt);
+  ClearOption(kEBOOpt);
+  ClearOption(kTailCallOpt);
   ClearOption(kUseStackGuard);
 }
 
 void CGOptions::EnableO2() {
   optimizeLevel = kLevel2;
   ClearOption(kProEpilogueOpt);
+  ClearOption(kEBOOpt);
+  SetOption(kTailCallOpt);
   ClearOption(kUseStackGuard);
 }
 
@@ -19,11 +19,13 @@
 #include "live.h"
 #include "loop.h"
 #include "mpl_timer.h"
+#include "trace_event.h"
 #include "args.h"
 #include "yieldpoint.h"
 #include "label_creation.h"
 #include "offset_adjust.h"
 #include "proepilog.h"
+#include "ebo.h"
 
 namespace maplebe {
 #define JAVALANG (module.IsJavaModule())
@@ -41,7 +43,11 @@ void CgFuncPhaseManager::RunFuncPhase(CGFunc &func, FuncPhase &phase) {
   /* 3. run: skip mplcg phase except "emit" if no cfg in CGFunc */
   AnalysisResult *analysisRes = nullptr;
   if ((func.NumBBs() > 0) || (phase.GetPhaseID() == kCGFuncPhaseEMIT)) {
+    TraceScope traceScope("mplcg", phase.PhaseName(), func.GetName());
     analysisRes = phase.Run(&func, &arFuncManager);
+    if (TraceEventRecorder::IsEnabled()) {
+      traceScope.SetMemPoolBytes(phase.GetMemPoolSize());
+    }
     phase.ReleaseMemPool(analysisRes == nullptr ? nullptr : analysisRes->GetMempool());
   }
 
@@ -85,8 +91,14 @@ void CgFuncPhaseManager::AddPhases(std::vector<std::string> &phases) {
       }
       ADDPHASE("handlefunction");
       ADDPHASE("moveargs");
+      if (CGOptions::GetInstance().DoEBO()) {
+        ADDPHASE("ebo");
+      }
 
       ADDPHASE("regalloc");
+      if (CGOptions::GetInstance().DoEBO()) {
+        ADDPHASE("postebo");
+      }
       ADDPHASE("generateproepilog");
       ADDPHASE("offsetadjustforfplr");
 
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "ebo.h"
+#include <algorithm>
+#if TARGAARCH64
+#include "aarch64_ebo.h"
+#endif
+#include "cg.h"
+
+namespace maplebe {
+using namespace maple;
+namespace {
+/* a huge table is not worth its lookup cost, start over once it is reached */
+constexpr size_t kMaxEboValueNum = 512;
+
+template <typename Pred>
+void EraseValues(EboState &state, const Pred &pred) {
+  for (auto it = state.valueHolders.begin(); it != state.valueHolders.end();) {
+    if (pred(it->first)) {
+      it = state.valueHolders.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = state.regValues.begin(); it != state.regValues.end();) {
+    if (pred(it->second)) {
+      it = state.regValues.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+}  /* namespace */
+
+void Ebo::KillReg(EboState &state, regno_t regNO) const {
+  auto range = state.regValues.equal_range(regNO);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto holderIt = state.valueHolders.find(it->second);
+    if (holderIt != state.valueHolders.end() && holderIt->second->GetRegisterNumber() == regNO) {
+      (void)state.valueHolders.erase(holderIt);
+    }
+  }
+  (void)state.regValues.erase(range.first, range.second);
+  /* a redefined frame register moves every slot based on it */
+  EraseValues(state, [regNO](const EboValue &value) {
+    return value.kind == EboValue::kEboStackSlot && value.baseRegNO == regNO;
+  });
+}
+
+void Ebo::KillPhysicalRegs(EboState &state) const {
+  for (auto it = state.valueHolders.begin(); it != state.valueHolders.end();) {
+    if (IsPhysicalRegNO(it->second->GetRegisterNumber())) {
+      it = state.valueHolders.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (auto it = state.regValues.begin(); it != state.regValues.end();) {
+    if (IsPhysicalRegNO(it->first)) {
+      it = state.regValues.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void Ebo::KillStackSlots(EboState &state) const {
+  EraseValues(state, [](const EboValue &value) {
+    return value.kind == EboValue::kEboStackSlot;
+  });
+}
+
+/* slots with another base or vary type may alias anything, only disjoint ranges of the same base survive */
+void Ebo::KillOverlappedSlots(EboState &state, const EboValue &slot) const {
+  EraseValues(state, [&slot](const EboValue &value) {
+    if (value.kind != EboValue::kEboStackSlot) {
+      return false;
+    }
+    if (value.baseRegNO != slot.baseRegNO || value.vary != slot.vary) {
+      return true;
+    }
+    return value.value < slot.value + slot.size && slot.value < value.value + value.size;
+  });
+}
+
+void Ebo::BindValue(EboState &state, RegOperand &regOpnd, const EboValue &value) const {
+  if (!CanHoldValue(regOpnd)) {
+    return;
+  }
+  if (state.regValues.size() >= kMaxEboValueNum) {
+    state.valueHolders.clear();
+    state.regValues.clear();
+  }
+  regno_t regNO = regOpnd.GetRegisterNumber();
+  if (!HoldsValue(state, regNO, value)) {
+    (void)state.regValues.emplace(regNO, value);
+  }
+  /* keep the oldest holder, it is the one most likely to be live already */
+  (void)state.valueHolders.emplace(value, &regOpnd);
+}
+
+bool Ebo::HoldsValue(const EboState &state, regno_t regNO, const EboValue &value) const {
+  auto range = state.regValues.equal_range(regNO);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RegOperand *Ebo::FindHolder(const EboState &state, const EboValue &value) const {
+  auto it = state.valueHolders.find(value);
+  return (it == state.valueHolders.end()) ? nullptr : it->second;
+}
+
+void Ebo::UpdateUseCount(const Insn &insn, int32 delta) {
+  auto countReg = [this, delta](const RegOperand *regOpnd) {
+    if (regOpnd != nullptr && regOpnd->GetRegisterNumber() < vRegUseCount.size()) {
+      vRegUseCount[regOpnd->GetRegisterNumber()] += delta;
+    }
+  };
+  for (uint32 i = 0; i < insn.GetOperandSize(); ++i) {
+    Operand &opnd = insn.GetOperand(i);
+    if (opnd.IsMemoryAccessOperand()) {
+      auto &memOpnd = static_cast<MemOperand&>(opnd);
+      countReg(memOpnd.GetBaseRegister());
+      countReg(memOpnd.GetIndexRegister());
+    } else if (opnd.IsList()) {
+      for (RegOperand *regOpnd : static_cast<ListOperand&>(opnd).GetOperands()) {
+        countReg(regOpnd);
+      }
+    } else if (opnd.IsRegister() && insn.OpndIsUse(i)) {
+      countReg(static_cast<RegOperand*>(&opnd));
+    }
+  }
+}
+
+void Ebo::DeleteInsn(Insn &insn) {
+  if (beforeRegAlloc) {
+    UpdateUseCount(insn, -1);
+  }
+  insn.GetBB()->RemoveInsn(insn);
+  ++numDeleted;
+}
+
+void Ebo::ReplaceInsn(Insn &insn, Insn &newInsn) {
+  if (beforeRegAlloc) {
+    UpdateUseCount(insn, -1);
+    UpdateUseCount(newInsn, 1);
+  }
+  insn.GetBB()->ReplaceInsn(insn, newInsn);
+  ++numReplaced;
+}
+
+/* a block continues the extended basic block of its only predecessor */
+bool Ebo::IsEBBSucc(const BB &bb) const {
+  if (bb.GetPreds().size() != 1 || !bb.GetEhPreds().empty() || bb.IsCatch() || bb.IsCleanup()) {
+    return false;
+  }
+  return bb.GetPreds().front() != &bb;
+}
+
+void Ebo::OptimizeBB(BB &bb, EboState &state) {
+  FOR_BB_INSNS_SAFE(insn, &bb, nextInsn) {
+    if (insn->IsMachineInstruction()) {
+      OptimizeInsn(*insn, state);
+    }
+  }
+}
+
+/* walk the block tree rooted at root, each branch starts from what is known at the end of its parent */
+void Ebo::OptimizeEBB(BB &root) {
+  std::vector<std::pair<BB*, EboState>> workList;
+  workList.emplace_back(&root, EboState());
+  while (!workList.empty()) {
+    BB *bb = workList.back().first;
+    EboState state = std::move(workList.back().second);
+    workList.pop_back();
+    visited[bb->GetId()] = true;
+    OptimizeBB(*bb, state);
+
+    std::vector<BB*> children;
+    for (BB *succ : bb->GetSuccs()) {
+      if (!visited[succ->GetId()] && IsEBBSucc(*succ) &&
+          std::find(children.begin(), children.end(), succ) == children.end()) {
+        children.push_back(succ);
+      }
+    }
+    for (size_t i = 0; i < children.size(); ++i) {
+      if (i + 1 == children.size()) {
+        workList.emplace_back(children[i], std::move(state));
+      } else {
+        workList.emplace_back(children[i], state);
+      }
+    }
+  }
+}
+
+void Ebo::CountVRegUses() {
+  vRegUseCount.assign(cgFunc->GetMaxVReg(), 0);
+  FOR_ALL_BB(bb, cgFunc) {
+    FOR_BB_INSNS(insn, bb) {
+      if (insn->IsMachineInstruction()) {
+        UpdateUseCount(*insn, 1);
+      }
+    }
+  }
+}
+
+/* materializations made redundant above may leave their virtual register without any use */
+void Ebo::RemoveDeadDefs() {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    FOR_ALL_BB(bb, cgFunc) {
+      FOR_BB_INSNS_REV_SAFE(insn, bb, prevInsn) {
+        if (!insn->IsMachineInstruction() || insn->GetDoNotRemove() || !IsSideEffectFree(*insn)) {
+          continue;
+        }
+        auto &dest = static_cast<RegOperand&>(insn->GetOperand(0));
+        regno_t destNO = dest.GetRegisterNumber();
+        if (dest.IsVirtualRegister() && destNO < vRegUseCount.size() && vRegUseCount[destNO] == 0) {
+          DeleteInsn(*insn);
+          changed = true;
+        }
+      }
+    }
+  }
+}
+
+void Ebo::Run() {
+  trackStackSlots = CanTrackStackSlots();
+  uint32 maxBBId = 0;
+  FOR_ALL_BB(bb, cgFunc) {
+    maxBBId = std::max(maxBBId, bb->GetId());
+  }
+  visited.assign(maxBBId + 1, false);
+  if (beforeRegAlloc) {
+    CountVRegUses();
+  }
+  FOR_ALL_BB(bb, cgFunc) {
+    if (!visited[bb->GetId()] && !IsEBBSucc(*bb)) {
+      OptimizeEBB(*bb);
+    }
+  }
+  /* blocks only reachable through a cycle of single-predecessor blocks */
+  FOR_ALL_BB(bb, cgFunc) {
+    if (!visited[bb->GetId()]) {
+      OptimizeEBB(*bb);
+    }
+  }
+  if (beforeRegAlloc) {
+    RemoveDeadDefs();
+  }
+  if (CG_DEBUG_FUNC(cgFunc)) {
+    LogInfo::MapleLogger() << PhaseName() << " " << cgFunc->GetName() << ": " << numDeleted << " insns deleted, "
+                           << numReplaced << " insns replaced\n";
+  }
+}
+
+AnalysisResult *CgDoEbo::Run(CGFunc *cgFunc, CgFuncResultMgr *cgFuncResultMgr) {
+  ASSERT(cgFunc != nullptr, "expect a cgfunc in CgDoEbo");
+  ASSERT(cgFuncResultMgr != nullptr, "expect a cgFuncResultMgr in CgDoEbo");
+  MemPool *eboMp = NewMemPool();
+  Ebo *ebo = nullptr;
+#if TARGAARCH64
+  ebo = eboMp->New<AArch64Ebo>(*cgFunc, *eboMp, false);
+#endif
+  CHECK_FATAL(ebo != nullptr, "ebo is not supported on this target");
+  ebo->Run();
+  cgFuncResultMgr->InvalidAnalysisResult(kCGFuncPhaseLIVE, cgFunc);
+  return nullptr;
+}
+
+AnalysisResult *CgDoPostEbo::Run(CGFunc *cgFunc, CgFuncResultMgr *cgFuncResultMgr) {
+  ASSERT(cgFunc != nullptr, "expect a cgfunc in CgDoPostEbo");
+  ASSERT(cgFuncResultMgr != nullptr, "expect a cgFuncResultMgr in CgDoPostEbo");
+  MemPool *eboMp = NewMemPool();
+  Ebo *ebo = nullptr;
+#if TARGAARCH64
+  ebo = eboMp->New<AArch64Ebo>(*cgFunc, *eboMp, true);
+#endif
+  CHECK_FATAL(ebo != nullptr, "postebo is not supported on this target");
+  ebo->Run();
+  cgFuncResultMgr->InvalidAnalysisResult(kCGFuncPhaseLIVE, cgFunc);
+  return nullptr;
+}
+}  /* namespace maplebe */
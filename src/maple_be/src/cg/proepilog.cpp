@@ -42,7 +42,7 @@ AnalysisResult *CgDoGenProEpiLog::Run(CGFunc *cgFunc, CgFuncResultMgr *cgFuncRes
   MemPool *memPool = NewMemPool();
   GenProEpilog *genPE = nullptr;
 #if TARGAARCH64
-  genPE = memPool->New<AArch64GenProEpilog>(*cgFunc);
+  genPE = memPool->New<AArch64GenProEpilog>(*cgFunc, *memPool);
 #endif
 #if TARGARM32
   genPE = memPool->New<Arm32GenProEpilog>(*cgFunc);
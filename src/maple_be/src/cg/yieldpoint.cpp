@@ -20,12 +20,18 @@
 #include "arm32_yieldpoint.h"
 #endif
 #include "cgfunc.h"
+#include "cg.h"
+#include "loop.h"
 
 namespace maplebe {
 using namespace maple;
 AnalysisResult *CgYieldPointInsertion::Run(CGFunc *cgFunc, CgFuncResultMgr *cgFuncResultMgr) {
-  (void)cgFuncResultMgr;
   ASSERT(cgFunc != nullptr, "expect a cgfunc in CgYieldPointInsertion");
+  ASSERT(cgFuncResultMgr != nullptr, "expect a cgFuncResultMgr in CgYieldPointInsertion");
+  if (Globals::GetInstance()->GetOptimLevel() > 0) {
+    /* yieldpoints are placed by the loop nest, rebuild it after regalloc and proepilog. */
+    (void)cgFuncResultMgr->GetAnalysisResult(kCGFuncPhaseLOOP, cgFunc);
+  }
   MemPool *memPool = NewMemPool();
   YieldPointInsertion *yieldPoint = nullptr;
 #if TARGAARCH64
@@ -35,6 +41,7 @@ AnalysisResult *CgYieldPointInsertion::Run(CGFunc *cgFunc, CgFuncResultMgr *cgFu
   yieldPoint = memPool->New<Arm32YieldPointInsertion>(*cgFunc);
 #endif
   yieldPoint->Run();
+  cgFuncResultMgr->InvalidAnalysisResult(kCGFuncPhaseLOOP, cgFunc);
   return nullptr;
 }
 }  /* namespace maplebe */
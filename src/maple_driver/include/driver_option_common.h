@@ -33,6 +33,7 @@ enum DriverOptionIndex {
   kRun,
   kOption,
   kTimePhases,
+  kTraceJson,
   kGenMeMpl,
   kGenVtableImpl,
   kVerbose,
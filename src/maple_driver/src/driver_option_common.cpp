@@ -168,6 +168,16 @@ const mapleOption::Descriptor usages[] = {
     "  -time-phases                \tTiming phases and print percentages\n",
     "all",
     {} },
+  { kTraceJson,
+    0,
+    nullptr,
+    "trace-json",
+    kBuildTypeExperimental,
+    kArgCheckPolicyRequired,
+    "  --trace-json=file           \tRecord the compile time and memory of each phase and\n"
+    "                              \tfunction to file in Chrome trace-event format\n",
+    "all",
+    {} },
   { kGenMeMpl,
     0,
     nullptr,
@@ -17,6 +17,7 @@
 #include <typeinfo>
 #include <sys/stat.h>
 #include "mpl_timer.h"
+#include "trace_event.h"
 #include "mir_function.h"
 #include "mir_parser.h"
 
@@ -59,7 +60,9 @@ using namespace maplebe;
     auto duration = std::chrono::system_clock::now() - (timeStart);                                       \
     extraPhasesTime.push_back(std::chrono::duration_cast<std::chrono::microseconds>(duration).count()); \
     extraPhasesName.push_back(name);                                                                    \
-  }
+  }                                                                                                     \
+  TraceEventRecorder::GetInstance().AddCompleteEvent(kMplCg, name, theModule->GetFileName(), (timeStart), \
+                                                     std::chrono::system_clock::now())
 
 namespace maple {
 const std::string kMplCg = "mplcg";
@@ -132,7 +135,9 @@ ErrorCode DriverRunner::ParseInput(const std::string &outputFile, const std::str
 
   MIRParser parser(*theModule);
   ErrorCode ret = kErrorNoError;
-  bool parsed = parser.ParseMIR(0, 0, false, true);
+  uint32 parseOptions = (Options::parallelLex ? kParseInParallel : 0) |
+                        (Options::mpltSnapshot ? kParseMpltSnapshot : 0);
+  bool parsed = parser.ParseMIR(0, parseOptions, false, true);
   if (!parsed) {
     ret = kErrorExit;
     parser.EmitError(outputFile);
@@ -28,6 +28,7 @@
 #include "me_option.h"
 #include "option.h"
 #include "cg_option.h"
+#include "trace_event.h"
 
 namespace maple {
 using namespace mapleOption;
@@ -130,6 +131,10 @@ ErrorCode MplOptions::HandleGeneralOptions() {
         timePhases = true;
         printCommandStr += " -time-phases";
         break;
+      case kTraceJson:
+        TraceEventRecorder::GetInstance().Enable(opt.Args());
+        printCommandStr += " --trace-json=" + opt.Args();
+        break;
       case kGenMeMpl:
         genMeMpl = true;
         printCommandStr += " --genmempl";
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_IPA_INCLUDE_MOD_REF_H
+#define MAPLE_IPA_INCLUDE_MOD_REF_H
+#include <set>
+#include "module_phase.h"
+#include "mir_nodes.h"
+#include "callgraph.h"
+
+namespace maple {
+// What a function, together with everything it calls, may read and write.
+// Globals are told apart by symbol, memory reached through pointers by the type of the field or
+// element written and, for the objects the formals point to on entry, by formal.
+class FuncModRef {
+ public:
+  static constexpr size_t kMaxTrackedFormals = 64;  // writes through later formals count as unrelated
+
+  explicit FuncModRef(MapleAllocator &alloc)
+      : globalRef(alloc.Adapter()), globalMod(alloc.Adapter()), heapModTypes(alloc.Adapter()) {}
+
+  ~FuncModRef() = default;
+
+  bool IsUnknown() const {
+    return unknown;
+  }
+
+  bool MayRefGlobal(const StIdx &stIdx) const {
+    return unknown || globalRef.find(stIdx) != globalRef.end() || globalMod.find(stIdx) != globalMod.end();
+  }
+
+  bool MayModGlobal(const StIdx &stIdx) const {
+    return unknown || globalMod.find(stIdx) != globalMod.end();
+  }
+
+  bool MayRefHeap() const {
+    return unknown || heapRef;
+  }
+
+  bool MayModHeap() const {
+    return unknown || heapModUnrelated || formalMod != 0;
+  }
+
+  // the fields and elements of the object formal i points to on entry may be written
+  bool MayModThroughFormal(size_t i) const {
+    if (unknown || heapModUnrelated) {
+      return true;
+    }
+    return i >= kMaxTrackedFormals || (formalMod & (1ULL << i)) != 0;
+  }
+
+  // memory not reached directly through a formal may be written
+  bool MayModUnrelatedHeap() const {
+    return unknown || heapModUnrelated;
+  }
+
+  // a field or element of type tyIdx may be written through some pointer
+  bool MayModHeapType(TyIdx tyIdx) const {
+    return unknown || heapModAnyType || heapModTypes.find(tyIdx) != heapModTypes.end();
+  }
+
+  void Dump() const;
+
+ private:
+  friend class ModRefAnalysis;
+
+  // the number of facts collected, summaries only grow while computed
+  size_t GetFactCount() const {
+    return static_cast<size_t>(unknown) + heapRef + heapModUnrelated + heapModAnyType +
+           static_cast<size_t>(__builtin_popcountll(formalMod)) + globalRef.size() + globalMod.size() +
+           heapModTypes.size();
+  }
+
+  bool unknown = false;            // may read and write anything, e.g. calls code not seen
+  bool heapRef = false;            // reads memory through pointers
+  bool heapModUnrelated = false;   // writes through pointers not known to come from a formal
+  bool heapModAnyType = false;     // writes a whole aggregate, heapModTypes does not tell what
+  uint64 formalMod = 0;            // bit i: writes the object formal i points to on entry
+  MapleSet<StIdx> globalRef;
+  MapleSet<StIdx> globalMod;
+  MapleSet<TyIdx> heapModTypes;
+};
+
+// Computes FuncModRef of the functions of the module, callees first, iterating to a fixed point
+// within each SCC of the call graph. Only direct calls are followed: virtual, interface and
+// indirect calls, calls to functions without body, intrinsics with side effects, class-init checks,
+// volatile accesses, monitors and statements not modeled make a function unknown. Untyped stores
+// such as iassignoff write memory of any type not related to a formal.
+class ModRefAnalysis : public AnalysisResult {
+ public:
+  ModRefAnalysis(MemPool &memPool, const CallGraph &callGraph)
+      : AnalysisResult(&memPool),
+        callGraph(callGraph),
+        modRefAlloc(&memPool),
+        summaries(modRefAlloc.Adapter()) {}
+
+  virtual ~ModRefAnalysis() = default;
+
+  void Run();
+  // nullptr for functions not summarized, whose effects are unknown
+  const FuncModRef *GetSummary(PUIdx puIdx) const {
+    auto it = summaries.find(puIdx);
+    return it == summaries.end() ? nullptr : it->second;
+  }
+
+  void Dump() const;
+
+ private:
+  // how a pointer used as address relates to the function
+  enum BaseKind {
+    kBaseFormal,      // a formal not redefined in the function
+    kBaseFresh,       // a local only ever assigned newly allocated objects
+    kBaseSymbolAddr,  // the address of a variable, writes to globals are kept by symbol
+    kBaseUnrelated
+  };
+
+  struct FuncInfo {
+    MIRFunction *func;
+    std::set<StIdx> redefinedLocals;
+    std::set<StIdx> allocatedLocals;
+  };
+
+  void CollectLocalDefs(const BlockNode &block, FuncInfo &info) const;
+  BaseKind GetBaseKind(const FuncInfo &info, const BaseNode &addr, size_t &formalIndex) const;
+  void AddHeapMod(const FuncInfo &info, FuncModRef &summary, const BaseNode &addr, TyIdx ptrTyIdx,
+                  FieldID fieldID) const;
+  void AddGlobalRef(const FuncInfo &info, FuncModRef &summary, const StIdx &stIdx, bool isMod) const;
+  void VisitExpr(const FuncInfo &info, FuncModRef &summary, const BaseNode &expr) const;
+  void VisitCall(const FuncInfo &info, FuncModRef &summary, const CallNode &call) const;
+  void VisitBlock(const FuncInfo &info, FuncModRef &summary, const BlockNode &block) const;
+  void MergeCallee(const FuncInfo &info, FuncModRef &summary, const CallNode &call, const FuncModRef &callee) const;
+
+  const CallGraph &callGraph;
+  MapleAllocator modRefAlloc;
+  MapleMap<PUIdx, FuncModRef*> summaries;  // those of the SCC being computed are still partial
+};
+
+class DoModRefAnalysis : public ModulePhase {
+ public:
+  explicit DoModRefAnalysis(ModulePhaseID id) : ModulePhase(id) {}
+
+  virtual ~DoModRefAnalysis() = default;
+
+  AnalysisResult *Run(MIRModule *module, ModuleResultMgr *mrm) override;
+  std::string PhaseName() const override {
+    return "modref";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_IPA_INCLUDE_MOD_REF_H
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_IPA_INCLUDE_NONNULL_INFERENCE_H
+#define MAPLE_IPA_INCLUDE_NONNULL_INFERENCE_H
+#include <map>
+#include <set>
+#include <vector>
+#include "module_phase.h"
+#include "mir_nodes.h"
+#include "callgraph.h"
+
+namespace maple {
+// Infers which pointer values crossing calls can never be null:
+// - the return value of a function all of whose returns give a new allocation, the address of a
+//   symbol, a string constant or the non-null return value of another function;
+// - formal i of a function only callable from the calls seen in the module, when all those calls
+//   pass a value of that kind or a non-null formal of the caller.
+// Locals count as non-null when every assignment to them is, and their address is not taken.
+class NonNullInference : public AnalysisResult {
+ public:
+  static constexpr size_t kMaxTrackedFormals = 64;
+
+  NonNullInference(MemPool &memPool, MIRModule &module, const CallGraph &callGraph)
+      : AnalysisResult(&memPool),
+        module(module),
+        callGraph(callGraph),
+        nonNullAlloc(&memPool),
+        nonNullFormals(nonNullAlloc.Adapter()),
+        nonNullReturns(nonNullAlloc.Adapter()) {}
+
+  virtual ~NonNullInference() = default;
+
+  void Run();
+  bool IsFormalNonNull(PUIdx puIdx, size_t i) const {
+    auto it = nonNullFormals.find(puIdx);
+    return i < kMaxTrackedFormals && it != nonNullFormals.end() && (it->second & (1ULL << i)) != 0;
+  }
+
+  bool IsReturnNonNull(PUIdx puIdx) const {
+    return nonNullReturns.find(puIdx) != nonNullReturns.end();
+  }
+
+  void Dump() const;
+
+ private:
+  // one assignment to a local: either an expression or the return value of a direct call
+  struct LocalDef {
+    const BaseNode *rhs;
+    PUIdx callee;
+    bool unknown;
+  };
+
+  struct FuncInfo {
+    MIRFunction *func;
+    std::map<StIdx, std::vector<LocalDef>> localDefs;
+    std::set<StIdx> addrTakenLocals;
+    std::vector<const BaseNode*> returnValues;
+    std::vector<std::pair<PUIdx, const CallNode*>> callSites;  // the calls of the callers reaching func
+  };
+
+  static bool IsPointerType(PrimType primType) {
+    return primType == PTY_ref || primType == PTY_ptr || primType == PTY_a32 || primType == PTY_a64;
+  }
+
+  void CollectExprInfo(FuncInfo &info, const BaseNode &expr);
+  void CollectFuncInfo(FuncInfo &info, const BlockNode &block);
+  void CollectAddrTakenFuncs(const MIRConst &mirConst);
+  void CollectCallSites();
+  bool IsNonNullExpr(const BaseNode &expr, const std::set<StIdx> &nonNullLocals) const;
+  bool IsNonNullDef(const LocalDef &def, const std::set<StIdx> &nonNullLocals) const;
+  bool IsThisFormal(const FuncInfo &info, const StIdx &stIdx) const;
+  std::set<StIdx> ComputeNonNullLocals(const FuncInfo &info, uint64 formalMask) const;
+  bool IsInternal(const MIRFunction &func) const;
+  uint64 GetPointerFormalMask(const MIRFunction &func) const;
+  void InferReturns(const SCCNode &scc);
+  void InferFormals(const SCCNode &scc);
+
+  MIRModule &module;
+  const CallGraph &callGraph;
+  MapleAllocator nonNullAlloc;
+  MapleMap<PUIdx, uint64> nonNullFormals;  // bit i: formal i is not null on entry
+  MapleSet<PUIdx> nonNullReturns;
+  std::map<PUIdx, FuncInfo> funcInfos;
+  std::set<PUIdx> addrTakenFuncs;   // may be called through a pointer
+  std::set<PUIdx> indirectCallees;  // reached by a virtual, interface or indirect call
+};
+
+class DoNonNullInference : public ModulePhase {
+ public:
+  explicit DoNonNullInference(ModulePhaseID id) : ModulePhase(id) {}
+
+  virtual ~DoNonNullInference() = default;
+
+  AnalysisResult *Run(MIRModule *module, ModuleResultMgr *mrm) override;
+  std::string PhaseName() const override {
+    return "nonnull";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_IPA_INCLUDE_NONNULL_INFERENCE_H
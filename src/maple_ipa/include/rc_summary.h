@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_IPA_INCLUDE_RC_SUMMARY_H
+#define MAPLE_IPA_INCLUDE_RC_SUMMARY_H
+#include <map>
+#include <vector>
+#include "module_phase.h"
+#include "mir_nodes.h"
+#include "callgraph.h"
+
+namespace maple {
+// Summarizes what each function does with the references it receives through its ref formals:
+// - retained: the reference may outlive the call, being stored into the heap or a global,
+//   copied to a local, returned, thrown or passed to a callee that retains it;
+// - dereferenced: the object itself may be accessed, by loads, stores, locking or a callee doing so.
+// A formal that is neither is only compared or tested for null, so the caller may pass a reference
+// it holds no count for, the same way it may compare such a reference itself.
+// Only such inert formals are published. A callee that dereferences a formal without retaining it
+// still needs the caller to hold a count across the call, just as a dereference in the caller does
+// (see DelegateRC::CollectDerefedOrCopied), so delegaterc would gain nothing from knowing it. Whether
+// a function returns a fresh object or stores a formal into the heap is not summarized either.
+class RCSummary : public AnalysisResult {
+ public:
+  static constexpr size_t kMaxTrackedFormals = 64;
+
+  RCSummary(MemPool &memPool, const CallGraph &callGraph)
+      : AnalysisResult(&memPool),
+        callGraph(callGraph),
+        rcSummaryAlloc(&memPool),
+        inertFormals(rcSummaryAlloc.Adapter()) {}
+
+  virtual ~RCSummary() = default;
+
+  void Run();
+  // formal i of puIdx is neither retained nor dereferenced by the call
+  bool IsFormalInert(PUIdx puIdx, size_t i) const {
+    return HasBit(inertFormals, puIdx, i);
+  }
+
+  void Dump() const;
+
+ private:
+  enum FormalUse : uint8 {
+    kUseNone = 0,
+    kUseDeref = 1,
+    kUseRetain = 2,
+    kUseAny = kUseDeref | kUseRetain
+  };
+
+  // a formal of the function passed unchanged as argument argIdx of a direct call
+  struct PassedFormal {
+    PUIdx callee;
+    size_t argIdx;
+    size_t formalIdx;
+  };
+
+  struct FuncInfo {
+    MIRFunction *func = nullptr;
+    std::map<StIdx, size_t> refFormals;
+    uint64 derefed = 0;
+    uint64 retained = 0;
+    std::vector<PassedFormal> passedFormals;
+  };
+
+  static bool HasBit(const MapleMap<PUIdx, uint64> &masks, PUIdx puIdx, size_t i) {
+    auto it = masks.find(puIdx);
+    return i < kMaxTrackedFormals && it != masks.end() && (it->second & (1ULL << i)) != 0;
+  }
+
+  void MarkFormal(FuncInfo &info, const StIdx &stIdx, uint8 use) const;
+  void CollectExprUses(FuncInfo &info, const BaseNode &expr, uint8 use) const;
+  void CollectCallUses(FuncInfo &info, const CallNode &call) const;
+  void CollectStmtUses(FuncInfo &info, const BlockNode &block) const;
+  uint8 GetCalleeUse(const PassedFormal &passed) const;
+  void Summarize(const SCCNode &scc);
+
+  const CallGraph &callGraph;
+  MapleAllocator rcSummaryAlloc;
+  MapleMap<PUIdx, uint64> inertFormals;  // bit i: formal i is neither retained nor dereferenced
+  std::map<PUIdx, FuncInfo> funcInfos;
+};
+
+class DoRCSummary : public ModulePhase {
+ public:
+  explicit DoRCSummary(ModulePhaseID id) : ModulePhase(id) {}
+
+  virtual ~DoRCSummary() = default;
+
+  AnalysisResult *Run(MIRModule *module, ModuleResultMgr *mrm) override;
+  std::string PhaseName() const override {
+    return "rcsummary";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_IPA_INCLUDE_RC_SUMMARY_H
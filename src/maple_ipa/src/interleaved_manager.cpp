@@ -21,6 +21,7 @@
 #include "me_option.h"
 #include "mempool.h"
 #include "phase_manager.h"
+#include "trace_event.h"
 
 namespace maple {
 void InterleavedManager::AddPhases(const std::vector<std::string> &phases, bool isModulePhase, bool timePhases,
@@ -60,6 +61,7 @@ void InterleavedManager::Run() {
     if (pm == nullptr) {
       continue;
     }
+    TraceScope traceScope("interleaved", pm->GetMgrName(), mirModule.GetFileName());
     auto *fpm = dynamic_cast<MeFuncPhaseManager*>(pm);
     if (fpm == nullptr) {
       pm->Run();
@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "mod_ref.h"
+#include "intrinsics.h"
+#include "option.h"
+
+// Mod/ref summaries are computed on the MIR of the module before the function level optimizations,
+// which only remove effects, so they stay valid for the callers optimized later. A pointer used as
+// address is related to the function by its base: a formal that is never redefined lets the write
+// be charged to that formal, a local only ever holding objects allocated here cannot be seen by the
+// callers at all, anything else is unrelated and may be any object.
+namespace {
+using namespace maple;
+
+bool IsAllocation(Opcode op) {
+  return op == OP_gcmalloc || op == OP_gcmallocjarray || op == OP_gcpermalloc || op == OP_gcpermallocjarray;
+}
+
+bool IsDirectCall(Opcode op) {
+  return op == OP_call || op == OP_callassigned || op == OP_superclasscall || op == OP_superclasscallassigned;
+}
+
+bool IsIntrinsicCall(Opcode op) {
+  return op == OP_intrinsiccall || op == OP_intrinsiccallassigned || op == OP_xintrinsiccall ||
+         op == OP_xintrinsiccallassigned || op == OP_intrinsiccallwithtype || op == OP_intrinsiccallwithtypeassigned;
+}
+
+// a class-init check may run a <clinit>, which can write the statics of any class
+bool IsClassInitCheck(MIRIntrinsicID intrinsic) {
+  return intrinsic == INTRN_JAVA_CLINIT_CHECK || intrinsic == INTRN_MPL_CLINIT_CHECK;
+}
+
+// statements VisitBlock has nothing to charge for, besides the ones it handles; any other statement
+// may store somewhere the summary cannot tell
+bool IsKnownNotToStore(Opcode op) {
+  switch (op) {
+    case OP_block:
+    case OP_if:
+    case OP_while:
+    case OP_dowhile:
+    case OP_doloop:
+    case OP_dassign:
+    case OP_iassign:
+    case OP_regassign:
+    case OP_eval:
+    case OP_comment:
+    case OP_label:
+    case OP_goto:
+    case OP_brfalse:
+    case OP_brtrue:
+    case OP_switch:
+    case OP_rangegoto:
+    case OP_multiway:
+    case OP_return:
+    case OP_assertge:
+    case OP_assertlt:
+    case OP_assertnonnull:
+    case OP_jstry:
+    case OP_try:
+    case OP_throw:
+    case OP_jscatch:
+    case OP_catch:
+    case OP_finally:
+    case OP_cleanuptry:
+    case OP_endtry:
+    case OP_gosub:
+    case OP_retsub:
+    case OP_syncenter:
+    case OP_syncexit:
+    case OP_incref:
+    case OP_decref:
+    case OP_decrefreset:
+    case OP_membaracquire:
+    case OP_membarrelease:
+    case OP_membarstoreload:
+    case OP_membarstorestore:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsPointedTypeVolatile(TyIdx ptrTyIdx, FieldID fieldID) {
+  MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ptrTyIdx);
+  return type->IsMIRPtrType() && static_cast<MIRPtrType*>(type)->IsPointedTypeVolatile(fieldID);
+}
+}  // namespace
+
+namespace maple {
+void FuncModRef::Dump() const {
+  if (unknown) {
+    LogInfo::MapleLogger() << "  unknown\n";
+    return;
+  }
+  LogInfo::MapleLogger() << "  heapRef " << heapRef << " heapModUnrelated " << heapModUnrelated << " formalMod 0x"
+                         << std::hex << formalMod << std::dec << '\n';
+  LogInfo::MapleLogger() << "  globalRef:";
+  for (const StIdx &stIdx : globalRef) {
+    LogInfo::MapleLogger() << " " << GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx())->GetName();
+  }
+  LogInfo::MapleLogger() << "\n  globalMod:";
+  for (const StIdx &stIdx : globalMod) {
+    LogInfo::MapleLogger() << " " << GlobalTables::GetGsymTable().GetSymbolFromStidx(stIdx.Idx())->GetName();
+  }
+  LogInfo::MapleLogger() << "\n  heapModTypes:";
+  if (heapModAnyType) {
+    LogInfo::MapleLogger() << " any";
+  } else {
+    for (TyIdx tyIdx : heapModTypes) {
+      LogInfo::MapleLogger() << " " << tyIdx;
+    }
+  }
+  LogInfo::MapleLogger() << '\n';
+}
+
+// local symbols assigned anything but a new allocation, or whose address is taken, are redefined;
+// formals are redefined by any assignment
+void ModRefAnalysis::CollectLocalDefs(const BlockNode &block, FuncInfo &info) const {
+  std::vector<const BaseNode*> worklist;
+  for (const StmtNode *stmt = block.GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    switch (stmt->GetOpCode()) {
+      case OP_block:
+        CollectLocalDefs(static_cast<const BlockNode&>(*stmt), info);
+        break;
+      case OP_if: {
+        auto *ifStmt = static_cast<const IfStmtNode*>(stmt);
+        CollectLocalDefs(*ifStmt->GetThenPart(), info);
+        if (ifStmt->GetElsePart() != nullptr) {
+          CollectLocalDefs(*ifStmt->GetElsePart(), info);
+        }
+        break;
+      }
+      case OP_while:
+      case OP_dowhile:
+        CollectLocalDefs(*static_cast<const WhileStmtNode*>(stmt)->GetBody(), info);
+        break;
+      case OP_doloop: {
+        auto *doloop = static_cast<const DoloopNode*>(stmt);
+        if (!doloop->IsPreg() && doloop->GetDoVarStIdx().Islocal()) {
+          (void)info.redefinedLocals.insert(doloop->GetDoVarStIdx());
+        }
+        CollectLocalDefs(*doloop->GetDoBody(), info);
+        break;
+      }
+      case OP_dassign: {
+        auto *dassign = static_cast<const DassignNode*>(stmt);
+        if (!dassign->GetStIdx().Islocal()) {
+          break;
+        }
+        if (dassign->GetFieldID() == 0 && IsAllocation(dassign->GetRHS()->GetOpCode())) {
+          (void)info.allocatedLocals.insert(dassign->GetStIdx());
+        } else {
+          (void)info.redefinedLocals.insert(dassign->GetStIdx());
+        }
+        break;
+      }
+      default: {
+        CallReturnVector *returnValues = const_cast<StmtNode*>(stmt)->GetCallReturnVector();
+        if (returnValues == nullptr) {
+          break;
+        }
+        for (const CallReturnPair &returnValue : *returnValues) {
+          if (!returnValue.second.IsReg() && returnValue.first.Islocal()) {
+            (void)info.redefinedLocals.insert(returnValue.first);
+          }
+        }
+        break;
+      }
+    }
+    for (size_t i = 0; i < stmt->NumOpnds(); ++i) {
+      worklist.push_back(stmt->Opnd(i));
+    }
+  }
+  while (!worklist.empty()) {
+    const BaseNode *expr = worklist.back();
+    worklist.pop_back();
+    if (expr->GetOpCode() == OP_addrof && static_cast<const AddrofNode*>(expr)->GetStIdx().Islocal()) {
+      (void)info.redefinedLocals.insert(static_cast<const AddrofNode*>(expr)->GetStIdx());
+    }
+    for (size_t i = 0; i < expr->NumOpnds(); ++i) {
+      worklist.push_back(expr->Opnd(i));
+    }
+  }
+}
+
+ModRefAnalysis::BaseKind ModRefAnalysis::GetBaseKind(const FuncInfo &info, const BaseNode &addr,
+                                                     size_t &formalIndex) const {
+  const BaseNode *base = &addr;
+  while (base->GetOpCode() == OP_array || base->GetOpCode() == OP_iaddrof || base->GetOpCode() == OP_retype) {
+    base = base->Opnd(0);
+  }
+  if (base->GetOpCode() == OP_add || base->GetOpCode() == OP_sub) {
+    // either side may be the pointer, a constant offset is no base; two bases must agree
+    const BaseNode *lhs = base->Opnd(0);
+    const BaseNode *rhs = base->Opnd(1);
+    if (rhs->GetOpCode() == OP_constval) {
+      return GetBaseKind(info, *lhs, formalIndex);
+    }
+    if (lhs->GetOpCode() == OP_constval) {
+      return GetBaseKind(info, *rhs, formalIndex);
+    }
+    size_t lhsFormal = 0;
+    size_t rhsFormal = 0;
+    BaseKind lhsKind = GetBaseKind(info, *lhs, lhsFormal);
+    BaseKind rhsKind = GetBaseKind(info, *rhs, rhsFormal);
+    if (lhsKind != rhsKind || (lhsKind == kBaseFormal && lhsFormal != rhsFormal) || lhsKind == kBaseSymbolAddr) {
+      return kBaseUnrelated;
+    }
+    formalIndex = lhsFormal;
+    return lhsKind;
+  }
+  if (base->GetOpCode() == OP_addrof) {
+    return kBaseSymbolAddr;
+  }
+  if (base->GetOpCode() != OP_dread) {
+    return kBaseUnrelated;
+  }
+  auto *dread = static_cast<const AddrofNode*>(base);
+  const StIdx &stIdx = dread->GetStIdx();
+  if (dread->GetFieldID() != 0 || !stIdx.Islocal() || info.redefinedLocals.count(stIdx) != 0) {
+    return kBaseUnrelated;
+  }
+  for (size_t i = 0; i < info.func->GetFormalCount(); ++i) {
+    const MIRSymbol *formal = info.func->GetFormal(i);
+    if (formal != nullptr && formal->GetStIdx() == stIdx) {
+      if (info.allocatedLocals.count(stIdx) != 0) {
+        return kBaseUnrelated;
+      }
+      formalIndex = i;
+      return kBaseFormal;
+    }
+  }
+  return info.allocatedLocals.count(stIdx) != 0 ? kBaseFresh : kBaseUnrelated;
+}
+
+void ModRefAnalysis::AddHeapMod(const FuncInfo &info, FuncModRef &summary, const BaseNode &addr, TyIdx ptrTyIdx,
+                                FieldID fieldID) const {
+  size_t formalIndex = 0;
+  switch (GetBaseKind(info, addr, formalIndex)) {
+    case kBaseFresh:
+    case kBaseSymbolAddr:
+      // invisible to the callers, or a global VisitExpr already charged by its addrof
+      return;
+    case kBaseFormal:
+      if (formalIndex < FuncModRef::kMaxTrackedFormals) {
+        summary.formalMod |= (1ULL << formalIndex);
+      } else {
+        summary.heapModUnrelated = true;
+      }
+      break;
+    default:
+      summary.heapModUnrelated = true;
+      break;
+  }
+  MIRType *ptrType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ptrTyIdx);
+  if (!ptrType->IsMIRPtrType()) {
+    summary.heapModAnyType = true;
+    return;
+  }
+  TyIdx fieldTyIdx = static_cast<MIRPtrType*>(ptrType)->GetPointedTyIdxWithFieldID(fieldID);
+  MIRType *fieldType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(fieldTyIdx);
+  if (fieldType->GetPrimType() == PTY_agg || fieldType->GetPrimType() == PTY_void) {
+    summary.heapModAnyType = true;
+  } else {
+    (void)summary.heapModTypes.insert(fieldTyIdx);
+  }
+}
+
+void ModRefAnalysis::AddGlobalRef(const FuncInfo &info, FuncModRef &summary, const StIdx &stIdx, bool isMod) const {
+  if (!stIdx.IsGlobal()) {
+    return;
+  }
+  const MIRSymbol *sym = info.func->GetLocalOrGlobalSymbol(stIdx);
+  if (sym == nullptr || sym->IsVolatile()) {
+    summary.unknown = true;
+    return;
+  }
+  if (isMod) {
+    (void)summary.globalMod.insert(stIdx);
+  } else {
+    (void)summary.globalRef.insert(stIdx);
+  }
+}
+
+void ModRefAnalysis::VisitExpr(const FuncInfo &info, FuncModRef &summary, const BaseNode &expr) const {
+  switch (expr.GetOpCode()) {
+    case OP_dread:
+      AddGlobalRef(info, summary, static_cast<const AddrofNode&>(expr).GetStIdx(), false);
+      break;
+    case OP_addrof: {
+      // the address may be written through anywhere
+      const StIdx &stIdx = static_cast<const AddrofNode&>(expr).GetStIdx();
+      AddGlobalRef(info, summary, stIdx, false);
+      AddGlobalRef(info, summary, stIdx, true);
+      break;
+    }
+    case OP_iread: {
+      auto &iread = static_cast<const IreadNode&>(expr);
+      summary.heapRef = true;
+      if (IsPointedTypeVolatile(iread.GetTyIdx(), iread.GetFieldID())) {
+        summary.unknown = true;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    VisitExpr(info, summary, *expr.Opnd(i));
+  }
+}
+
+void ModRefAnalysis::MergeCallee(const FuncInfo &info, FuncModRef &summary, const CallNode &call,
+                                 const FuncModRef &callee) const {
+  if (callee.unknown) {
+    summary.unknown = true;
+    return;
+  }
+  summary.heapRef = summary.heapRef || callee.heapRef;
+  summary.heapModUnrelated = summary.heapModUnrelated || callee.heapModUnrelated;
+  summary.heapModAnyType = summary.heapModAnyType || callee.heapModAnyType;
+  summary.globalRef.insert(callee.globalRef.begin(), callee.globalRef.end());
+  summary.globalMod.insert(callee.globalMod.begin(), callee.globalMod.end());
+  summary.heapModTypes.insert(callee.heapModTypes.begin(), callee.heapModTypes.end());
+  if (callee.heapModUnrelated) {
+    return;
+  }
+  // charge the writes through the formals of the callee to what the arguments are based on
+  for (size_t i = 0; i < call.NumOpnds(); ++i) {
+    if (!callee.MayModThroughFormal(i)) {
+      continue;
+    }
+    size_t formalIndex = 0;
+    switch (GetBaseKind(info, *call.Opnd(i), formalIndex)) {
+      case kBaseFresh:
+      case kBaseSymbolAddr:
+        break;
+      case kBaseFormal:
+        if (formalIndex < FuncModRef::kMaxTrackedFormals) {
+          summary.formalMod |= (1ULL << formalIndex);
+        } else {
+          summary.heapModUnrelated = true;
+        }
+        break;
+      default:
+        summary.heapModUnrelated = true;
+        break;
+    }
+  }
+}
+
+void ModRefAnalysis::VisitCall(const FuncInfo &info, FuncModRef &summary, const CallNode &call) const {
+  const FuncModRef *callee = GetSummary(call.GetPUIdx());
+  if (callee == nullptr) {
+    // no body, or a callee the call graph missed
+    summary.unknown = true;
+    return;
+  }
+  MergeCallee(info, summary, call, *callee);
+}
+
+void ModRefAnalysis::VisitBlock(const FuncInfo &info, FuncModRef &summary, const BlockNode &block) const {
+  for (const StmtNode *stmt = block.GetFirst(); stmt != nullptr && !summary.unknown; stmt = stmt->GetNext()) {
+    Opcode op = stmt->GetOpCode();
+    for (size_t i = 0; i < stmt->NumOpnds(); ++i) {
+      VisitExpr(info, summary, *stmt->Opnd(i));
+    }
+    if (IsDirectCall(op)) {
+      VisitCall(info, summary, static_cast<const CallNode&>(*stmt));
+    } else if (IsIntrinsicCall(op)) {
+      auto *intrinsicCall = static_cast<const IntrinsiccallNode*>(stmt);
+      MIRIntrinsicID intrinsic = intrinsicCall->GetIntrinsic();
+      if (IsClassInitCheck(intrinsic) || !IntrinDesc::intrinTable[intrinsic].HasNoSideEffect()) {
+        summary.unknown = true;
+      }
+    } else if (kOpcodeInfo.IsCall(op) || op == OP_syncenter || op == OP_syncexit) {
+      summary.unknown = true;
+    }
+    switch (op) {
+      case OP_block:
+        VisitBlock(info, summary, static_cast<const BlockNode&>(*stmt));
+        break;
+      case OP_if: {
+        auto *ifStmt = static_cast<const IfStmtNode*>(stmt);
+        VisitBlock(info, summary, *ifStmt->GetThenPart());
+        if (ifStmt->GetElsePart() != nullptr) {
+          VisitBlock(info, summary, *ifStmt->GetElsePart());
+        }
+        break;
+      }
+      case OP_while:
+      case OP_dowhile:
+        VisitBlock(info, summary, *static_cast<const WhileStmtNode*>(stmt)->GetBody());
+        break;
+      case OP_doloop: {
+        auto *doloop = static_cast<const DoloopNode*>(stmt);
+        if (!doloop->IsPreg()) {
+          AddGlobalRef(info, summary, doloop->GetDoVarStIdx(), true);
+        }
+        VisitBlock(info, summary, *doloop->GetDoBody());
+        break;
+      }
+      case OP_dassign:
+        AddGlobalRef(info, summary, static_cast<const DassignNode*>(stmt)->GetStIdx(), true);
+        break;
+      case OP_iassign: {
+        auto *iassign = static_cast<const IassignNode*>(stmt);
+        if (IsPointedTypeVolatile(iassign->GetTyIdx(), iassign->GetFieldID())) {
+          summary.unknown = true;
+          break;
+        }
+        AddHeapMod(info, summary, *iassign->Opnd(0), iassign->GetTyIdx(), iassign->GetFieldID());
+        break;
+      }
+      case OP_iassignoff:
+      case OP_iassignfpoff:
+      case OP_free:
+        // untyped stores, the address is not followed to a base
+        summary.heapModUnrelated = true;
+        summary.heapModAnyType = true;
+        break;
+      default:
+        if (!kOpcodeInfo.IsCall(op) && !IsKnownNotToStore(op)) {
+          summary.unknown = true;
+        }
+        break;
+    }
+    CallReturnVector *returnValues = const_cast<StmtNode*>(stmt)->GetCallReturnVector();
+    if (returnValues != nullptr) {
+      for (const CallReturnPair &returnValue : *returnValues) {
+        if (!returnValue.second.IsReg()) {
+          AddGlobalRef(info, summary, returnValue.first, true);
+        }
+      }
+    }
+  }
+}
+
+void ModRefAnalysis::Run() {
+  const MapleVector<SCCNode*> &sccTopVec = callGraph.GetSCCTopVec();
+  // the SCCs are in topological order, callers first
+  for (auto sccIt = sccTopVec.rbegin(); sccIt != sccTopVec.rend(); ++sccIt) {
+    std::vector<FuncInfo> infos;
+    for (CGNode *node : (*sccIt)->GetCGNodes()) {
+      MIRFunction *func = node->GetMIRFunction();
+      // natives get no summary, which callers take as unknown
+      if (func == nullptr || func->GetBody() == nullptr || func->IsAnyNative()) {
+        continue;
+      }
+      infos.push_back(FuncInfo{ func, {}, {} });
+      CollectLocalDefs(*func->GetBody(), infos.back());
+      summaries[func->GetPuidx()] = modRefAlloc.GetMemPool()->New<FuncModRef>(modRefAlloc);
+    }
+    // recursive calls see the partial summaries of the SCC, recompute until they stop growing
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (const FuncInfo &info : infos) {
+        FuncModRef &summary = *summaries[info.func->GetPuidx()];
+        size_t factCount = summary.GetFactCount();
+        VisitBlock(info, summary, *info.func->GetBody());
+        changed = changed || summary.GetFactCount() != factCount;
+      }
+    }
+  }
+}
+
+void ModRefAnalysis::Dump() const {
+  for (const auto &pair : summaries) {
+    LogInfo::MapleLogger() << "mod/ref of " <<
+        GlobalTables::GetFunctionTable().GetFunctionFromPuidx(pair.first)->GetName() << '\n';
+    pair.second->Dump();
+  }
+}
+
+AnalysisResult *DoModRefAnalysis::Run(MIRModule *module, ModuleResultMgr *mrm) {
+  auto *callGraph = static_cast<CallGraph*>(mrm->GetAnalysisResult(MoPhase_CALLGRAPH_ANALYSIS, module));
+  CHECK_FATAL(callGraph != nullptr, "call graph can't be null");
+  MemPool *memPool = memPoolCtrler.NewMemPool(PhaseName());
+  ModRefAnalysis *modRef = memPool->New<ModRefAnalysis>(*memPool, *callGraph);
+  modRef->Run();
+  if (TRACE_PHASE) {
+    modRef->Dump();
+  }
+  mrm->AddResult(GetPhaseID(), *module, *modRef);
+  return modRef;
+}
+}  // namespace maple
@@ -13,6 +13,7 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "module_phase_manager.h"
+#include "trace_event.h"
 #include "class_hierarchy.h"
 #include "class_init.h"
 #include "option.h"
@@ -20,6 +21,9 @@
 #include "mpl_timer.h"
 #include "clone.h"
 #include "callgraph.h"
+#include "mod_ref.h"
+#include "nonnull_inference.h"
+#include "rc_summary.h"
 #if MIR_JAVA
 #include "native_stub_func.h"
 #include "vtable_analysis.h"
@@ -33,6 +37,7 @@
 #include "analyzector.h"
 #include "coderelayout.h"
 #include "constantfold.h"
+#include "global_tables.h"
 #endif  // ~MIR_JAVA
 
 namespace {
@@ -86,7 +91,13 @@ void ModulePhaseManager::Run() {
     if (timePhases) {
       timer.Start();
     }
+    TraceScope traceScope(GetMgrName(), p->PhaseName(), mirModule.GetFileName());
     p->Run(&mirModule, arModuleMgr);
+    // no FieldID lookup runs between module phases
+    GlobalTables::GetTypeTable().ReleaseStaleFlatFieldTables();
+    if (TraceEventRecorder::IsEnabled()) {
+      traceScope.SetMemPoolBytes(p->GetMemPoolSize());
+    }
     if (timePhases) {
       timer.Stop();
       phaseTimers[phaseIndex] += timer.ElapsedMicroseconds();
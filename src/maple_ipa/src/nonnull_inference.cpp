@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "nonnull_inference.h"
+#include "option.h"
+#include "me_const.h"
+
+// Return values are inferred callees first and formals callers first, both over the SCCs of the
+// call graph. Within an SCC the facts start out optimistic, all returns and formals being taken as
+// non-null, and are dropped until the remaining ones hold for every function of the SCC: a value
+// only depending on itself through recursion is then still non-null, as no null can enter the cycle.
+//
+// Only functions that cannot be reached from outside the module get facts about their formals:
+// private methods in Java and file-static functions otherwise, neither having its address taken
+// nor being reached through a virtual, interface or indirect call. Reflection is not seen; a null
+// passed in that way still faults on the first dereference, which the runtime reports as usual.
+namespace {
+using namespace maple;
+
+bool IsAllocation(Opcode op) {
+  return op == OP_gcmalloc || op == OP_gcmallocjarray || op == OP_gcpermalloc || op == OP_gcpermallocjarray;
+}
+
+bool IsDirectCall(Opcode op) {
+  return op == OP_call || op == OP_callassigned || op == OP_superclasscall || op == OP_superclasscallassigned;
+}
+}  // namespace
+
+namespace maple {
+void NonNullInference::CollectExprInfo(FuncInfo &info, const BaseNode &expr) {
+  if (expr.GetOpCode() == OP_addrof && static_cast<const AddrofNode&>(expr).GetStIdx().Islocal()) {
+    (void)info.addrTakenLocals.insert(static_cast<const AddrofNode&>(expr).GetStIdx());
+  } else if (expr.GetOpCode() == OP_addroffunc) {
+    (void)addrTakenFuncs.insert(static_cast<const AddroffuncNode&>(expr).GetPUIdx());
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    CollectExprInfo(info, *expr.Opnd(i));
+  }
+}
+
+void NonNullInference::CollectFuncInfo(FuncInfo &info, const BlockNode &block) {
+  for (const StmtNode *stmt = block.GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    switch (stmt->GetOpCode()) {
+      case OP_block:
+        CollectFuncInfo(info, static_cast<const BlockNode&>(*stmt));
+        break;
+      case OP_if: {
+        auto *ifStmt = static_cast<const IfStmtNode*>(stmt);
+        CollectFuncInfo(info, *ifStmt->GetThenPart());
+        if (ifStmt->GetElsePart() != nullptr) {
+          CollectFuncInfo(info, *ifStmt->GetElsePart());
+        }
+        break;
+      }
+      case OP_while:
+      case OP_dowhile:
+        CollectFuncInfo(info, *static_cast<const WhileStmtNode*>(stmt)->GetBody());
+        break;
+      case OP_doloop: {
+        auto *doloop = static_cast<const DoloopNode*>(stmt);
+        if (!doloop->IsPreg() && doloop->GetDoVarStIdx().Islocal()) {
+          info.localDefs[doloop->GetDoVarStIdx()].push_back(LocalDef{ nullptr, 0, true });
+        }
+        CollectFuncInfo(info, *doloop->GetDoBody());
+        break;
+      }
+      case OP_dassign: {
+        auto *dassign = static_cast<const DassignNode*>(stmt);
+        if (dassign->GetStIdx().Islocal()) {
+          bool isWhole = dassign->GetFieldID() == 0;
+          info.localDefs[dassign->GetStIdx()].push_back(LocalDef{ isWhole ? dassign->GetRHS() : nullptr, 0, !isWhole });
+        }
+        break;
+      }
+      case OP_return:
+        if (stmt->NumOpnds() == 1) {
+          info.returnValues.push_back(stmt->Opnd(0));
+        }
+        break;
+      default: {
+        CallReturnVector *returnValues = const_cast<StmtNode*>(stmt)->GetCallReturnVector();
+        if (returnValues == nullptr) {
+          break;
+        }
+        bool isDirect = IsDirectCall(stmt->GetOpCode()) && returnValues->size() == 1;
+        for (const CallReturnPair &returnValue : *returnValues) {
+          if (returnValue.second.IsReg() || !returnValue.first.Islocal()) {
+            continue;
+          }
+          PUIdx callee = isDirect ? static_cast<const CallNode*>(stmt)->GetPUIdx() : 0;
+          info.localDefs[returnValue.first].push_back(LocalDef{ nullptr, callee, !isDirect });
+        }
+        break;
+      }
+    }
+    for (size_t i = 0; i < stmt->NumOpnds(); ++i) {
+      CollectExprInfo(info, *stmt->Opnd(i));
+    }
+  }
+}
+
+// functions whose address is stored in initialized globals, such as tables of function pointers
+void NonNullInference::CollectAddrTakenFuncs(const MIRConst &mirConst) {
+  if (mirConst.GetKind() == kConstAddrofFunc) {
+    (void)addrTakenFuncs.insert(static_cast<const MIRAddroffuncConst&>(mirConst).GetValue());
+  } else if (mirConst.GetKind() == kConstAggConst) {
+    for (const MIRConst *elem : static_cast<const MIRAggConst&>(mirConst).GetConstVec()) {
+      if (elem != nullptr) {
+        CollectAddrTakenFuncs(*elem);
+      }
+    }
+  }
+}
+
+void NonNullInference::CollectCallSites() {
+  for (const auto &nodePair : callGraph.GetNodesMap()) {
+    CGNode *caller = nodePair.second;
+    for (const auto &callSite : caller->GetCallee()) {
+      CallInfo *callInfo = callSite.first;
+      const StmtNode *callStmt = callInfo->GetCallStmt();
+      bool isDirect = callStmt != nullptr && IsDirectCall(callStmt->GetOpCode()) &&
+                      (callInfo->GetCallType() == kCallTypeCall || callInfo->GetCallType() == kCallTypeSuperCall);
+      for (CGNode *calleeNode : *callSite.second) {
+        MIRFunction *callee = calleeNode->GetMIRFunction();
+        if (callee == nullptr) {
+          continue;
+        }
+        if (!isDirect) {
+          (void)indirectCallees.insert(callee->GetPuidx());
+          continue;
+        }
+        auto it = funcInfos.find(callee->GetPuidx());
+        if (it != funcInfos.end() && caller->GetMIRFunction() != nullptr) {
+          it->second.callSites.emplace_back(caller->GetMIRFunction()->GetPuidx(),
+                                            static_cast<const CallNode*>(callStmt));
+        }
+      }
+    }
+  }
+}
+
+bool NonNullInference::IsNonNullExpr(const BaseNode &expr, const std::set<StIdx> &nonNullLocals) const {
+  Opcode op = expr.GetOpCode();
+  if (IsAllocation(op) || op == OP_addrof || op == OP_addroffunc || op == OP_conststr || op == OP_conststr16) {
+    return true;
+  }
+  if (op == OP_dread) {
+    const auto &dread = static_cast<const DreadNode&>(expr);
+    return dread.GetFieldID() == 0 && nonNullLocals.find(dread.GetStIdx()) != nonNullLocals.end();
+  }
+  if (op == OP_retype) {
+    return IsNonNullExpr(*expr.Opnd(0), nonNullLocals);
+  }
+  return false;
+}
+
+bool NonNullInference::IsNonNullDef(const LocalDef &def, const std::set<StIdx> &nonNullLocals) const {
+  if (def.unknown) {
+    return false;
+  }
+  if (def.rhs != nullptr) {
+    return IsNonNullExpr(*def.rhs, nonNullLocals);
+  }
+  return IsReturnNonNull(def.callee);
+}
+
+bool NonNullInference::IsThisFormal(const FuncInfo &info, const StIdx &stIdx) const {
+  if (!module.IsJavaModule() || info.func->IsStatic() || info.func->GetFormalCount() == 0) {
+    return false;
+  }
+  const MIRSymbol *formal = info.func->GetFormal(0);
+  return formal != nullptr && formal->GetStIdx() == stIdx && formal->GetName() == kStrThisPointer;
+}
+
+// the locals of the function that are never null where they are read, given the formals in
+// formalMask are not null on entry
+std::set<StIdx> NonNullInference::ComputeNonNullLocals(const FuncInfo &info, uint64 formalMask) const {
+  std::set<StIdx> nonNullLocals;
+  for (size_t i = 0; i < info.func->GetFormalCount(); ++i) {
+    const MIRSymbol *formal = info.func->GetFormal(i);
+    if (formal == nullptr || info.addrTakenLocals.find(formal->GetStIdx()) != info.addrTakenLocals.end()) {
+      continue;
+    }
+    bool onEntry = (i < kMaxTrackedFormals && (formalMask & (1ULL << i)) != 0) ||
+                   IsThisFormal(info, formal->GetStIdx());
+    if (onEntry) {
+      (void)nonNullLocals.insert(formal->GetStIdx());
+    }
+  }
+  for (const auto &defPair : info.localDefs) {
+    const MIRSymbol *sym = info.func->GetLocalOrGlobalSymbol(defPair.first);
+    bool isFormal = sym != nullptr && sym->GetStorageClass() == kScFormal;
+    if (!isFormal && info.addrTakenLocals.find(defPair.first) == info.addrTakenLocals.end()) {
+      (void)nonNullLocals.insert(defPair.first);
+    }
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto it = nonNullLocals.begin(); it != nonNullLocals.end();) {
+      auto defIt = info.localDefs.find(*it);
+      bool allNonNull = true;
+      if (defIt != info.localDefs.end()) {
+        for (const LocalDef &def : defIt->second) {
+          if (!IsNonNullDef(def, nonNullLocals)) {
+            allNonNull = false;
+            break;
+          }
+        }
+      }
+      if (allNonNull) {
+        ++it;
+      } else {
+        it = nonNullLocals.erase(it);
+        changed = true;
+      }
+    }
+  }
+  return nonNullLocals;
+}
+
+bool NonNullInference::IsInternal(const MIRFunction &func) const {
+  if (func.GetBody() == nullptr || addrTakenFuncs.find(func.GetPuidx()) != addrTakenFuncs.end() ||
+      indirectCallees.find(func.GetPuidx()) != indirectCallees.end()) {
+    return false;
+  }
+  if (module.IsJavaModule()) {
+    return func.IsPrivate() && !func.IsAnyNative();
+  }
+  return func.GetFuncSymbol() != nullptr && func.GetFuncSymbol()->GetStorageClass() == kScFstatic;
+}
+
+uint64 NonNullInference::GetPointerFormalMask(const MIRFunction &func) const {
+  uint64 mask = 0;
+  for (size_t i = 0; i < func.GetFormalCount() && i < kMaxTrackedFormals; ++i) {
+    const MIRSymbol *formal = func.GetFormal(i);
+    if (formal != nullptr && IsPointerType(formal->GetType()->GetPrimType())) {
+      mask |= 1ULL << i;
+    }
+  }
+  return mask;
+}
+
+void NonNullInference::InferReturns(const SCCNode &scc) {
+  std::vector<FuncInfo*> members;
+  for (CGNode *node : scc.GetCGNodes()) {
+    MIRFunction *func = node->GetMIRFunction();
+    auto it = func == nullptr ? funcInfos.end() : funcInfos.find(func->GetPuidx());
+    // a body without returns says nothing about what the function returns
+    if (it != funcInfos.end() && !it->second.returnValues.empty() &&
+        IsPointerType(func->GetReturnType()->GetPrimType())) {
+      members.push_back(&it->second);
+      (void)nonNullReturns.insert(func->GetPuidx());
+    }
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (FuncInfo *info : members) {
+      PUIdx puIdx = info->func->GetPuidx();
+      if (!IsReturnNonNull(puIdx)) {
+        continue;
+      }
+      std::set<StIdx> nonNullLocals = ComputeNonNullLocals(*info, 0);
+      for (const BaseNode *returnValue : info->returnValues) {
+        if (!IsNonNullExpr(*returnValue, nonNullLocals)) {
+          (void)nonNullReturns.erase(puIdx);
+          changed = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+void NonNullInference::InferFormals(const SCCNode &scc) {
+  std::vector<FuncInfo*> members;
+  for (CGNode *node : scc.GetCGNodes()) {
+    MIRFunction *func = node->GetMIRFunction();
+    auto it = func == nullptr ? funcInfos.end() : funcInfos.find(func->GetPuidx());
+    // functions without calls in the module are entry points of some kind, e.g. called by the runtime
+    if (it == funcInfos.end() || !IsInternal(*func) || it->second.callSites.empty()) {
+      continue;
+    }
+    uint64 mask = GetPointerFormalMask(*func);
+    if (mask != 0) {
+      members.push_back(&it->second);
+      nonNullFormals[func->GetPuidx()] = mask;
+    }
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (FuncInfo *info : members) {
+      uint64 &mask = nonNullFormals[info->func->GetPuidx()];
+      uint64 oldMask = mask;
+      for (const auto &callSite : info->callSites) {
+        if (mask == 0) {
+          break;
+        }
+        auto callerIt = funcInfos.find(callSite.first);
+        if (callerIt == funcInfos.end()) {
+          mask = 0;
+          break;
+        }
+        auto maskIt = nonNullFormals.find(callSite.first);
+        uint64 callerMask = maskIt == nonNullFormals.end() ? 0 : maskIt->second;
+        std::set<StIdx> nonNullLocals = ComputeNonNullLocals(callerIt->second, callerMask);
+        const CallNode &call = *callSite.second;
+        for (size_t i = 0; i < kMaxTrackedFormals; ++i) {
+          if ((mask & (1ULL << i)) != 0 && (i >= call.NumOpnds() || !IsNonNullExpr(*call.Opnd(i), nonNullLocals))) {
+            mask &= ~(1ULL << i);
+          }
+        }
+      }
+      changed = changed || mask != oldMask;
+    }
+  }
+}
+
+void NonNullInference::Run() {
+  for (const auto &nodePair : callGraph.GetNodesMap()) {
+    MIRFunction *func = nodePair.first;
+    // the body of a native is empty until its stub is generated, nothing is inferred for it
+    if (func == nullptr || func->GetBody() == nullptr || func->IsAnyNative()) {
+      continue;
+    }
+    FuncInfo &info = funcInfos[func->GetPuidx()];
+    info.func = func;
+    CollectFuncInfo(info, *func->GetBody());
+  }
+  if (!module.IsJavaModule()) {
+    // the reflection metadata of java refers to every method, only tables of function pointers matter
+    for (size_t i = 1; i < GlobalTables::GetGsymTable().GetSymbolTableSize(); ++i) {
+      MIRSymbol *sym = GlobalTables::GetGsymTable().GetSymbolFromStidx(static_cast<uint32>(i));
+      if (sym != nullptr && sym->GetKonst() != nullptr) {
+        CollectAddrTakenFuncs(*sym->GetKonst());
+      }
+    }
+  }
+  CollectCallSites();
+  const MapleVector<SCCNode*> &sccTopVec = callGraph.GetSCCTopVec();
+  // the SCCs are in topological order, callers first
+  for (auto sccIt = sccTopVec.rbegin(); sccIt != sccTopVec.rend(); ++sccIt) {
+    InferReturns(**sccIt);
+  }
+  for (SCCNode *scc : sccTopVec) {
+    InferFormals(*scc);
+  }
+  for (auto it = nonNullFormals.begin(); it != nonNullFormals.end();) {
+    it = it->second == 0 ? nonNullFormals.erase(it) : ++it;
+  }
+  // the analysis result lives in a mempool, which does not run destructors
+  funcInfos.clear();
+  addrTakenFuncs.clear();
+  indirectCallees.clear();
+}
+
+void NonNullInference::Dump() const {
+  for (PUIdx puIdx : nonNullReturns) {
+    MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(puIdx);
+    LogInfo::MapleLogger() << "nonnull return: " << func->GetName() << '\n';
+  }
+  for (const auto &formalPair : nonNullFormals) {
+    MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(formalPair.first);
+    LogInfo::MapleLogger() << "nonnull formals 0x" << std::hex << formalPair.second << std::dec << ": "
+                           << func->GetName() << '\n';
+  }
+}
+
+AnalysisResult *DoNonNullInference::Run(MIRModule *module, ModuleResultMgr *mrm) {
+  auto *callGraph = static_cast<CallGraph*>(mrm->GetAnalysisResult(MoPhase_CALLGRAPH_ANALYSIS, module));
+  CHECK_FATAL(callGraph != nullptr, "call graph can't be null");
+  MemPool *memPool = memPoolCtrler.NewMemPool(PhaseName());
+  NonNullInference *nonNull = memPool->New<NonNullInference>(*memPool, *module, *callGraph);
+  nonNull->Run();
+  if (TRACE_PHASE) {
+    nonNull->Dump();
+  }
+  mrm->AddResult(GetPhaseID(), *module, *nonNull);
+  return nonNull;
+}
+}  // namespace maple
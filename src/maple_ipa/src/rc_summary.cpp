@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "rc_summary.h"
+#include "option.h"
+
+// The uses of each ref formal are classified by the context reading it: comparisons and branch
+// conditions neither retain nor dereference it, loads and address computations based on it
+// dereference it, and every other use, including reassigning the formal, counts as both. A formal
+// passed unchanged to a direct call with a known body takes on the summary of the callee's formal.
+//
+// The SCCs of the call graph are visited callees first. Within an SCC the functions start out
+// from the uses in their own bodies only and the callee summaries are merged in until nothing
+// changes, so a formal only passed around the cycle stays as clean as its local uses are.
+namespace {
+using namespace maple;
+
+bool IsDirectCall(Opcode op) {
+  return op == OP_call || op == OP_callassigned || op == OP_superclasscall || op == OP_superclasscallassigned;
+}
+}  // namespace
+
+namespace maple {
+void RCSummary::MarkFormal(FuncInfo &info, const StIdx &stIdx, uint8 use) const {
+  auto it = info.refFormals.find(stIdx);
+  if (it == info.refFormals.end()) {
+    return;
+  }
+  uint64 bit = 1ULL << it->second;
+  if ((use & kUseDeref) != 0) {
+    info.derefed |= bit;
+  }
+  if ((use & kUseRetain) != 0) {
+    info.retained |= bit;
+  }
+}
+
+// expr is evaluated for a use of kind use
+void RCSummary::CollectExprUses(FuncInfo &info, const BaseNode &expr, uint8 use) const {
+  Opcode op = expr.GetOpCode();
+  if (op == OP_dread) {
+    const auto &dread = static_cast<const DreadNode&>(expr);
+    MarkFormal(info, dread.GetStIdx(), dread.GetFieldID() == 0 ? use : kUseAny);
+    return;
+  }
+  if (op == OP_addrof) {
+    MarkFormal(info, static_cast<const AddrofNode&>(expr).GetStIdx(), kUseAny);
+    return;
+  }
+  uint8 opndUse = kUseAny;
+  if (op == OP_retype) {
+    opndUse = use;
+  } else if (kOpcodeInfo.IsCompare(op)) {
+    opndUse = kUseNone;
+  } else if (op == OP_iread) {
+    opndUse = kUseDeref;
+  } else if (op == OP_array || op == OP_iaddrof) {
+    // the address computed still points into the object
+    opndUse = use | kUseDeref;
+  } else if (op == OP_intrinsicop || op == OP_intrinsicopwithtype) {
+    MIRIntrinsicID intrinsic = static_cast<const IntrinsicopNode&>(expr).GetIntrinsic();
+    if (intrinsic == INTRN_JAVA_ARRAY_LENGTH || intrinsic == INTRN_JAVA_INSTANCE_OF) {
+      opndUse = kUseDeref;
+    }
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    CollectExprUses(info, *expr.Opnd(i), opndUse);
+  }
+}
+
+void RCSummary::CollectCallUses(FuncInfo &info, const CallNode &call) const {
+  for (size_t i = 0; i < call.NumOpnds(); ++i) {
+    const BaseNode *arg = call.Opnd(i);
+    while (arg->GetOpCode() == OP_retype) {
+      arg = arg->Opnd(0);
+    }
+    if (arg->GetOpCode() == OP_dread && static_cast<const DreadNode*>(arg)->GetFieldID() == 0) {
+      auto it = info.refFormals.find(static_cast<const DreadNode*>(arg)->GetStIdx());
+      if (it != info.refFormals.end()) {
+        info.passedFormals.push_back(PassedFormal{ call.GetPUIdx(), i, it->second });
+        continue;
+      }
+    }
+    CollectExprUses(info, *call.Opnd(i), kUseAny);
+  }
+}
+
+void RCSummary::CollectStmtUses(FuncInfo &info, const BlockNode &block) const {
+  for (const StmtNode *stmt = block.GetFirst(); stmt != nullptr; stmt = stmt->GetNext()) {
+    uint8 opndUse = kUseAny;
+    switch (stmt->GetOpCode()) {
+      case OP_block:
+        CollectStmtUses(info, static_cast<const BlockNode&>(*stmt));
+        break;
+      case OP_if: {
+        auto *ifStmt = static_cast<const IfStmtNode*>(stmt);
+        CollectStmtUses(info, *ifStmt->GetThenPart());
+        if (ifStmt->GetElsePart() != nullptr) {
+          CollectStmtUses(info, *ifStmt->GetElsePart());
+        }
+        opndUse = kUseNone;
+        break;
+      }
+      case OP_while:
+      case OP_dowhile:
+        CollectStmtUses(info, *static_cast<const WhileStmtNode*>(stmt)->GetBody());
+        opndUse = kUseNone;
+        break;
+      case OP_doloop:
+        CollectStmtUses(info, *static_cast<const DoloopNode*>(stmt)->GetDoBody());
+        break;
+      case OP_brtrue:
+      case OP_brfalse:
+      case OP_assertnonnull:
+      case OP_eval:
+        opndUse = kUseNone;
+        break;
+      case OP_dassign:
+        // a reassigned formal gets its own count on entry
+        MarkFormal(info, static_cast<const DassignNode*>(stmt)->GetStIdx(), kUseAny);
+        break;
+      case OP_iassign:
+        CollectExprUses(info, *stmt->Opnd(0), kUseDeref);
+        CollectExprUses(info, *stmt->Opnd(1), kUseAny);
+        continue;
+      case OP_syncenter:
+      case OP_syncexit:
+        opndUse = kUseDeref;
+        break;
+      default:
+        break;
+    }
+    CallReturnVector *returnValues = const_cast<StmtNode*>(stmt)->GetCallReturnVector();
+    if (returnValues != nullptr) {
+      for (const CallReturnPair &returnValue : *returnValues) {
+        if (!returnValue.second.IsReg()) {
+          MarkFormal(info, returnValue.first, kUseAny);
+        }
+      }
+    }
+    if (IsDirectCall(stmt->GetOpCode())) {
+      CollectCallUses(info, static_cast<const CallNode&>(*stmt));
+      continue;
+    }
+    for (size_t i = 0; i < stmt->NumOpnds(); ++i) {
+      CollectExprUses(info, *stmt->Opnd(i), opndUse);
+    }
+  }
+}
+
+uint8 RCSummary::GetCalleeUse(const PassedFormal &passed) const {
+  auto it = funcInfos.find(passed.callee);
+  if (it == funcInfos.end() || passed.argIdx >= kMaxTrackedFormals) {
+    return kUseAny;
+  }
+  const FuncInfo &calleeInfo = it->second;
+  if (passed.argIdx >= calleeInfo.func->GetFormalCount()) {
+    return kUseAny;
+  }
+  const MIRSymbol *formal = calleeInfo.func->GetFormal(passed.argIdx);
+  if (formal == nullptr || calleeInfo.refFormals.find(formal->GetStIdx()) == calleeInfo.refFormals.end()) {
+    return kUseAny;
+  }
+  uint64 bit = 1ULL << passed.argIdx;
+  uint8 use = kUseNone;
+  if ((calleeInfo.derefed & bit) != 0) {
+    use |= kUseDeref;
+  }
+  if ((calleeInfo.retained & bit) != 0) {
+    use |= kUseRetain;
+  }
+  return use;
+}
+
+void RCSummary::Summarize(const SCCNode &scc) {
+  std::vector<FuncInfo*> members;
+  for (CGNode *node : scc.GetCGNodes()) {
+    MIRFunction *func = node->GetMIRFunction();
+    auto it = func == nullptr ? funcInfos.end() : funcInfos.find(func->GetPuidx());
+    if (it != funcInfos.end()) {
+      members.push_back(&it->second);
+    }
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (FuncInfo *info : members) {
+      uint64 oldDerefed = info->derefed;
+      uint64 oldRetained = info->retained;
+      for (const PassedFormal &passed : info->passedFormals) {
+        uint64 bit = 1ULL << passed.formalIdx;
+        uint8 use = GetCalleeUse(passed);
+        if ((use & kUseDeref) != 0) {
+          info->derefed |= bit;
+        }
+        if ((use & kUseRetain) != 0) {
+          info->retained |= bit;
+        }
+      }
+      changed = changed || info->derefed != oldDerefed || info->retained != oldRetained;
+    }
+  }
+  for (FuncInfo *info : members) {
+    uint64 tracked = 0;
+    for (const auto &formalPair : info->refFormals) {
+      tracked |= 1ULL << formalPair.second;
+    }
+    PUIdx puIdx = info->func->GetPuidx();
+    uint64 inert = tracked & ~info->retained & ~info->derefed;
+    if (inert != 0) {
+      inertFormals[puIdx] = inert;
+    }
+  }
+}
+
+void RCSummary::Run() {
+  for (const auto &nodePair : callGraph.GetNodesMap()) {
+    MIRFunction *func = nodePair.first;
+    // natives are left without a summary: their bodies are empty until the stubs are generated, and
+    // the native code may keep what it is passed
+    if (func == nullptr || func->GetBody() == nullptr || func->IsAnyNative()) {
+      continue;
+    }
+    FuncInfo &info = funcInfos[func->GetPuidx()];
+    info.func = func;
+    for (size_t i = 0; i < func->GetFormalCount() && i < kMaxTrackedFormals; ++i) {
+      const MIRSymbol *formal = func->GetFormal(i);
+      if (formal != nullptr && formal->GetType()->GetPrimType() == PTY_ref) {
+        info.refFormals[formal->GetStIdx()] = i;
+      }
+    }
+    CollectStmtUses(info, *func->GetBody());
+  }
+  const MapleVector<SCCNode*> &sccTopVec = callGraph.GetSCCTopVec();
+  // the SCCs are in topological order, callers first
+  for (auto sccIt = sccTopVec.rbegin(); sccIt != sccTopVec.rend(); ++sccIt) {
+    Summarize(**sccIt);
+  }
+  // the analysis result lives in a mempool, which does not run destructors
+  funcInfos.clear();
+}
+
+void RCSummary::Dump() const {
+  for (const auto &formalPair : inertFormals) {
+    MIRFunction *func = GlobalTables::GetFunctionTable().GetFunctionFromPuidx(formalPair.first);
+    LogInfo::MapleLogger() << "rc summary inert 0x" << std::hex << formalPair.second << std::dec << ": "
+                           << func->GetName() << '\n';
+  }
+}
+
+AnalysisResult *DoRCSummary::Run(MIRModule *module, ModuleResultMgr *mrm) {
+  auto *callGraph = static_cast<CallGraph*>(mrm->GetAnalysisResult(MoPhase_CALLGRAPH_ANALYSIS, module));
+  CHECK_FATAL(callGraph != nullptr, "call graph can't be null");
+  MemPool *memPool = memPoolCtrler.NewMemPool(PhaseName());
+  RCSummary *rcSummary = memPool->New<RCSummary>(*memPool, *callGraph);
+  rcSummary->Run();
+  if (TRACE_PHASE) {
+    rcSummary->Dump();
+  }
+  mrm->AddResult(GetPhaseID(), *module, *rcSummary);
+  return rcSummary;
+}
+}  // namespace maple
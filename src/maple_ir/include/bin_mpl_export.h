@@ -70,12 +70,31 @@ enum : uint8 {
 
 // this value is used to check wether a file is a binary mplt file
 constexpr int32 kMpltMagicNumber = 0xC0FFEE;
+// a snapshot of a text mplt starts with this value, its format version and the stamp of the mplt,
+// followed by a binary mplt
+constexpr int32 kMpltSnapshotMagicNumber = 0xC0FFEF;
+// bump this whenever the binary mplt encoding changes, so that stale snapshots are taken again
+constexpr int32 kMpltSnapshotVersion = 1;
+
+// the size and modification time of the text mplt a snapshot was taken from
+struct MpltStamp {
+  int64 size = 0;
+  int64 mtime = 0;
+};
+
+bool GetMpltStamp(const std::string &mpltName, MpltStamp &stamp);
+
+inline std::string GetMpltSnapshotName(const std::string &mpltName) {
+  return mpltName + ".snapshot";
+}
+
 class BinaryMplExport {
  public:
   explicit BinaryMplExport(MIRModule &md);
   virtual ~BinaryMplExport() = default;
 
   void Export(const std::string &fname);
+  bool ExportSnapshot(const std::string &mpltName);
   void WriteNum(int64 x);
   void Write(uint8 b);
   void OutputType(TyIdx tyIdx);
@@ -106,10 +125,15 @@ class BinaryMplExport {
     return mod;
   }
 
+  const std::vector<uint8> &GetBuf() const {
+    return buf;
+  }
+
  private:
   void WriteContentField(int fieldNum, uint64 *fieldStartP);
-  void WriteStrField(uint64 contentIdx);
+  void WriteStrField(uint64 contentIdx, bool withImportedLiterals = false);
   void WriteTypeField(uint64 contentIdx);
+  bool IsSnapshotComplete();
   void Init();
   void WriteInt(int32 x);
   uint8 Read();
@@ -27,6 +27,7 @@ class BinaryMplImport {
   BinaryMplImport(const BinaryMplImport&) = delete;
 
   virtual ~BinaryMplImport() {
+    UnmapFile();
     for (MIRStructType *structPtr : tmpStruct) {
       delete structPtr;
     }
@@ -46,10 +47,18 @@ class BinaryMplImport {
   }
 
   bool IsBufEmpty() const {
-    return buf.empty();
+    return bufSize == 0;
   }
   size_t GetBufSize() const {
-    return buf.size();
+    return bufSize;
+  }
+
+  // read from data, which the caller keeps alive, instead of a mapped file
+  void ReadFromBuffer(const uint8 *data, size_t size) {
+    UnmapFile();
+    buf = data;
+    bufSize = size;
+    bufI = 0;
   }
 
   int32 GetContent(int64 key) const {
@@ -61,6 +70,7 @@ class BinaryMplImport {
   }
 
   bool Import(const std::string &modid, bool readSymbols = false, bool readSe = false);
+  bool ImportSnapshot(const std::string &mpltName);
   MIRSymbol *GetOrCreateSymbol(TyIdx tyIdx, GStrIdx strIdx, MIRSymKind mclass, MIRStorageClass sclass,
                                MIRFunction *func, uint8 scpID);
   int32 ReadInt();
@@ -106,6 +116,8 @@ class BinaryMplImport {
   PUIdx ImportFunction();
   MIRSymbol *InSymbol(MIRFunction *func);
   void ReadFileAt(const std::string &modid, int32 offset);
+  void UnmapFile();
+  bool ReadMplt();
   uint8 Read();
   int64 ReadInt64();
   void ReadAsciiStr(std::string &str);
@@ -113,7 +125,10 @@ class BinaryMplImport {
 
   bool imported = true;  // used only by irbuild to convert to ascii
   uint64 bufI = 0;
-  std::vector<uint8> buf;
+  const uint8 *buf = nullptr;  // the file is mapped read only rather than copied
+  size_t bufSize = 0;
+  void *mappedFile = nullptr;
+  size_t mappedSize = 0;
   std::map<int64, int32> content;
   MIRModule &mod;
   MIRBuilder mirBuilder;
@@ -38,6 +38,15 @@ class BinaryMplt {
     return binImport.Import(modID, readCG, readSE);
   }
 
+  bool ImportSnapshot(const std::string &mpltName) {
+    importFileName = mpltName;
+    return binImport.ImportSnapshot(mpltName);
+  }
+
+  bool ExportSnapshot(const std::string &mpltName) {
+    return binExport.ExportSnapshot(mpltName);
+  }
+
   const MIRModule &GetMod() const {
     return mirModule;
   }
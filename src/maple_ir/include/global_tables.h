@@ -17,6 +17,9 @@
 #include <iostream>
 #include <memory>
 #include <functional>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
 #include "mempool.h"
 #include "mempool_allocator.h"
 #include "types_def.h"
@@ -113,6 +116,8 @@ class TypeTable {
   }
 
   void SetTypeWithTyIdx(const TyIdx &tyIdx, MIRType &type);
+  // frees the stale flat field tables of all struct types; only call it where no FieldID lookup runs
+  void ReleaseStaleFlatFieldTables() const;
 
   TyIdx GetOrCreateMIRType(MIRType *pType);
 
@@ -331,110 +336,233 @@ class TypeTable {
   void AddFieldToStructType(MIRStructType &structType, const std::string &fieldName, MIRType &fieldType);
 
  private:
-  using MIRTypePtr = MIRType*;
-  struct Hash {
-    size_t operator()(const MIRTypePtr &ty) const {
-      return ty->GetHashIndex();
+  // Find the type with hash index hashIndex that isType accepts. The derived types are looked up
+  // by their components this way, so nothing is built or allocated unless the type is new.
+  template <typename Pred>
+  MIRType *FindType(size_t hashIndex, const Pred &isType) const {
+    auto range = typeHashTable.equal_range(hashIndex);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (isType(*it->second)) {
+        return it->second;
+      }
     }
-  };
-
-  struct Equal {
-    bool operator()(const MIRTypePtr &tx, const MIRTypePtr &ty) const {
-      return tx->EqualTo(*ty);
-    }
-  };
+    return nullptr;
+  }
 
   // create an entry in typeTable for the type node
-  MIRType *CreateType(MIRType &oldType) {
-    MIRType *newType = oldType.CopyMIRTypeNode();
-    newType->SetTypeIndex(TyIdx(typeTable.size()));
-    typeTable.push_back(newType);
-    return newType;
+  MIRType *CreateType(const MIRType &oldType) {
+    return AddType(*oldType.CopyMIRTypeNode());
+  }
+
+  // enter newType, which typeTable takes over, as a new entry
+  MIRType *AddType(MIRType &newType) {
+    newType.SetTypeIndex(TyIdx(typeTable.size()));
+    typeTable.push_back(&newType);
+    return &newType;
   }
 
+  MIRType *FindFarrayType(MIRTypeKind kind, TyIdx elemTyIdx) const;
   MIRType *GetOrCreateStructOrUnion(const std::string &name, const FieldVector &fields, const FieldVector &printFields,
                                     MIRModule &module, bool forStruct = true);
   MIRType *GetOrCreateClassOrInterface(const std::string &name, MIRModule &module, bool forClass);
 
-  std::unordered_set<MIRTypePtr, Hash, Equal> typeHashTable;
+  std::unordered_multimap<size_t, MIRType*> typeHashTable;  // keyed by MIRType::GetHashIndex
   std::vector<MIRType*> typeTable;
 };
 
-class StrPtrHash {
- public:
-  size_t operator()(const std::string *str) const {
-    return std::hash<std::string>{}(*str);
-  }
-
-  size_t operator()(const std::u16string *str) const {
-    return std::hash<std::u16string>{}(*str);
-  }
-};
-
-class StrPtrEqual {
- public:
-  bool operator()(const std::string *str1, const std::string *str2) const {
-    return *str1 == *str2;
-  }
-
-  bool operator()(const std::u16string *str1, const std::u16string *str2) const {
-    return *str1 == *str2;
-  }
-};
-
 // T can be std::string or std::u16string
 // U can be GStrIdx, UStrIdx, or U16StrIdx
+// The strings are kept with their hashes in chunks that never move, chunk n holding kFirstChunkSize << n
+// entries, so the string of an index is found without a lock. The index of a string is looked up in one
+// of kShards open addressing tables, picked by the hash of the string, without a lock either: a string
+// is added to a shard under the lock of the shard, and its slot is only published once its entry is
+// complete. A shard that grows moves to a new slot array and keeps the old one for the readers still
+// probing it until the table goes away.
 template <typename T, typename U>
 class StringTable {
  public:
-  StringTable() = default;
+  StringTable() {
+    for (auto &chunk : chunks) {
+      chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    for (Shard &shard : shards) {
+      shard.arrays.push_back(std::make_unique<SlotArray>(kInitSlotsPerShard));
+      shard.current.store(shard.arrays.back().get(), std::memory_order_relaxed);
+    }
+  }
+
   StringTable(const StringTable&) = delete;
   StringTable &operator=(const StringTable&) = delete;
 
   ~StringTable() {
-    stringTableMap.clear();
-    for (auto it : stringTable) {
-      delete it;
+    size_t entryNum = size.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < entryNum; ++i) {
+      GetEntry(i).~Entry();
+    }
+    for (auto &chunk : chunks) {
+      ::operator delete(chunk.load(std::memory_order_relaxed));
     }
   }
 
   void Init() {
-    // initialize 0th entry of stringTable with an empty string
-    T *ptr = new T;
-    stringTable.push_back(ptr);
+    // initialize 0th entry of stringTable with an empty string, which is not looked up by name
+    T emptyStr;
+    (void)NewEntry(emptyStr, std::hash<T>{}(emptyStr));
   }
 
   U GetStrIdxFromName(const T &str) const {
-    auto it = stringTableMap.find(&str);
-    if (it == stringTableMap.end()) {
-      return U(0);
-    }
-    return it->second;
+    size_t hash = std::hash<T>{}(str);
+    const Shard &shard = shards[hash % kShards];
+    uint32 idx = Find(*shard.current.load(std::memory_order_acquire), hash, str);
+    return idx == kNotFound ? U(0) : U(idx);
   }
 
   U GetOrCreateStrIdxFromName(const T &str) {
-    U strIdx = GetStrIdxFromName(str);
-    if (strIdx == 0u) {
-      strIdx.reset(stringTable.size());
-      T *newStr = new T(str);
-      stringTable.push_back(newStr);
-      stringTableMap[newStr] = strIdx;
+    size_t hash = std::hash<T>{}(str);
+    Shard &shard = shards[hash % kShards];
+    uint32 idx = Find(*shard.current.load(std::memory_order_acquire), hash, str);
+    if (idx != kNotFound) {
+      return U(idx);
     }
-    return strIdx;
+    std::lock_guard<std::mutex> lock(shard.mtx);
+    SlotArray *slots = shard.current.load(std::memory_order_relaxed);
+    // another thread may have added str since
+    idx = Find(*slots, hash, str);
+    if (idx != kNotFound) {
+      return U(idx);
+    }
+    idx = NewEntry(str, hash);
+    if ((shard.count + 1) * kMaxLoadDen > slots->slots.size() * kMaxLoadNum) {
+      slots = Grow(shard);
+    }
+    Insert(*slots, hash, idx, std::memory_order_release);
+    ++shard.count;
+    return U(idx);
   }
 
+  // includes the entries other threads are still adding
   size_t StringTableSize() const {
-    return stringTable.size();
+    return size.load(std::memory_order_acquire);
   }
 
   const T &GetStringFromStrIdx(U strIdx) const {
-    ASSERT(strIdx < stringTable.size(), "array index out of range");
-    return *stringTable[strIdx];
+    ASSERT(strIdx < StringTableSize(), "array index out of range");
+    return GetEntry(strIdx.GetIdx()).str;
   }
 
  private:
-  std::vector<const T*> stringTable;  // index is uint32
-  std::unordered_map<const T*, U, StrPtrHash, StrPtrEqual> stringTableMap;
+  static constexpr uint32 kNotFound = UINT32_MAX;
+  static constexpr size_t kShards = 16;
+  static constexpr size_t kInitSlotsPerShard = 256;
+  // the slots of a shard are at most half full
+  static constexpr size_t kMaxLoadNum = 1;
+  static constexpr size_t kMaxLoadDen = 2;
+  static constexpr size_t kFirstChunkBits = 10;
+  static constexpr size_t kFirstChunkSize = 1u << kFirstChunkBits;
+  static constexpr size_t kMaxChunks = 32 - kFirstChunkBits + 1;
+  static constexpr size_t kTagShift = 32;
+
+  struct Entry {
+    Entry(const T &s, size_t h) : str(s), hash(h) {}
+    T str;
+    size_t hash;
+  };
+
+  // a slot holds the upper half of the hash of a string and its index plus 1, 0 for an empty slot
+  struct SlotArray {
+    explicit SlotArray(size_t slotNum) : slots(slotNum) {}
+    std::vector<std::atomic<uint64>> slots;
+  };
+
+  struct Shard {
+    std::mutex mtx;
+    std::atomic<SlotArray*> current;
+    std::vector<std::unique_ptr<SlotArray>> arrays;  // the current one is last
+    size_t count = 0;
+  };
+
+  static size_t GetChunkBit(size_t idx) {
+    constexpr size_t bitsOfULL = 64;
+    return bitsOfULL - 1 - __builtin_clzll(static_cast<unsigned long long>(idx + kFirstChunkSize));
+  }
+
+  static uint64 GetTag(size_t hash) {
+    return static_cast<uint64>(hash) >> kTagShift;
+  }
+
+  const Entry &GetEntry(size_t idx) const {
+    size_t chunkBit = GetChunkBit(idx);
+    const Entry *chunk = chunks[chunkBit - kFirstChunkBits].load(std::memory_order_acquire);
+    return chunk[idx + kFirstChunkSize - (1ull << chunkBit)];
+  }
+
+  Entry &GetEntry(size_t idx) {
+    return const_cast<Entry&>(static_cast<const StringTable*>(this)->GetEntry(idx));
+  }
+
+  uint32 Find(const SlotArray &slots, size_t hash, const T &str) const {
+    size_t mask = slots.slots.size() - 1;
+    uint64 tag = GetTag(hash);
+    for (size_t i = (hash / kShards) & mask;; i = (i + 1) & mask) {
+      uint64 slot = slots.slots[i].load(std::memory_order_acquire);
+      if (slot == 0) {
+        return kNotFound;
+      }
+      if ((slot >> kTagShift) == tag) {
+        uint32 idx = static_cast<uint32>(slot) - 1;
+        const Entry &entry = GetEntry(idx);
+        if (entry.hash == hash && entry.str == str) {
+          return idx;
+        }
+      }
+    }
+  }
+
+  static void Insert(SlotArray &slots, size_t hash, uint32 idx, std::memory_order order) {
+    size_t mask = slots.slots.size() - 1;
+    size_t i = (hash / kShards) & mask;
+    while (slots.slots[i].load(std::memory_order_relaxed) != 0) {
+      i = (i + 1) & mask;
+    }
+    slots.slots[i].store((GetTag(hash) << kTagShift) | (static_cast<uint64>(idx) + 1), order);
+  }
+
+  SlotArray *Grow(Shard &shard) {
+    SlotArray *oldSlots = shard.current.load(std::memory_order_relaxed);
+    shard.arrays.push_back(std::make_unique<SlotArray>(oldSlots->slots.size() * 2));
+    SlotArray *newSlots = shard.arrays.back().get();
+    for (const std::atomic<uint64> &slot : oldSlots->slots) {
+      uint64 value = slot.load(std::memory_order_relaxed);
+      if (value != 0) {
+        uint32 idx = static_cast<uint32>(value) - 1;
+        Insert(*newSlots, GetEntry(idx).hash, idx, std::memory_order_relaxed);
+      }
+    }
+    shard.current.store(newSlots, std::memory_order_release);
+    return newSlots;
+  }
+
+  uint32 NewEntry(const T &str, size_t hash) {
+    size_t idx = size.fetch_add(1, std::memory_order_acq_rel);
+    CHECK_FATAL(idx < kNotFound, "string table overflow");
+    size_t chunkIdx = GetChunkBit(idx) - kFirstChunkBits;
+    Entry *chunk = chunks[chunkIdx].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      std::lock_guard<std::mutex> lock(chunkMtx);
+      chunk = chunks[chunkIdx].load(std::memory_order_relaxed);
+      if (chunk == nullptr) {
+        chunk = static_cast<Entry*>(::operator new(sizeof(Entry) * (kFirstChunkSize << chunkIdx)));
+        chunks[chunkIdx].store(chunk, std::memory_order_release);
+      }
+    }
+    new (&GetEntry(idx)) Entry(str, hash);
+    return static_cast<uint32>(idx);
+  }
+
+  std::atomic<Entry*> chunks[kMaxChunks];
+  std::mutex chunkMtx;
+  std::atomic<size_t> size{ 0 };
+  Shard shards[kShards];
 };
 
 class FPConstTable {
@@ -619,6 +747,10 @@ class ConstPool {
     return importedLiteralNames.find(gIdx) != importedLiteralNames.end();
   }
 
+  const std::set<GStrIdx> &GetImportedLiteralNames() const {
+    return importedLiteralNames;
+  }
+
  protected:
   std::unordered_map<GStrIdx, MIRConst*, GStrIdxHash> constMap;
   std::set<GStrIdx> importedLiteralNames;
@@ -33,7 +33,8 @@ enum IntrinProperty {
   kIntrnNeverReturn,
   kIntrnIsAtomic,
   kIntrnIsRC,
-  kIntrnIsSpecial
+  kIntrnIsSpecial,
+  kIntrnIsIdempotent
 };
 
 enum IntrinArgType {
@@ -87,6 +88,7 @@ constexpr uint32 INTRNNEVERRETURN = 1U << kIntrnNeverReturn;
 constexpr uint32 INTRNATOMIC = 1U << kIntrnIsAtomic;
 constexpr uint32 INTRNISRC = 1U << kIntrnIsRC;
 constexpr uint32 INTRNISSPECIAL = 1U << kIntrnIsSpecial;
+constexpr uint32 INTRNISIDEMPOTENT = 1U << kIntrnIsIdempotent;
 class MIRType;    // circular dependency exists, no other choice
 class MIRModule;  // circular dependency exists, no other choice
 struct IntrinDesc {
@@ -142,6 +144,11 @@ struct IntrinDesc {
     return static_cast<bool>(properties & INTRNISSPECIAL);
   }
 
+  // a call right after an identical one, with no redefinition of its operands in between, has no effect
+  bool IsIdempotent() const {
+    return static_cast<bool>(properties & INTRNISIDEMPOTENT);
+  }
+
   bool HasNoSideEffect() const {
     return properties & INTRNNOSIDEEFFECT;
   }
@@ -23,11 +23,14 @@
 
 namespace maple {
 class MIRParser;  // circular dependency exists, no other choice
+class MIRParallelLexer;
 class MIRLexer {
   friend MIRParser;
+  friend MIRParallelLexer;
 
  public:
   explicit MIRLexer(MIRModule &mod);
+  MIRLexer(MIRModule &mod, MapleAllocator &allocator);
   ~MIRLexer() {
     airFile = nullptr;
     if (airFileInternal.is_open()) {
@@ -87,8 +90,13 @@ class MIRLexer {
   TokenKind kind = TK_invalid;
   std::string name = "";  // store the name token without the % or $ prefix
   MapleUnorderedMap<std::string, TokenKind> keywordMap;
+  // the tokens are lexed ahead by parallelLexer if set
+  MIRParallelLexer *parallelLexer = nullptr;
+  // the lines are taken from lineBuffer instead of airFile if set
+  std::vector<std::string> *lineBuffer = nullptr;
+  size_t nextLineInBuffer = 0;
 
-  void RemoveReturnInline(std::string &line) {
+  static void RemoveReturnInline(std::string &line) {
     if (line.empty()) {
       return;
     }
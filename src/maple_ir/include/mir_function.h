@@ -219,6 +219,11 @@ class MIRFunction {
     return funcAttrs.GetAttr(FUNCATTR_native);
   }
 
+  // a native of any kind, whose body is empty until the native stub is generated and tells nothing
+  bool IsAnyNative() const {
+    return IsNative() || funcAttrs.GetAttr(FUNCATTR_fast_native) || funcAttrs.GetAttr(FUNCATTR_critical_native);
+  }
+
   bool IsFinal() const {
     return funcAttrs.GetAttr(FUNCATTR_final);
   }
@@ -390,6 +395,8 @@ class MIRFunction {
 
   void SetUpGDBEnv();
   void ResetGDBEnv();
+  // frees the statements of the function, after which Dump prints its declaration only
+  void ReleaseCodeMemory();
 
   MemPool *GetCodeMempool() {
     if (codeMemPool == nullptr) {
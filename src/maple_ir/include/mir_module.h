@@ -309,6 +309,15 @@ class MIRModule {
     return nullptr;
   }
 
+  const MapleVector<uint8> *GetParamEscapeSummary(PUIdx puIdx) const {
+    auto it = puIdxParamEscapeMap.find(puIdx);
+    return it == puIdxParamEscapeMap.end() ? nullptr : it->second;
+  }
+
+  void SetParamEscapeSummary(PUIdx puIdx, MapleVector<uint8> *summary) {
+    puIdxParamEscapeMap[puIdx] = summary;
+  }
+
   std::ostream &GetOut() const {
     return out;
   }
@@ -556,6 +565,9 @@ class MIRModule {
   // if puIdx appears in the map, and the value of first corresponding MapleSet is 0, the puIdx appears in this module
   // and writes to all field id otherwise, it writes the field ids in MapleSet
   MapleMap<PUIdx, MapleSet<FieldID>*> puIdxFieldInitializedMap;
+  // what each formal of a function may suffer from the callee, filled in by me escape analysis
+  // as functions are optimized bottom-up; a function missing here may do anything to its formals
+  MapleMap<PUIdx, MapleVector<uint8>*> puIdxParamEscapeMap;
   std::map<std::pair<GStrIdx, GStrIdx>, GStrIdx> realCaller;
 };
 #endif  // MIR_FEATURE_FULL
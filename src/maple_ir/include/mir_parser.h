@@ -16,6 +16,7 @@
 #define MAPLE_IR_INCLUDE_MIR_PARSER_H
 #include "mir_module.h"
 #include "lexer.h"
+#include "parallel_lexer.h"
 #include "mir_nodes.h"
 #include "mir_preg.h"
 #include "parser_opt.h"
@@ -267,6 +268,7 @@ class MIRParser {
   // func and param for ParseStmtBlock
   MIRFunction *paramCurrFuncForParseStmtBlock = nullptr;
   MIRLexer lexer;
+  std::unique_ptr<MIRParallelLexer> parallelLexer;  // set while lexing ahead of the parser
   MIRModule &mod;
   std::string message;
   std::string warningMessage;
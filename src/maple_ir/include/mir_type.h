@@ -16,6 +16,8 @@
 #define MAPLE_IR_INCLUDE_MIR_TYPE_H
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <memory>
 #include "prim_types.h"
 #include "mir_pragma.h"
 #include "mpl_logging.h"
@@ -547,8 +549,13 @@ class MIRPtrType : public MIRType {
   TyIdxFieldAttrPair GetPointedTyIdxFldAttrPairWithFieldID(FieldID fieldID) const;
   TyIdx GetPointedTyIdxWithFieldID(FieldID fieldID) const;
   size_t GetHashIndex() const override {
+    return GetHashIndexOf(pointedTyIdx);
+  }
+
+  // the hash index of the pointer types to pointedTyIdx, computed without a type at hand
+  static size_t GetHashIndexOf(TyIdx pointedTyIdx) {
     constexpr uint8 idxShift = 4;
-    return ((static_cast<size_t>(pointedTyIdx) << idxShift) + (typeKind << kShiftNumOfTypeKind)) % kTypeHashLength;
+    return ((static_cast<size_t>(pointedTyIdx) << idxShift) + (kTypePointer << kShiftNumOfTypeKind)) % kTypeHashLength;
   }
 
   bool PointsToConstString() const override;
@@ -629,8 +636,12 @@ class MIRArrayType : public MIRType {
   }
 
   size_t GetHashIndex() const override {
+    return GetHashIndexOf(eTyIdx, dim, sizeArray.data());
+  }
+
+  static size_t GetHashIndexOf(TyIdx eTyIdx, uint16 dim, const uint32 *sizeArray) {
     constexpr uint8 idxShift = 2;
-    size_t hIdx = (static_cast<size_t>(eTyIdx) << idxShift) + (typeKind << kShiftNumOfTypeKind);
+    size_t hIdx = (static_cast<size_t>(eTyIdx) << idxShift) + (kTypeArray << kShiftNumOfTypeKind);
     for (size_t i = 0; i < dim; ++i) {
       CHECK_FATAL(i < kMaxArrayDim, "array index out of range");
       hIdx += (sizeArray[i] << i);
@@ -678,8 +689,13 @@ class MIRFarrayType : public MIRType {
   void Dump(int indent, bool dontUseName = false) const override;
 
   size_t GetHashIndex() const override {
+    return GetHashIndexOf(typeKind, elemTyIdx);
+  }
+
+  // kind is kTypeFArray or kTypeJArray
+  static size_t GetHashIndexOf(MIRTypeKind kind, TyIdx elemTyIdx) {
     constexpr uint8 idxShift = 5;
-    return ((static_cast<size_t>(elemTyIdx) << idxShift) + (typeKind << kShiftNumOfTypeKind)) % kTypeHashLength;
+    return ((static_cast<size_t>(elemTyIdx) << idxShift) + (kind << kShiftNumOfTypeKind)) % kTypeHashLength;
   }
 
   std::string GetMplTypeName() const override;
@@ -695,6 +711,44 @@ using MethodVector = std::vector<MethodPair>;
 using MethodPtrVector = std::vector<MethodPair*>;
 using MIREncodedArray = std::vector<EncodedValue>;
 
+// The fields of a struct in FieldID order, including those of the structs it embeds and of its parent
+// classes. The field with FieldID i is fields[slots[i - 1].second] of the struct slots[i - 1].first,
+// TyIdx(0) standing for the struct the table belongs to; the slot of a parent class has no field and
+// the index kFlatFieldParentSlot. The table is current while epoch equals the epoch of the struct
+// layouts, which any change that may shift FieldIDs, in any struct, moves on.
+constexpr uint32 kFlatFieldParentSlot = UINT32_MAX;
+struct FlatFieldTable {
+  std::vector<std::pair<TyIdx, uint32>> slots;
+  std::atomic<uint32> epoch{ 0 };
+};
+
+// The flat field tables of one struct. The current one is published through a plain pointer, so a
+// lookup is one load and one compare; the stale ones are kept for the lookups still running in them
+// until ReleaseStale is called where no lookup can be running. A copy of a struct starts without a
+// table of its own.
+class FlatFieldTableCache {
+ public:
+  FlatFieldTableCache() = default;
+  FlatFieldTableCache(const FlatFieldTableCache&) {}
+  FlatFieldTableCache &operator=(const FlatFieldTableCache&) {
+    current.store(nullptr, std::memory_order_release);
+    return *this;
+  }
+  ~FlatFieldTableCache() = default;
+
+  const FlatFieldTable *GetCurrent() const {
+    return current.load(std::memory_order_acquire);
+  }
+
+  // returns the table that becomes current, which is the old one when its slots are still the same
+  const FlatFieldTable &Publish(std::unique_ptr<FlatFieldTable> table);
+  void ReleaseStale();
+
+ private:
+  std::atomic<const FlatFieldTable*> current{ nullptr };
+  std::vector<std::unique_ptr<FlatFieldTable>> tables;
+};
+
 // used by kTypeStruct, kTypeStructIncomplete, kTypeUnion
 class MIRStructType : public MIRType {
  public:
@@ -716,6 +770,11 @@ class MIRStructType : public MIRType {
   }
   void SetFields(const FieldVector &fields) {
     this->fields = fields;
+    FieldsChanged();
+  }
+  void PushbackField(const FieldPair &field) {
+    fields.push_back(field);
+    FieldsChanged();
   }
 
   const FieldPair &GetFieldsElemt(size_t n) const {
@@ -869,6 +928,7 @@ class MIRStructType : public MIRType {
   void SetElemtTyIdxSimple(size_t n, TyIdx tyIdx) {
     ASSERT(n < fields.size(), "array index out of range");
     fields.at(n).second.first = tyIdx;
+    FieldsChanged();
   }
 
   TyIdx GetStaticElemtTyIdx(size_t n) const {
@@ -892,6 +952,7 @@ class MIRStructType : public MIRType {
   void SetElemtTyIdx(size_t n, TyIdx tyIdx) {
     ASSERT(n < fields.size(), "array index out of range");
     fields.at(n).second = TyIdxFieldAttrPair(tyIdx, FieldAttrs());
+    FieldsChanged();
   }
 
   GStrIdx GetElemStrIdx(size_t n) const {
@@ -948,6 +1009,7 @@ class MIRStructType : public MIRType {
     isUsed = false;
     hasVolatileField = false;
     hasVolatileFieldSet = false;
+    FieldsChanged();
   }
 
   virtual const std::vector<MIRInfoPair> &GetInfo() const {
@@ -991,10 +1053,32 @@ class MIRStructType : public MIRType {
   }
 
   virtual FieldPair TraverseToFieldRef(FieldID &fieldID) const;
+  // the slots of the fields in FieldID order, built on the first lookup by FieldID and again once it is stale
+  const FlatFieldTable &GetFlatFields() const;
+  // owner is how the slots refer to this struct, TyIdx(0) when it is the one the table is built for
+  virtual void AppendFlatFields(FlatFieldTable &table, TyIdx owner) const;
+
+  // for the changes that may shift FieldIDs of some struct: adding or removing fields, changing the type
+  // of a field, changing the parent class and replacing a struct in the type table. The other changes
+  // show through the slots of the flat field tables. Called after the change, so that a table built
+  // while it was being made is stale.
+  static void FieldLayoutsChanged() {
+    (void)flatFieldsEpoch.fetch_add(1, std::memory_order_release);
+  }
+
+  // frees the flat field tables lookups no longer start in; only safe while no lookup is running
+  void ReleaseStaleFlatFields() const {
+    flatFields.ReleaseStale();
+  }
+
   std::string GetMplTypeName() const override;
   std::string GetCompactMplTypeName() const override;
 
  protected:
+  void FieldsChanged() {
+    FieldLayoutsChanged();
+  }
+
   FieldVector fields{};
   std::vector<TyIdx> fieldInferredTyIdx{};
   FieldVector staticFields{};
@@ -1014,6 +1098,9 @@ class MIRStructType : public MIRType {
   FieldPair TraverseToField(GStrIdx fieldStrIdx) const ;
   bool HasVolatileFieldInFields(const FieldVector &fieldsOfStruct) const;
   bool HasTypeParamInFields(const FieldVector &fieldsOfStruct) const;
+
+  static std::atomic<uint32> flatFieldsEpoch;
+  mutable FlatFieldTableCache flatFields;
 };
 
 // java array type, must not be nested inside another aggregate
@@ -1133,6 +1220,7 @@ class MIRClassType : public MIRStructType {
   }
   void SetParentTyIdx(TyIdx idx) {
     parentTyIdx = idx;
+    FieldsChanged();
   }
 
   std::vector<TyIdx> &GetInterfaceImplemented() {
@@ -1166,6 +1254,7 @@ class MIRClassType : public MIRStructType {
   bool HasVolatileField() const override;
   bool HasTypeParam() const override;
   FieldPair TraverseToFieldRef(FieldID &fieldID) const override;
+  void AppendFlatFields(FlatFieldTable &table, TyIdx owner) const override;
   size_t GetSize() const override;
 
   FieldID GetLastFieldID() const;
@@ -1193,6 +1282,7 @@ class MIRClassType : public MIRStructType {
     infoIsString.clear();
     pragmaVec.clear();
     staticValue.clear();
+    FieldsChanged();
   }
 
   size_t GetHashIndex() const override {
@@ -1294,6 +1384,7 @@ class MIRInterfaceType : public MIRStructType {
   bool HasVolatileField() const override;
   bool HasTypeParam() const override;
   FieldPair TraverseToFieldRef(FieldID &fieldID) const override;
+  void AppendFlatFields(FlatFieldTable&, TyIdx) const override {}
   void SetComplete() override {
     typeKind = kTypeInterface;
   }
@@ -1456,10 +1547,13 @@ class MIRFuncType : public MIRType {
   }
 
   size_t GetHashIndex() const override {
+    return GetHashIndexOf(retTyIdx, paramTypeList.size(), paramTypeList.empty() ? TyIdx(0) : paramTypeList[0]);
+  }
+
+  static size_t GetHashIndexOf(TyIdx retTyIdx, size_t paramNum, TyIdx firstParamTyIdx) {
     constexpr uint8 idxShift = 6;
-    size_t hIdx = (static_cast<size_t>(retTyIdx) << idxShift) + (typeKind << kShiftNumOfTypeKind);
-    size_t size = paramTypeList.size();
-    hIdx += (size ? (static_cast<size_t>(paramTypeList[0]) + size) : 0) << 4; // shift bit is 4
+    size_t hIdx = (static_cast<size_t>(retTyIdx) << idxShift) + (kTypeFunction << kShiftNumOfTypeKind);
+    hIdx += (paramNum ? (static_cast<size_t>(firstParamTyIdx) + paramNum) : 0) << 4; // shift bit is 4
     return hIdx % kTypeHashLength;
   }
 
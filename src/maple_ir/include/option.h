@@ -99,6 +99,8 @@ class Options : public MapleDriverOptionBase {
   static bool genIRProfile;
   static bool profileTest;
   static bool checkArrayStore;
+  static bool mpltSnapshot;
+  static bool parallelLex;
  private:
   void DecideMpl2MplRealLevel(const std::vector<mapleOption::Option> &inputOptions) const;
   std::vector<std::string> phaseSeq;
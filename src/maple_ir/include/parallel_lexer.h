@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_IR_INCLUDE_PARALLEL_LEXER_H
+#define MAPLE_IR_INCLUDE_PARALLEL_LEXER_H
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "lexer.h"
+
+namespace maple {
+// Lexes the rest of a MIR file on worker threads ahead of the parser. The file is read on the
+// parser's thread and cut into pieces at the lines starting a top-level func, which the workers
+// turn into token lists with lexers of their own. The parser still consumes the tokens in order
+// through MIRLexer::NextToken, which loads them into the lexer state it reads.
+// The workers only allocate from memory pools of their own, since the global memory pool
+// controller and tables are not thread safe.
+class MIRParallelLexer {
+ public:
+  // lexer has read the first line of its file, which the parallel lexer takes over
+  MIRParallelLexer(MIRModule &mod, MIRLexer &lexer, uint32 numThreads);
+  ~MIRParallelLexer();
+
+  TokenKind NextToken(MIRLexer &lexer);
+  // drop the remaining tokens of line lineNum, as MIRLexer does when it reads the next line
+  void SkipLine(uint32 lineNum);
+
+ private:
+  static constexpr size_t kMinLinesPerChunk = 1024;
+  static constexpr size_t kChunksAheadPerThread = 4;
+  static constexpr size_t kTokensPerLine = 6;
+
+  // a token with the lexer state the parser may read along with it
+  struct LexedToken {
+    TokenKind kind = TK_invalid;
+    uint32 lineNum = 0;
+    uint32 curIdx = 0;
+    int64 theIntVal = 0;
+    float theFloatVal = 0.0;
+    double theDoubleVal = 0.0;
+    std::string name;
+    std::vector<std::string> comments;  // the comments skipped before the token
+  };
+
+  struct Chunk {
+    uint32 firstLineNum = 0;
+    std::vector<std::string> lines;
+    std::vector<LexedToken> tokens;
+    std::vector<std::string> trailingComments;
+    bool lexed = false;
+  };
+
+  struct Worker {
+    MemPoolCtrler lexerMemPoolCtrler;
+    MemPool *memPool = nullptr;
+    std::unique_ptr<MapleAllocator> allocator;
+    std::unique_ptr<MIRLexer> lexer;
+    std::thread thread;
+  };
+
+  static bool IsFuncStart(const std::string &line);
+  bool ReadChunk();
+  void FillWindow();
+  std::unique_ptr<Chunk> NextChunk();
+  void WorkerMain(Worker &worker);
+  void LexChunk(MIRLexer &chunkLexer, Chunk &chunk) const;
+
+  std::ifstream &file;
+  std::string pendingLine;     // the first line of the next chunk
+  uint32 nextLineNum;          // the line number of pendingLine
+  bool atEof = false;
+  size_t maxChunksAhead;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::mutex mtx;
+  std::condition_variable chunkToLex;
+  std::condition_variable chunkLexed;
+  std::deque<std::unique_ptr<Chunk>> chunksAhead;  // in file order
+  std::deque<Chunk*> chunksToLex;
+  bool stopping = false;
+  std::unique_ptr<Chunk> curChunk;
+  size_t nextToken = 0;
+};
+}  // namespace maple
+#endif  // MAPLE_IR_INCLUDE_PARALLEL_LEXER_H
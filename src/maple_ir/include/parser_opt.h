@@ -24,6 +24,8 @@ enum ParserOptions : uint8 {
   kKeepFirst = 0x2,    // ignore second type def, not emit error
   kWithProfileInfo = 0x4,
   kParseOptFunc = 0x08,    // parse optimized function mpl file
+  kParseInParallel = 0x10,    // lex the mpl file on worker threads
+  kParseMpltSnapshot = 0x20,    // import text mplts through their snapshots when they are current
 };
 }  // namespace maple
 #endif  // MAPLE_IR_INCLUDE_PARSER_OPT_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_IR_INCLUDE_TRACE_EVENT_H
+#define MAPLE_IR_INCLUDE_TRACE_EVENT_H
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "types_def.h"
+
+namespace maple {
+// Records compile-time events of all phase managers and writes them as a Chrome trace-event
+// JSON file (chrome://tracing, Perfetto). Recording is off unless Enable() is called.
+class TraceEventRecorder {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  static TraceEventRecorder &GetInstance();
+
+  static bool IsEnabled() {
+    return GetInstance().enabled.load(std::memory_order_relaxed);
+  }
+
+  void Enable(const std::string &fileName);
+  // category: the emitting tool or manager; name: the phase; unit: the function or module worked on
+  void AddCompleteEvent(const std::string &category, const std::string &name, const std::string &unit,
+                        Clock::time_point begin, Clock::time_point end, size_t memPoolBytes = 0);
+  // write out all events recorded so far, called at exit if nobody did before
+  void Flush();
+
+ private:
+  struct TraceEvent {
+    std::string category;
+    std::string name;
+    std::string unit;
+    int64 beginUs;
+    int64 durationUs;
+    size_t memPoolBytes;
+    uint32 tid;
+  };
+
+  TraceEventRecorder() = default;
+  ~TraceEventRecorder();
+  uint32 GetThreadIndex();
+
+  std::atomic<bool> enabled{ false };
+  std::mutex eventMutex;
+  std::string traceFileName;
+  Clock::time_point origin;
+  std::vector<TraceEvent> events;
+  std::map<std::thread::id, uint32> threadIndexes;
+};
+
+// Records the lifetime of the scope as one event.
+class TraceScope {
+ public:
+  TraceScope(const std::string &category, const std::string &name, const std::string &unit = "")
+      : enabled(TraceEventRecorder::IsEnabled()) {
+    if (enabled) {
+      this->category = category;
+      this->name = name;
+      this->unit = unit;
+      begin = TraceEventRecorder::Clock::now();
+    }
+  }
+
+  ~TraceScope() {
+    if (enabled) {
+      TraceEventRecorder::GetInstance().AddCompleteEvent(category, name, unit, begin,
+                                                         TraceEventRecorder::Clock::now(), memPoolBytes);
+    }
+  }
+
+  void SetMemPoolBytes(size_t bytes) {
+    memPoolBytes = bytes;
+  }
+
+ private:
+  bool enabled;
+  std::string category;
+  std::string name;
+  std::string unit;
+  TraceEventRecorder::Clock::time_point begin;
+  size_t memPoolBytes = 0;
+};
+}  // namespace maple
+#endif  // MAPLE_IR_INCLUDE_TRACE_EVENT_H
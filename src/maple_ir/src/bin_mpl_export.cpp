@@ -15,6 +15,10 @@
 #include "bin_mpl_export.h"
 #include <sstream>
 #include <vector>
+#include <unordered_set>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "mir_function.h"
 #include "namemangler.h"
 #include "opcode_info.h"
@@ -318,14 +322,13 @@ void BinaryMplExport::Write(uint8 b) {
 
 // Little endian
 void BinaryMplExport::WriteInt(int32 x) {
-  Write(static_cast<uint8>(static_cast<uint32>(x) & 0xFF));
-  Write(static_cast<uint8>((static_cast<uint32>(x) >> 8) & 0xFF));
-  Write(static_cast<uint8>((static_cast<uint32>(x) >> 16) & 0xFF));
-  Write(static_cast<uint8>((static_cast<uint32>(x) >> 24) & 0xFF));
+  size_t i = buf.size();
+  ExpandFourBuffSize();
+  Fixup(i, x);
 }
 
 void BinaryMplExport::ExpandFourBuffSize() {
-  WriteInt(0);
+  buf.resize(buf.size() + sizeof(int32), 0);
 }
 
 void BinaryMplExport::Fixup(size_t i, int32 x) {
@@ -342,21 +345,35 @@ void BinaryMplExport::WriteInt64(int64 x) {
 
 // LEB128
 void BinaryMplExport::WriteNum(int64 x) {
+  // an int64 takes at most 10 bytes of 7 bits, appended to buf at once
+  constexpr size_t maxBytes = 10;
+  uint8 bytes[maxBytes];
+  size_t n = 0;
   while (x < -0x40 || x >= 0x40) {
-    Write(static_cast<uint8>((static_cast<uint64>(x) & 0x7F) + 0x80));
+    bytes[n++] = static_cast<uint8>((static_cast<uint64>(x) & 0x7F) + 0x80);
     x = x >> 7; // This is a compress algorithm, do not cast int64 to uint64. If do so, small negtivate number like -3
                 // will occupy 9 bits and we will not get the compressed benefit.
   }
-  Write(static_cast<uint8>(static_cast<uint64>(x) & 0x7F));
+  bytes[n++] = static_cast<uint8>(static_cast<uint64>(x) & 0x7F);
+  buf.insert(buf.end(), bytes, bytes + n);
 }
 
 void BinaryMplExport::WriteAsciiStr(const std::string &str) {
-  for (size_t i = 0; i < str.size(); ++i) {
-    Write(static_cast<uint8>(str[i]));
-  }
+  buf.insert(buf.end(), str.begin(), str.end());
   Write(0);
 }
 
+bool GetMpltStamp(const std::string &mpltName, MpltStamp &stamp) {
+  struct stat fileStat;
+  if (stat(mpltName.c_str(), &fileStat) != 0) {
+    return false;
+  }
+  constexpr int64 nsPerSecond = 1000000000;
+  stamp.size = static_cast<int64>(fileStat.st_size);
+  stamp.mtime = static_cast<int64>(fileStat.st_mtim.tv_sec) * nsPerSecond + fileStat.st_mtim.tv_nsec;
+  return true;
+}
+
 void BinaryMplExport::DumpBuf(const std::string &name) {
   FILE *f = fopen(name.c_str(), "wb");
   if (f == nullptr) {
@@ -626,7 +643,7 @@ void BinaryMplExport::OutputFunction(PUIdx puIdx) {
   mod.SetCurFunction(savedFunc);
 }
 
-void BinaryMplExport::WriteStrField(uint64 contentIdx) {
+void BinaryMplExport::WriteStrField(uint64 contentIdx, bool withImportedLiterals) {
   Fixup(contentIdx, buf.size());
   WriteNum(kBinStrStart);
   size_t totalSizeIdx = buf.size();
@@ -642,6 +659,12 @@ void BinaryMplExport::WriteStrField(uint64 contentIdx) {
       ++size;
     }
   }
+  if (withImportedLiterals) {
+    for (GStrIdx strIdx : GlobalTables::GetConstPool().GetImportedLiteralNames()) {
+      OutputStr(strIdx);
+      ++size;
+    }
+  }
   Fixup(totalSizeIdx, buf.size() - totalSizeIdx);
   Fixup(outStrSizeIdx, size);
   WriteNum(~kBinStrStart);
@@ -709,6 +732,77 @@ void BinaryMplExport::Export(const std::string &fname) {
   DumpBuf(fname);
 }
 
+// true if WriteTypeField writes every type the module has a name for and every global symbol the
+// module declares, so that a snapshot of the module loads as what the text parse created.
+// Global symbols only come back as the methods of the classes written, so a text mplt declaring
+// global variables or free functions is not snapshotted.
+bool BinaryMplExport::IsSnapshotComplete() {
+  std::unordered_set<uint32> methodStIdxs;
+  for (auto &nameTyIdx : mod.GetTypeNameTab()->GetGStrIdxToTyIdxMap()) {
+    MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(nameTyIdx.second);
+    if (type == nullptr || (type->GetKind() != kTypeClass && type->GetKind() != kTypeInterface) ||
+        static_cast<MIRStructType*>(type)->IsImported() ||
+        mod.GetClassList().find(nameTyIdx.second.GetIdx()) == mod.GetClassList().end()) {
+      return false;
+    }
+    for (const MethodPair &method : static_cast<MIRStructType*>(type)->GetMethods()) {
+      (void)methodStIdxs.insert(method.first.Idx());
+    }
+  }
+  // index 0 of the global symbol table is a dummy
+  for (size_t i = 1; i < GlobalTables::GetGsymTable().GetSymbolTableSize(); ++i) {
+    MIRSymbol *symbol = GlobalTables::GetGsymTable().GetSymbolFromStidx(static_cast<uint32>(i));
+    if (symbol == nullptr) {
+      continue;
+    }
+    if (symbol->GetSKind() != kStFunc || methodStIdxs.find(symbol->GetStIdx().Idx()) == methodStIdxs.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Write the types of the module and the literal names it imported as a snapshot of the text mplt
+// mpltName, which BinaryMplImport::ImportSnapshot loads until mpltName changes.
+// Only meaningful when nothing but mpltName has been loaded into the module. No snapshot is written
+// when the module holds types or global symbols the binary mplt leaves out.
+bool BinaryMplExport::ExportSnapshot(const std::string &mpltName) {
+  MpltStamp stamp;
+  if (!IsSnapshotComplete() || !GetMpltStamp(mpltName, stamp)) {
+    return false;
+  }
+  constexpr int fieldNum = 3;
+  uint64 fieldStartPoint[fieldNum];
+  WriteInt(kMpltMagicNumber);
+  WriteContentField(fieldNum, fieldStartPoint);
+  WriteStrField(fieldStartPoint[0], true);
+  WriteTypeField(fieldStartPoint[1]);
+  WriteNum(kBinFinish);
+  // the offsets in the content field stay relative to the binary mplt
+  std::vector<uint8> mplt;
+  mplt.swap(buf);
+  WriteInt(kMpltSnapshotMagicNumber);
+  WriteInt(kMpltSnapshotVersion);
+  WriteInt64(stamp.size);
+  WriteInt64(stamp.mtime);
+  buf.insert(buf.end(), mplt.begin(), mplt.end());
+  // concurrent compilations may load the same mplt, so the snapshot appears under its name complete or not at all
+  std::string snapshotName = GetMpltSnapshotName(mpltName);
+  std::string tmpName = snapshotName + "." + std::to_string(getpid());
+  FILE *f = fopen(tmpName.c_str(), "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  size_t size = buf.size();
+  bool written = fwrite(&buf[0], sizeof(uint8), size, f) == size;
+  written = (fclose(f) == 0) && written;
+  if (!written || rename(tmpName.c_str(), snapshotName.c_str()) != 0) {
+    (void)remove(tmpName.c_str());
+    return false;
+  }
+  return true;
+}
+
 void BinaryMplExport::AppendAt(const std::string &name, int32 offset) {
   FILE *f = fopen(name.c_str(), "r+b");
   if (f == nullptr) {
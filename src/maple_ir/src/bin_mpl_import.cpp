@@ -13,10 +13,14 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "bin_mpl_import.h"
-#include <sstream>
 #include <vector>
 #include <unordered_set>
 #include <limits>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "bin_mpl_export.h"
 #include "mir_function.h"
 #include "namemangler.h"
@@ -26,16 +30,19 @@
 
 namespace maple {
 uint8 BinaryMplImport::Read() {
-  CHECK_FATAL(bufI < buf.size(), "Index out of bound in BinaryMplImport::Read()");
+  CHECK_FATAL(bufI < bufSize, "Index out of bound in BinaryMplImport::Read()");
   return buf[bufI++];
 }
 
 // Little endian
 int32 BinaryMplImport::ReadInt() {
-  uint32 x0 = static_cast<uint32>(Read());
-  uint32 x1 = static_cast<uint32>(Read());
-  uint32 x2 = static_cast<uint32>(Read());
-  uint32 x3 = static_cast<uint32>(Read());
+  CHECK_FATAL(bufSize - bufI >= sizeof(int32) && bufI <= bufSize, "Index out of bound in BinaryMplImport::ReadInt()");
+  const uint8 *p = buf + bufI;
+  bufI += sizeof(int32);
+  uint32 x0 = static_cast<uint32>(p[0]);
+  uint32 x1 = static_cast<uint32>(p[1]);
+  uint32 x2 = static_cast<uint32>(p[2]);
+  uint32 x3 = static_cast<uint32>(p[3]);
   return (((((x3 << 8u) + x2) << 8u) + x1) << 8u) + x0;
 }
 
@@ -50,45 +57,59 @@ int64 BinaryMplImport::ReadInt64() {
 int64 BinaryMplImport::ReadNum() {
   uint64 n = 0;
   int64 y = 0;
-  uint64 b = static_cast<uint64>(Read());
+  const uint8 *p = buf + bufI;
+  const uint8 *end = buf + bufSize;
+  CHECK_FATAL(p < end, "Index out of bound in BinaryMplImport::ReadNum()");
+  uint64 b = static_cast<uint64>(*p++);
   while (b >= 0x80) {
     y += ((b - 0x80) << n);
     n += 7;
-    b = static_cast<uint64>(Read());
+    CHECK_FATAL(p < end, "Index out of bound in BinaryMplImport::ReadNum()");
+    b = static_cast<uint64>(*p++);
   }
+  bufI = static_cast<uint64>(p - buf);
   b = (b & 0x3F) - (b & 0x40);
   return y + (b << n);
 }
 
 void BinaryMplImport::ReadAsciiStr(std::string &str) {
-  uint8 ch = Read();
-  std::ostringstream strStream(str);
-  while (ch != '\0') {
-    strStream << ch;
-    ch = Read();
-  }
-  str = strStream.str();
+  CHECK_FATAL(bufI < bufSize, "Index out of bound in BinaryMplImport::ReadAsciiStr()");
+  const auto *start = reinterpret_cast<const char*>(buf + bufI);
+  const void *nul = memchr(start, '\0', bufSize - bufI);
+  CHECK_FATAL(nul != nullptr, "unterminated string in BinaryMplImport::ReadAsciiStr()");
+  size_t len = static_cast<size_t>(static_cast<const char*>(nul) - start);
+  str.assign(start, len);
+  bufI += len + 1;
 }
 
 void BinaryMplImport::ReadFileAt(const std::string &name, int32 offset) {
-  FILE *f = fopen(name.c_str(), "rb");
-  CHECK_FATAL(f != nullptr, "Error while reading the binary file: %s", name.c_str());
-
-  int seekRet = fseek(f, 0, SEEK_END);
-  CHECK_FATAL(seekRet == 0, "call fseek failed");
-
-  long size = ftell(f);
-  size -= offset;
-
-  CHECK_FATAL(size >= 0, "should not be negative");
-
-  seekRet = fseek(f, offset, SEEK_SET);
-  CHECK_FATAL(seekRet == 0, "call fseek failed");
-  buf.resize(size);
-
-  size_t result = fread(&buf[0], sizeof(uint8), static_cast<size_t>(size), f);
-  fclose(f);
-  CHECK_FATAL(result == static_cast<size_t>(size), "Error while reading the binary file: %s", name.c_str());
+  UnmapFile();
+  int fd = open(name.c_str(), O_RDONLY);
+  CHECK_FATAL(fd >= 0, "Error while reading the binary file: %s", name.c_str());
+  struct stat fileStat;
+  CHECK_FATAL(fstat(fd, &fileStat) == 0, "call fstat failed");
+  size_t size = static_cast<size_t>(fileStat.st_size);
+  CHECK_FATAL(offset >= 0 && static_cast<size_t>(offset) <= size, "should not be negative");
+  if (size != 0) {
+    // only the pages read are loaded, so checking the magic number of a text mplt costs one page
+    mappedFile = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHECK_FATAL(mappedFile != MAP_FAILED, "Error while reading the binary file: %s", name.c_str());
+    mappedSize = size;
+    buf = static_cast<const uint8*>(mappedFile) + offset;
+    bufSize = size - static_cast<size_t>(offset);
+  }
+  // the mapping outlives the descriptor
+  CHECK_FATAL(close(fd) == 0, "call close failed");
+}
+
+void BinaryMplImport::UnmapFile() {
+  if (mappedFile != nullptr) {
+    CHECK_FATAL(munmap(mappedFile, mappedSize) == 0, "call munmap failed");
+  }
+  mappedFile = nullptr;
+  mappedSize = 0;
+  buf = nullptr;
+  bufSize = 0;
 }
 
 void BinaryMplImport::ImportConstBase(MIRConstKind &kind, MIRTypePtr &type, uint32 &fieldID) {
@@ -139,12 +160,11 @@ MIRConst *BinaryMplImport::ImportConst(MIRFunction *func) {
       cs = memPool->New<Conststr16Node>();
       cs->SetPrimType(type->GetPrimType());
       int64 len = ReadNum();
-      std::ostringstream ostr;
-      for (int64 i = 0; i < len; ++i) {
-        ostr << Read();
-      }
+      CHECK_FATAL(len >= 0 && static_cast<uint64>(len) <= bufSize - bufI, "Index out of bound in ImportConst");
+      std::string str(reinterpret_cast<const char*>(buf + bufI), static_cast<size_t>(len));
+      bufI += static_cast<uint64>(len);
       std::u16string str16;
-      NameMangler::UTF8ToUTF16(str16, ostr.str());
+      NameMangler::UTF8ToUTF16(str16, str);
       cs->SetStrIdx(GlobalTables::GetU16StrTable().GetOrCreateStrIdxFromName(str16));
       return memPool->New<MIRStr16Const>(cs->GetStrIdx(), *type);
     }
@@ -357,6 +377,7 @@ void BinaryMplImport::ImportStructTypeData(MIRStructType &type) {
   ImportFieldsOfStructType(type.GetStaticFields(), methodSize);
   ImportFieldsOfStructType(type.GetParentFields(), methodSize);
   ImportMethodsOfStructType(type.GetMethods());
+  MIRStructType::FieldLayoutsChanged();
   type.SetIsImported(imported);
 }
 
@@ -444,7 +465,7 @@ void BinaryMplImport::ImportInterfaceTypeData(MIRInterfaceType &type) {
 }
 
 void BinaryMplImport::Reset() {
-  buf.clear();
+  UnmapFile();
   bufI = 0;
   gStrTab.clear();
   uStrTab.clear();
@@ -885,9 +906,39 @@ void BinaryMplImport::Jump2NextField() {
 bool BinaryMplImport::Import(const std::string &fname, bool readSymbols, bool readSe) {
   Reset();
   ReadFileAt(fname, 0);
-  int32 magic = ReadInt();
-  if (kMpltMagicNumber != magic) {  // not a binary mplt file
-    buf.clear();
+  return ReadMplt();
+}
+
+// Load the snapshot BinaryMplExport::ExportSnapshot took of the text mplt mpltName, if it is still
+// up to date. Its contents are imported the way MIRParser would have parsed mpltName.
+bool BinaryMplImport::ImportSnapshot(const std::string &mpltName) {
+  MpltStamp stamp;
+  std::string snapshotName = GetMpltSnapshotName(mpltName);
+  if (!GetMpltStamp(mpltName, stamp) || access(snapshotName.c_str(), R_OK) != 0) {
+    return false;
+  }
+  Reset();
+  ReadFileAt(snapshotName, 0);
+  constexpr size_t headerSize = sizeof(int32) + sizeof(int32) + sizeof(int64) + sizeof(int64);
+  if (bufSize < headerSize || ReadInt() != kMpltSnapshotMagicNumber || ReadInt() != kMpltSnapshotVersion ||
+      ReadInt64() != stamp.size || ReadInt64() != stamp.mtime) {
+    UnmapFile();
+    return false;
+  }
+  // the offsets in the binary mplt are relative to its start
+  buf += bufI;
+  bufSize -= bufI;
+  bufI = 0;
+  bool importedSave = imported;
+  imported = false;
+  bool success = ReadMplt();
+  imported = importedSave;
+  return success;
+}
+
+bool BinaryMplImport::ReadMplt() {
+  if (bufSize < sizeof(int32) || ReadInt() != kMpltMagicNumber) {  // not a binary mplt file
+    UnmapFile();
     return false;
   }
   int64 fieldID = ReadNum();
@@ -41,9 +41,12 @@ int main(int argc, char **argv) {
   constexpr int judgeNumber = 2;
   if (argc < judgeNumber) {
     MIR_PRINTF(
-        "usage: ./irbuild [i|e] <any number of mpl files>\n\n"
+        "usage: ./irbuild [i|e|p|s] <any number of mpl files>\n\n"
         "The optional 'i' flag will convert the binary mplt input file to ascii\n\n"
-        "The optional 'e' flag will convert the textual mplt input file to binary\n");
+        "The optional 'e' flag will convert the textual mplt input file to binary\n\n"
+        "The optional 'p' flag will lex the mpl input files on worker threads\n\n"
+        "The optional 's' flag will load the textual mplt input file through its snapshot, taking one if\n"
+        "there is no current snapshot, and convert it to ascii\n");
     exit(1);
   }
   char flag = '\0';
@@ -54,12 +57,18 @@ int main(int argc, char **argv) {
   } else if (argv[1][0] == 'e' && argv[1][1] == '\0') {
     flag = 'e';
     i = judgeNumber;
+  } else if (argv[1][0] == 'p' && argv[1][1] == '\0') {
+    flag = 'p';
+    i = judgeNumber;
+  } else if (argv[1][0] == 's' && argv[1][1] == '\0') {
+    flag = 's';
+    i = judgeNumber;
   }
   while (i < argc) {
     MIRModule module{ argv[i] };
-    if (flag == '\0') {
+    if (flag == '\0' || flag == 'p') {
       MIRParser theParser(module);
-      if (theParser.ParseMIR()) {
+      if (theParser.ParseMIR(0, (flag == 'p') ? kParseInParallel : 0)) {
         ConstantFoldModule(module);
         module.OutputAsciiMpl(".irb");
       } else {
@@ -85,6 +94,22 @@ int main(int argc, char **argv) {
       const std::string &modID = module.GetFileName();
       binMplt.Import(modID, true);
       module.OutputAsciiMpl(".irb");
+    } else if (flag == 's') {
+      module.SetFlavor(kFeProduced);
+      module.SetSrcLang(kSrcLangJava);
+      BinaryMplt binMplt(module);
+      const std::string &modID = module.GetFileName();
+      if (!binMplt.ImportSnapshot(modID)) {
+        std::ifstream mpltFile(modID);
+        MIRParser theParser(module);
+        if (!mpltFile.is_open() || !theParser.ParseMPLTStandalone(mpltFile, modID)) {
+          theParser.EmitError(modID);
+          return 1;
+        }
+        mpltFile.close();
+        (void)binMplt.ExportSnapshot(modID);
+      }
+      module.OutputAsciiMpl(".irb");
     }
     ++i;
   }
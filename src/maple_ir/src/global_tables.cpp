@@ -15,6 +15,8 @@
 #include "global_tables.h"
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <array>
 #include "mir_type.h"
 #include "mir_symbol.h"
 
@@ -42,12 +44,30 @@ TypeTable::TypeTable() {
   }
 }
 
+void TypeTable::ReleaseStaleFlatFieldTables() const {
+  for (MIRType *type : typeTable) {
+    if (type != nullptr && type->IsStructType()) {
+      static_cast<MIRStructType*>(type)->ReleaseStaleFlatFields();
+    }
+  }
+}
+
 void TypeTable::SetTypeWithTyIdx(const TyIdx &tyIdx, MIRType &type) {
   CHECK_FATAL(tyIdx < typeTable.size(), "array index out of range");
   MIRType *oldType = typeTable.at(tyIdx);
   typeTable.at(tyIdx) = &type;
   if (oldType != nullptr && oldType != &type) {
-    (void)typeHashTable.erase(oldType);
+    if (oldType->IsStructType()) {
+      // the flat field tables of the structs embedding or deriving from it see the new fields
+      MIRStructType::FieldLayoutsChanged();
+    }
+    auto range = typeHashTable.equal_range(oldType->GetHashIndex());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == oldType) {
+        (void)typeHashTable.erase(it);
+        break;
+      }
+    }
     delete oldType;
   }
 }
@@ -60,13 +80,15 @@ TypeTable::~TypeTable() {
 }
 
 void TypeTable::PutToHashTable(MIRType *mirType) {
-  typeHashTable.insert(mirType);
+  (void)typeHashTable.emplace(mirType->GetHashIndex(), mirType);
 }
 
 TyIdx TypeTable::GetOrCreateMIRType(MIRType *pType) {
-  const auto it = typeHashTable.find(pType);
-  if (it != typeHashTable.end()) {
-    return (*it)->GetTypeIndex();
+  MIRType *type = FindType(pType->GetHashIndex(), [pType](const MIRType &candidate) {
+    return pType->EqualTo(candidate);
+  });
+  if (type != nullptr) {
+    return type->GetTypeIndex();
   }
 
   MIRType *newTy = CreateType(*pType);
@@ -77,10 +99,16 @@ TyIdx TypeTable::GetOrCreateMIRType(MIRType *pType) {
 MIRType *TypeTable::voidPtrType = nullptr;
 // get or create a type that pointing to pointedTyIdx
 MIRType *TypeTable::GetOrCreatePointerType(TyIdx pointedTyIdx, PrimType primType) {
-  MIRPtrType type(pointedTyIdx, primType);
-  TyIdx tyIdx = GetOrCreateMIRType(&type);
-  ASSERT(tyIdx < typeTable.size(), "index out of range in TypeTable::GetOrCreatePointerType");
-  return typeTable.at(tyIdx);
+  size_t hashIndex = MIRPtrType::GetHashIndexOf(pointedTyIdx);
+  MIRType *type = FindType(hashIndex, [pointedTyIdx, primType](const MIRType &candidate) {
+    return candidate.GetKind() == kTypePointer && candidate.GetPrimType() == primType &&
+           static_cast<const MIRPtrType&>(candidate).GetPointedTyIdx() == pointedTyIdx;
+  });
+  if (type == nullptr) {
+    type = CreateType(MIRPtrType(pointedTyIdx, primType));
+    PutToHashTable(type);
+  }
+  return type;
 }
 
 MIRType *TypeTable::GetOrCreatePointerType(const MIRType &pointTo, PrimType primType) {
@@ -102,13 +130,33 @@ MIRType *TypeTable::GetPointedTypeIfApplicable(MIRType &type) {
 }
 
 MIRArrayType *TypeTable::GetOrCreateArrayType(const MIRType &elem, uint8 dim, const uint32 *sizeArray) {
-  std::vector<uint32> sizeVector;
-  for (size_t i = 0; i < dim; ++i) {
-    sizeVector.push_back(sizeArray != nullptr ? sizeArray[i] : 0);
+  CHECK_FATAL(dim <= kMaxArrayDim, "array index out of range");
+  std::array<uint32, kMaxArrayDim> sizes{ 0 };
+  if (sizeArray != nullptr) {
+    std::copy(sizeArray, sizeArray + dim, sizes.begin());
+  }
+  TyIdx elemTyIdx = elem.GetTypeIndex();
+  size_t hashIndex = MIRArrayType::GetHashIndexOf(elemTyIdx, dim, sizes.data());
+  MIRType *type = FindType(hashIndex, [elemTyIdx, dim, &sizes](const MIRType &candidate) {
+    if (candidate.GetKind() != kTypeArray) {
+      return false;
+    }
+    const auto &arrayType = static_cast<const MIRArrayType&>(candidate);
+    if (arrayType.GetElemTyIdx() != elemTyIdx || arrayType.GetDim() != dim) {
+      return false;
+    }
+    for (uint8 i = 0; i < dim; ++i) {
+      if (arrayType.GetSizeArrayItem(i) != sizes[i]) {
+        return false;
+      }
+    }
+    return true;
+  });
+  if (type == nullptr) {
+    type = CreateType(MIRArrayType(elemTyIdx, std::vector<uint32>(sizes.begin(), sizes.begin() + dim)));
+    PutToHashTable(type);
   }
-  MIRArrayType arrayType(elem.GetTypeIndex(), sizeVector);
-  TyIdx tyIdx = GetOrCreateMIRType(&arrayType);
-  return static_cast<MIRArrayType*>(typeTable[tyIdx]);
+  return static_cast<MIRArrayType*>(type);
 }
 
 // For one dimension array
@@ -116,32 +164,58 @@ MIRArrayType *TypeTable::GetOrCreateArrayType(const MIRType &elem, uint32 size)
   return GetOrCreateArrayType(elem, 1, &size);
 }
 
+// kind is kTypeFArray or kTypeJArray
+MIRType *TypeTable::FindFarrayType(MIRTypeKind kind, TyIdx elemTyIdx) const {
+  return FindType(MIRFarrayType::GetHashIndexOf(kind, elemTyIdx), [kind, elemTyIdx](const MIRType &candidate) {
+    return candidate.GetKind() == kind && static_cast<const MIRFarrayType&>(candidate).GetElemTyIdx() == elemTyIdx;
+  });
+}
+
 MIRType *TypeTable::GetOrCreateFarrayType(const MIRType &elem) {
-  MIRFarrayType type;
-  type.SetElemtTyIdx(elem.GetTypeIndex());
-  TyIdx tyIdx = GetOrCreateMIRType(&type);
-  ASSERT(tyIdx < typeTable.size(), "index out of range in TypeTable::GetOrCreateFarrayType");
-  return typeTable.at(tyIdx);
+  MIRType *type = FindFarrayType(kTypeFArray, elem.GetTypeIndex());
+  if (type == nullptr) {
+    type = CreateType(MIRFarrayType(elem.GetTypeIndex()));
+    PutToHashTable(type);
+  }
+  return type;
 }
 
 MIRType *TypeTable::GetOrCreateJarrayType(const MIRType &elem) {
-  MIRJarrayType type;
-  type.SetElemtTyIdx(elem.GetTypeIndex());
-  TyIdx tyIdx = GetOrCreateMIRType(&type);
-  ASSERT(tyIdx < typeTable.size(), "index out of range in TypeTable::GetOrCreateJarrayType");
-  return typeTable.at(tyIdx);
+  MIRType *type = FindFarrayType(kTypeJArray, elem.GetTypeIndex());
+  if (type == nullptr) {
+    type = CreateType(MIRJarrayType(elem.GetTypeIndex()));
+    PutToHashTable(type);
+  }
+  return type;
 }
 
 MIRType *TypeTable::GetOrCreateFunctionType(MIRModule &module, TyIdx retTyIdx, const std::vector<TyIdx> &vecType,
                                             const std::vector<TypeAttrs> &vecAttrs, bool isVarg, bool isSimpCreate) {
-  auto *funcType = module.GetMemPool()->New<MIRFuncType>(retTyIdx, vecType, vecAttrs, module.GetMPAllocator());
-  funcType->SetVarArgs(isVarg);
   if (isSimpCreate) {
+    auto *funcType = module.GetMemPool()->New<MIRFuncType>(retTyIdx, vecType, vecAttrs, module.GetMPAllocator());
+    funcType->SetVarArgs(isVarg);
     return funcType;
   }
-  TyIdx tyIdx = GetOrCreateMIRType(funcType);
-  ASSERT(tyIdx < typeTable.size(), "index out of range in TypeTable::GetOrCreateFunctionType");
-  return typeTable.at(tyIdx);
+  size_t hashIndex = MIRFuncType::GetHashIndexOf(retTyIdx, vecType.size(), vecType.empty() ? TyIdx(0) : vecType[0]);
+  MIRType *type = FindType(hashIndex, [retTyIdx, &vecType, &vecAttrs, isVarg](const MIRType &candidate) {
+    if (candidate.GetKind() != kTypeFunction) {
+      return false;
+    }
+    const auto &funcType = static_cast<const MIRFuncType&>(candidate);
+    const MapleVector<TyIdx> &paramTypes = funcType.GetParamTypeList();
+    const MapleVector<TypeAttrs> &paramAttrs = funcType.GetParamAttrsList();
+    return funcType.GetRetTyIdx() == retTyIdx && funcType.IsVarargs() == isVarg &&
+           paramTypes.size() == vecType.size() && std::equal(paramTypes.begin(), paramTypes.end(), vecType.begin()) &&
+           paramAttrs.size() == vecAttrs.size() && std::equal(paramAttrs.begin(), paramAttrs.end(), vecAttrs.begin());
+  });
+  if (type == nullptr) {
+    // the new type is the entry itself, no copy is made
+    auto *funcType = new MIRFuncType(retTyIdx, vecType, vecAttrs, module.GetMPAllocator());
+    funcType->SetVarArgs(isVarg);
+    type = AddType(*funcType);
+    PutToHashTable(type);
+  }
+  return type;
 }
 
 MIRType *TypeTable::GetOrCreateStructOrUnion(const std::string &name, const FieldVector &fields,
@@ -188,7 +262,7 @@ void TypeTable::AddFieldToStructType(MIRStructType &structType, const std::strin
   GStrIdx strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName(fieldName);
   FieldAttrs fieldAttrs;
   fieldAttrs.SetAttr(FLDATTR_final);  // Mark compiler-generated struct fields as final to improve AliasAnalysis
-  structType.GetFields().push_back(FieldPair(strIdx, TyIdxFieldAttrPair(fieldType.GetTypeIndex(), fieldAttrs)));
+  structType.PushbackField(FieldPair(strIdx, TyIdxFieldAttrPair(fieldType.GetTypeIndex(), fieldAttrs)));
 }
 
 void FPConstTable::PostInit() {
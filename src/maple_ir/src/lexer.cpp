@@ -18,6 +18,7 @@
 #include <cstdlib>
 #include "mpl_logging.h"
 #include "mir_module.h"
+#include "parallel_lexer.h"
 #include "securec.h"
 #include "utils.h"
 
@@ -39,6 +40,17 @@ static uint8 Char2num(char c) {
 // if EOF, return -1.
 // The trailing new-line character has been removed.
 int MIRLexer::ReadALine() {
+  if (lineBuffer != nullptr) {
+    curIdx = 0;
+    if (nextLineInBuffer == lineBuffer->size()) {
+      line = "";
+      currentLineSize = 0;
+      return -1;
+    }
+    line = std::move((*lineBuffer)[nextLineInBuffer++]);
+    currentLineSize = line.length();
+    return currentLineSize;
+  }
   if (airFile == nullptr) {
     line = "";
     return -1;
@@ -57,10 +69,12 @@ int MIRLexer::ReadALine() {
   return currentLineSize;
 }
 
-MIRLexer::MIRLexer(MIRModule &mod)
+MIRLexer::MIRLexer(MIRModule &mod) : MIRLexer(mod, mod.GetMPAllocator()) {}
+
+MIRLexer::MIRLexer(MIRModule &mod, MapleAllocator &allocator)
     : module(mod),
-      seenComments(mod.GetMPAllocator().Adapter()),
-      keywordMap(mod.GetMPAllocator().Adapter()) {
+      seenComments(allocator.Adapter()),
+      keywordMap(allocator.Adapter()) {
   // initialize keywordMap
   keywordMap.clear();
 #define KEYWORD(STR)            \
@@ -497,7 +511,8 @@ TokenKind MIRLexer::GetTokenSpecial() {
   char c = GetCharAtWithLowerCheck(curIdx);
   if (utils::IsAlpha(c) || c < 0 || c == '_') {
     GenName();
-    TokenKind tk = keywordMap[name];
+    auto it = keywordMap.find(name);
+    TokenKind tk = it == keywordMap.end() ? TK_invalid : it->second;
     switch (tk) {
       case TK_nanf:
         theFloatVal = NAN;
@@ -611,7 +626,7 @@ TokenKind MIRLexer::LexToken() {
 }
 
 TokenKind MIRLexer::NextToken() {
-  kind = LexToken();
+  kind = parallelLexer != nullptr ? parallelLexer->NextToken(*this) : LexToken();
   return kind;
 }
 
@@ -527,4 +527,13 @@ void MIRFunction::ResetGDBEnv() {
   memPoolCtrler.DeleteMemPool(codeMemPool);
   codeMemPool = nullptr;
 }
+
+void MIRFunction::ReleaseCodeMemory() {
+  if (codeMemPool != nullptr) {
+    memPoolCtrler.DeleteMemPool(codeMemPool);
+    codeMemPool = nullptr;
+    codeMemPoolAllocator.SetMemPool(nullptr);
+  }
+  SetBody(nullptr);
+}
 }  // namespace maple
@@ -50,7 +50,8 @@ MIRModule::MIRModule(const std::string &fn)
       importPaths(memPoolAllocator.Adapter()),
       classList(memPoolAllocator.Adapter()),
       optimizedFuncs(memPoolAllocator.Adapter()),
-      puIdxFieldInitializedMap(std::less<PUIdx>(), memPoolAllocator.Adapter()) {
+      puIdxFieldInitializedMap(std::less<PUIdx>(), memPoolAllocator.Adapter()),
+      puIdxParamEscapeMap(std::less<PUIdx>(), memPoolAllocator.Adapter()) {
   GlobalTables::GetGsymTable().SetModule(this);
   typeNameTab = memPool->New<MIRTypeNameTable>(memPoolAllocator);
   mirBuilder = memPool->New<MIRBuilder>(this);
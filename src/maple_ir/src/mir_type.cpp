@@ -15,6 +15,7 @@
 #include "mir_type.h"
 #include <iostream>
 #include <cstring>
+#include <mutex>
 #include "mir_symbol.h"
 #include "printing.h"
 #include "namemangler.h"
@@ -1263,7 +1264,85 @@ FieldPair MIRStructType::TraverseToFieldRef(FieldID &fieldID) const {
   return curPair;
 }
 
+std::atomic<uint32> MIRStructType::flatFieldsEpoch(0);
+// tables are built rarely, so one lock serves all struct types
+static std::mutex flatFieldsMutex;
+
+const FlatFieldTable &FlatFieldTableCache::Publish(std::unique_ptr<FlatFieldTable> table) {
+  const FlatFieldTable *old = GetCurrent();
+  if (old != nullptr && old->slots == table->slots) {
+    // most epochs move on for other structs, so keep the table a lookup may still be running in
+    FlatFieldTable *same = tables.back().get();
+    same->epoch.store(table->epoch.load(std::memory_order_relaxed), std::memory_order_release);
+    return *same;
+  }
+  tables.push_back(std::move(table));
+  current.store(tables.back().get(), std::memory_order_release);
+  return *tables.back();
+}
+
+void FlatFieldTableCache::ReleaseStale() {
+  const FlatFieldTable *cur = GetCurrent();
+  auto isStale = [cur](const std::unique_ptr<FlatFieldTable> &table) { return table.get() != cur; };
+  (void)tables.erase(std::remove_if(tables.begin(), tables.end(), isStale), tables.end());
+}
+
+// an embedded struct is followed by its own fields, as in TraverseToFieldRef
+void MIRStructType::AppendFlatFields(FlatFieldTable &table, TyIdx owner) const {
+  for (uint32 i = 0; i < fields.size(); ++i) {
+    table.slots.push_back(std::make_pair(owner, i));
+    TyIdx fieldTyIdx = fields[i].second.first;
+    MIRType *fieldType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(fieldTyIdx);
+    switch (fieldType->GetKind()) {
+      case kTypeStruct:
+      case kTypeStructIncomplete:
+      case kTypeClass:
+      case kTypeClassIncomplete:
+      case kTypeInterface:
+      case kTypeInterfaceIncomplete:
+        static_cast<MIRStructType*>(fieldType)->AppendFlatFields(table, fieldTyIdx);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+const FlatFieldTable &MIRStructType::GetFlatFields() const {
+  const FlatFieldTable *table = flatFields.GetCurrent();
+  if (table != nullptr && table->epoch.load(std::memory_order_acquire) ==
+      flatFieldsEpoch.load(std::memory_order_acquire)) {
+    return *table;
+  }
+  std::lock_guard<std::mutex> lock(flatFieldsMutex);
+  // read the epoch before the fields, so a change made while building leaves the new table stale
+  uint32 epoch = flatFieldsEpoch.load(std::memory_order_acquire);
+  table = flatFields.GetCurrent();
+  if (table != nullptr && table->epoch.load(std::memory_order_acquire) == epoch) {
+    return *table;
+  }
+  auto newTable = std::make_unique<FlatFieldTable>();
+  newTable->epoch.store(epoch, std::memory_order_relaxed);
+  AppendFlatFields(*newTable, TyIdx(0));
+  return flatFields.Publish(std::move(newTable));
+}
+
 FieldPair MIRStructType::TraverseToField(FieldID fieldID) const {
+  if (fieldID > 0) {
+    const FlatFieldTable &table = GetFlatFields();
+    // the slot of a parent class has no field of its own and keeps the answer of the traversal
+    if (static_cast<size_t>(fieldID) <= table.slots.size() &&
+        table.slots[fieldID - 1].second != kFlatFieldParentSlot) {
+      const std::pair<TyIdx, uint32> &slot = table.slots[fieldID - 1];
+      const MIRStructType *owner = (slot.first == 0u) ? this :
+          static_cast<MIRStructType*>(GlobalTables::GetTypeTable().GetTypeFromTyIdx(slot.first));
+#if DEBUG
+      FieldID walkedID = fieldID;
+      ASSERT(owner->fields[slot.second] == TraverseToFieldRef(walkedID), "flat field table disagrees with the walk");
+#endif
+      return owner->fields[slot.second];
+    }
+  }
   if (fieldID >= 0) {
     return TraverseToFieldRef(fieldID);
   }
@@ -1388,6 +1467,18 @@ FieldPair MIRClassType::TraverseToFieldRef(FieldID &fieldID) const {
   return MIRStructType::TraverseToFieldRef(fieldID);
 }
 
+// the parent class takes the first FieldID, followed by the fields of the parent
+void MIRClassType::AppendFlatFields(FlatFieldTable &table, TyIdx owner) const {
+  if (parentTyIdx != 0u) {
+    MIRType *parentType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(parentTyIdx);
+    if (parentType != nullptr) {
+      table.slots.push_back(std::make_pair(TyIdx(0), kFlatFieldParentSlot));
+      static_cast<MIRStructType*>(parentType)->AppendFlatFields(table, parentTyIdx);
+    }
+  }
+  MIRStructType::AppendFlatFields(table, owner);
+}
+
 // fields in interface are all static and are global, won't be accessed through fields
 FieldPair MIRInterfaceType::TraverseToFieldRef(FieldID&) const {
   return { GStrIdx(0), TyIdxFieldAttrPair(TyIdx(0), FieldAttrs()) };
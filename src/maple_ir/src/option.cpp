@@ -65,6 +65,8 @@ std::string Options::proFileData = "";
 std::string Options::proFileFuncData = "";
 std::string Options::proFileClassData = "";
 bool Options::checkArrayStore = false;
+bool Options::mpltSnapshot = false;
+bool Options::parallelLex = false;
 enum OptionIndex {
   kMpl2MplDumpPhase = kCommonOptionEnd + 1,
   kMpl2MplSkipPhase,
@@ -101,6 +103,8 @@ enum OptionIndex {
   kMpl2MplNoDot,
   kGenIRProfile,
   kProfileTest,
+  kMpl2MplMpltSnapshot,
+  kMpl2MplParallelLex,
 };
 
 const Descriptor kUsage[] = {
@@ -435,6 +439,26 @@ const Descriptor kUsage[] = {
     "  --no-profile-test           \tDisable profile test\n",
     "mpl2mpl",
     {} },
+  { kMpl2MplMpltSnapshot,
+    kEnable,
+    nullptr,
+    "mplt-snapshot",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --mplt-snapshot             \tImport text mplts through the binary snapshots kept next to them\n"
+    "  --no-mplt-snapshot          \tAlways parse imported text mplts\n",
+    "mpl2mpl",
+    {} },
+  { kMpl2MplParallelLex,
+    kEnable,
+    nullptr,
+    "parallel-lex",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --parallel-lex              \tLex the textual mpl input on worker threads ahead of the parser\n"
+    "  --no-parallel-lex           \tLex the textual mpl input on the parser's thread\n",
+    "mpl2mpl",
+    {} },
   { kUnknown,
     0,
     nullptr,
@@ -633,6 +657,12 @@ bool Options::SolveOptions(const std::vector<Option> &opts,
       case kProfileTest:
         profileTest = (opt.Type() == kEnable);
         break;
+      case kMpl2MplMpltSnapshot:
+        mpltSnapshot = (opt.Type() == kEnable);
+        break;
+      case kMpl2MplParallelLex:
+        parallelLex = (opt.Type() == kEnable);
+        break;
       default:
         WARN(kLncWarn, "input invalid key for mpl2mpl " + opt.OptionKey());
         break;
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "parallel_lexer.h"
+#include <functional>
+
+namespace maple {
+MIRParallelLexer::MIRParallelLexer(MIRModule &mod, MIRLexer &lexer, uint32 numThreads)
+    : file(*lexer.GetFile()),
+      pendingLine(std::move(lexer.line)),
+      nextLineNum(lexer.lineNum),
+      maxChunksAhead(numThreads * kChunksAheadPerThread) {
+  // the line now belongs to the first chunk
+  lexer.line.clear();
+  lexer.currentLineSize = 0;
+  lexer.curIdx = 0;
+  // the lexers and their pools are set up here, the workers may not touch the global controller
+  for (uint32 i = 0; i < numThreads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->memPool = worker->lexerMemPoolCtrler.NewMemPool("parallel lexer mempool");
+    worker->allocator = std::make_unique<MapleAllocator>(worker->memPool);
+    worker->lexer = std::make_unique<MIRLexer>(mod, *worker->allocator);
+    workers.push_back(std::move(worker));
+  }
+  for (auto &worker : workers) {
+    worker->thread = std::thread(&MIRParallelLexer::WorkerMain, this, std::ref(*worker));
+  }
+}
+
+MIRParallelLexer::~MIRParallelLexer() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  chunkToLex.notify_all();
+  for (auto &worker : workers) {
+    worker->thread.join();
+    worker->lexer.reset();
+    worker->allocator.reset();
+    worker->lexerMemPoolCtrler.DeleteMemPool(worker->memPool);
+  }
+}
+
+bool MIRParallelLexer::IsFuncStart(const std::string &line) {
+  constexpr size_t funcLength = 4;
+  return line.compare(0, funcLength, "func") == 0 &&
+         (line.length() == funcLength || line[funcLength] == ' ' || line[funcLength] == '\t');
+}
+
+// read the lines up to the start of a function past kMinLinesPerChunk lines, or the end of the file
+bool MIRParallelLexer::ReadChunk() {
+  if (atEof) {
+    return false;
+  }
+  auto chunk = std::make_unique<Chunk>();
+  chunk->firstLineNum = nextLineNum;
+  chunk->lines.push_back(std::move(pendingLine));
+  ++nextLineNum;
+  std::string line;
+  while (true) {
+    if (!std::getline(file, line)) {
+      atEof = true;
+      break;
+    }
+    MIRLexer::RemoveReturnInline(line);
+    if (chunk->lines.size() >= kMinLinesPerChunk && IsFuncStart(line)) {
+      pendingLine = std::move(line);
+      break;
+    }
+    chunk->lines.push_back(std::move(line));
+    ++nextLineNum;
+  }
+  std::lock_guard<std::mutex> lock(mtx);
+  chunksToLex.push_back(chunk.get());
+  chunksAhead.push_back(std::move(chunk));
+  chunkToLex.notify_one();
+  return true;
+}
+
+void MIRParallelLexer::FillWindow() {
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (chunksAhead.size() >= maxChunksAhead) {
+        return;
+      }
+    }
+    if (!ReadChunk()) {
+      return;
+    }
+  }
+}
+
+std::unique_ptr<MIRParallelLexer::Chunk> MIRParallelLexer::NextChunk() {
+  FillWindow();
+  std::unique_lock<std::mutex> lock(mtx);
+  if (chunksAhead.empty()) {
+    return nullptr;
+  }
+  chunkLexed.wait(lock, [this] { return chunksAhead.front()->lexed; });
+  std::unique_ptr<Chunk> chunk = std::move(chunksAhead.front());
+  chunksAhead.pop_front();
+  return chunk;
+}
+
+void MIRParallelLexer::WorkerMain(Worker &worker) {
+  while (true) {
+    Chunk *chunk = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      chunkToLex.wait(lock, [this] { return stopping || !chunksToLex.empty(); });
+      if (stopping) {
+        return;
+      }
+      chunk = chunksToLex.front();
+      chunksToLex.pop_front();
+    }
+    LexChunk(*worker.lexer, *chunk);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      chunk->lexed = true;
+    }
+    chunkLexed.notify_all();
+  }
+}
+
+void MIRParallelLexer::LexChunk(MIRLexer &chunkLexer, Chunk &chunk) const {
+  chunkLexer.lineBuffer = &chunk.lines;
+  chunkLexer.nextLineInBuffer = 0;
+  (void)chunkLexer.ReadALine();
+  chunkLexer.lineNum = chunk.firstLineNum;
+  chunk.tokens.reserve(chunk.lines.size() * kTokensPerLine);
+  for (TokenKind kind = chunkLexer.LexToken(); kind != TK_eof; kind = chunkLexer.LexToken()) {
+    chunk.tokens.emplace_back();
+    LexedToken &token = chunk.tokens.back();
+    token.kind = kind;
+    token.lineNum = chunkLexer.lineNum;
+    token.curIdx = chunkLexer.curIdx;
+    token.theIntVal = chunkLexer.theIntVal;
+    token.theFloatVal = chunkLexer.theFloatVal;
+    token.theDoubleVal = chunkLexer.theDoubleVal;
+    token.name = chunkLexer.name;
+    if (!chunkLexer.seenComments.empty()) {
+      token.comments.assign(chunkLexer.seenComments.begin(), chunkLexer.seenComments.end());
+      chunkLexer.seenComments.clear();
+    }
+  }
+  chunk.trailingComments.assign(chunkLexer.seenComments.begin(), chunkLexer.seenComments.end());
+  chunkLexer.seenComments.clear();
+  chunkLexer.lineBuffer = nullptr;
+  // the lines have been moved into the lexer one by one
+  std::vector<std::string>().swap(chunk.lines);
+}
+
+TokenKind MIRParallelLexer::NextToken(MIRLexer &lexer) {
+  while (curChunk == nullptr || nextToken == curChunk->tokens.size()) {
+    if (curChunk != nullptr) {
+      for (const std::string &comment : curChunk->trailingComments) {
+        lexer.seenComments.push_back(comment);
+      }
+    }
+    curChunk = NextChunk();
+    nextToken = 0;
+    if (curChunk == nullptr) {
+      return TK_eof;
+    }
+  }
+  const LexedToken &token = curChunk->tokens[nextToken++];
+  for (const std::string &comment : token.comments) {
+    lexer.seenComments.push_back(comment);
+  }
+  lexer.lineNum = token.lineNum;
+  lexer.curIdx = token.curIdx;
+  lexer.theIntVal = token.theIntVal;
+  lexer.theFloatVal = token.theFloatVal;
+  lexer.theDoubleVal = token.theDoubleVal;
+  lexer.name = token.name;
+  return token.kind;
+}
+
+void MIRParallelLexer::SkipLine(uint32 lineNum) {
+  while (curChunk != nullptr && nextToken < curChunk->tokens.size() &&
+         curChunk->tokens[nextToken].lineNum == lineNum) {
+    ++nextToken;
+  }
+}
+}  // namespace maple
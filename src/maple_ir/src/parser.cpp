@@ -16,6 +16,8 @@
 #include <cstdlib>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <thread>
 #include "mir_parser.h"
 #include "mir_function.h"
 #include "namemangler.h"
@@ -706,7 +708,7 @@ bool MIRParser::ParseFields(MIRStructType &type) {
       } else if (isStaticField) {
         type.GetStaticFields().push_back(p);
       } else {
-        type.GetFields().push_back(p);
+        type.PushbackField(p);
       }
       tk = lexer.GetTokenKind();
       bool isConst = tA.GetAttr(FLDATTR_static) && tA.GetAttr(FLDATTR_final) &&
@@ -2223,7 +2225,7 @@ uint8 *MIRParser::ParseWordsInfo(uint32 size) {
 static void GenJStringType(MIRModule &module) {
   MIRStructType metaClassType(kTypeStructIncomplete);
   GStrIdx strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName("dummy");
-  metaClassType.GetFields().push_back(FieldPair(strIdx, TyIdxFieldAttrPair(TyIdx(PTY_ref), FieldAttrs())));
+  metaClassType.PushbackField(FieldPair(strIdx, TyIdxFieldAttrPair(TyIdx(PTY_ref), FieldAttrs())));
   strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName("__class_meta__");
   metaClassType.SetNameStrIdx(strIdx);
   TyIdx tyIdx = GlobalTables::GetTypeTable().GetOrCreateMIRType(&metaClassType);
@@ -2262,6 +2264,13 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
   paramFileIdx = fileIdx;
   paramIsIPA = isIPA;
   paramIsComb = isComb;
+  constexpr uint32 kMaxLexerThreads = 8;
+  uint32 numThreads = std::min(std::thread::hardware_concurrency(), kMaxLexerThreads);
+  if ((option & kParseInParallel) != 0 && (option & kParseOptFunc) == 0 && lexer.GetFile() != nullptr &&
+      lexer.curIdx == 0 && numThreads > 1) {
+    parallelLexer = std::make_unique<MIRParallelLexer>(mod, lexer, numThreads);
+    lexer.parallelLexer = parallelLexer.get();
+  }
   lexer.NextToken();
   while (!atEof) {
     paramTokenKind = lexer.GetTokenKind();
@@ -2275,10 +2284,14 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
       }
     } else {
       if (!(this->*(itFuncPtr->second))()) {
+        lexer.parallelLexer = nullptr;
+        parallelLexer.reset();
         return false;
       }
     }
   }
+  lexer.parallelLexer = nullptr;
+  parallelLexer.reset();
   // fix the typedef type
   FixupForwardReferencedTypeByMap();
   // check if any global type name is undefined
@@ -2300,7 +2313,9 @@ bool MIRParser::ParseMIR(uint32 fileIdx, uint32 option, bool isIPA, bool isComb)
     for (auto it = paramImportFileList.begin(); it != paramImportFileList.end(); ++it) {
       BinaryMplt binMplt(mod);
       std::string importFilename = *it;
-      if (!binMplt.Import(importFilename, false, true)) {  // not a binary mplt
+      bool useSnapshot = (options & kParseMpltSnapshot) != 0;
+      if (!binMplt.Import(importFilename, false, true) && !(useSnapshot && binMplt.ImportSnapshot(importFilename))) {
+        // a text mplt without a snapshot
         std::ifstream mpltFile(importFilename);
         if (!mpltFile.is_open()) {
           FATAL(kLncFatal, "cannot open MPLT file: %s\n", importFilename.c_str());
@@ -2702,6 +2717,9 @@ bool MIRParser::ParseMPLT(std::ifstream &mpltFile, const std::string &importFile
   std::ifstream *airFileSave = lexer.GetFile();
   int lineNumSave = lexer.lineNum;
   std::string modFileNameSave = mod.GetFileName();
+  // the import file is lexed on this thread
+  MIRParallelLexer *parallelLexerSave = lexer.parallelLexer;
+  lexer.parallelLexer = nullptr;
   // set up to read next line from the import file
   lexer.curIdx = 0;
   lexer.currentLineSize = 0;
@@ -2745,6 +2763,10 @@ bool MIRParser::ParseMPLT(std::ifstream &mpltFile, const std::string &importFile
   lexer.currentLineSize = 0;
   lexer.lineNum = lineNumSave;
   lexer.SetFile(*airFileSave);
+  lexer.parallelLexer = parallelLexerSave;
+  if (parallelLexerSave != nullptr) {
+    parallelLexerSave->SkipLine(lineNumSave);
+  }
   mod.SetFileName(modFileNameSave);
   return true;
 }
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "trace_event.h"
+#include <unistd.h>
+#include <fstream>
+#include "mpl_logging.h"
+
+namespace maple {
+namespace {
+void EmitJsonString(std::ofstream &out, const std::string &str) {
+  out << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {  // other control characters are dropped
+          break;
+        }
+        out << c;
+        break;
+    }
+  }
+  out << '"';
+}
+}  // namespace
+
+TraceEventRecorder &TraceEventRecorder::GetInstance() {
+  static TraceEventRecorder recorder;
+  return recorder;
+}
+
+TraceEventRecorder::~TraceEventRecorder() {
+  Flush();
+}
+
+void TraceEventRecorder::Enable(const std::string &fileName) {
+  std::lock_guard<std::mutex> lock(eventMutex);
+  if (enabled.load(std::memory_order_relaxed)) {
+    return;
+  }
+  traceFileName = fileName;
+  origin = Clock::now();
+  enabled.store(true, std::memory_order_relaxed);
+}
+
+uint32 TraceEventRecorder::GetThreadIndex() {
+  auto it = threadIndexes.find(std::this_thread::get_id());
+  if (it != threadIndexes.end()) {
+    return it->second;
+  }
+  uint32 index = static_cast<uint32>(threadIndexes.size());
+  threadIndexes[std::this_thread::get_id()] = index;
+  return index;
+}
+
+void TraceEventRecorder::AddCompleteEvent(const std::string &category, const std::string &name,
+                                          const std::string &unit, Clock::time_point begin, Clock::time_point end,
+                                          size_t memPoolBytes) {
+  if (!IsEnabled()) {
+    return;
+  }
+  int64 beginUs = std::chrono::duration_cast<std::chrono::microseconds>(begin - origin).count();
+  int64 durationUs = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+  std::lock_guard<std::mutex> lock(eventMutex);
+  events.push_back(TraceEvent{ category, name, unit, beginUs, durationUs, memPoolBytes, GetThreadIndex() });
+}
+
+void TraceEventRecorder::Flush() {
+  std::lock_guard<std::mutex> lock(eventMutex);
+  if (!enabled.load(std::memory_order_relaxed) || traceFileName.empty()) {
+    return;
+  }
+  std::ofstream out(traceFileName, std::ios::trunc);
+  if (!out.is_open()) {
+    LogInfo::MapleLogger(kLlErr) << "Cannot open trace file " << traceFileName << '\n';
+    return;
+  }
+  int pid = getpid();
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < events.size(); ++i) {
+    const TraceEvent &event = events[i];
+    out << (i == 0 ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << event.tid
+        << ",\"ts\":" << event.beginUs << ",\"dur\":" << event.durationUs << ",\"cat\":";
+    EmitJsonString(out, event.category);
+    out << ",\"name\":";
+    EmitJsonString(out, event.name);
+    out << ",\"args\":{\"unit\":";
+    EmitJsonString(out, event.unit);
+    out << ",\"memPoolBytes\":" << event.memPoolBytes << "}}";
+  }
+  out << "\n]}\n";
+  out.close();
+}
+}  // namespace maple
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+// Checks that numbers written by BinaryMplExport::WriteNum read back the same through
+// BinaryMplImport::ReadNum, at the int64 extremes and at every width the encoding steps through.
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "bin_mpl_export.h"
+#include "bin_mpl_import.h"
+#include "mir_module.h"
+
+namespace {
+using namespace maple;
+
+int failures = 0;
+
+void Expect(bool cond, const std::string &what) {
+  if (!cond) {
+    std::cerr << "FAIL " << what << "\n";
+    ++failures;
+  }
+}
+
+// a byte holds 7 bits and the last one a sign, so -64..63 take one byte and every 7 bits more take one more
+size_t ExpectedLength(int64 x) {
+  size_t length = 1;
+  while (x < -0x40 || x >= 0x40) {
+    x >>= 7;
+    ++length;
+  }
+  return length;
+}
+
+std::vector<int64> Values() {
+  std::vector<int64> values = { 0, 1, -1, 63, 64, -64, -65, 127, 128, -128, -129,
+                                INT32_MAX, INT32_MIN, static_cast<int64>(UINT32_MAX),
+                                INT64_MAX, INT64_MAX - 1, INT64_MIN, INT64_MIN + 1 };
+  // both sides of each boundary between widths
+  for (int bit = 6; bit < 63; ++bit) {
+    int64 power = static_cast<int64>(1) << bit;
+    for (int64 x : { power - 1, power, power + 1, -power - 1, -power, -power + 1 }) {
+      values.push_back(x);
+    }
+  }
+  std::mt19937_64 gen(0x5EED);
+  constexpr int kRandomValues = 10000;
+  for (int i = 0; i < kRandomValues; ++i) {
+    // a random width, so that short encodings are met as often as long ones
+    values.push_back(static_cast<int64>(gen()) >> (gen() % 64));
+  }
+  return values;
+}
+
+void TestRoundTrip(MIRModule &module) {
+  std::vector<int64> values = Values();
+  BinaryMplExport exporter(module);
+  std::vector<size_t> ends;
+  for (int64 x : values) {
+    exporter.WriteNum(x);
+    ends.push_back(exporter.GetBuf().size());
+  }
+  const std::vector<uint8> &buf = exporter.GetBuf();
+  BinaryMplImport importer(module);
+  importer.ReadFromBuffer(buf.data(), buf.size());
+  size_t begin = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    int64 x = values[i];
+    Expect(ends[i] - begin == ExpectedLength(x),
+           "length " + std::to_string(ends[i] - begin) + " of " + std::to_string(x));
+    int64 y = importer.ReadNum();
+    Expect(y == x, "read " + std::to_string(y) + " for " + std::to_string(x));
+    Expect(importer.GetBufI() == ends[i], "position after " + std::to_string(x));
+    begin = ends[i];
+  }
+}
+
+// the encoding of the extremes is part of the mplt format, files written before must still read the same
+void TestExtremeBytes(MIRModule &module) {
+  const std::vector<std::pair<int64, std::vector<uint8>>> cases = {
+    { -1, { 0x7F } },
+    { 64, { 0xC0, 0x00 } },
+    { -65, { 0xBF, 0x7F } },
+    { INT64_MAX, { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 } },
+    { INT64_MIN, { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7F } },
+  };
+  for (const auto &testCase : cases) {
+    BinaryMplExport exporter(module);
+    exporter.WriteNum(testCase.first);
+    Expect(exporter.GetBuf() == testCase.second, "bytes of " + std::to_string(testCase.first));
+    BinaryMplImport importer(module);
+    importer.ReadFromBuffer(testCase.second.data(), testCase.second.size());
+    Expect(importer.ReadNum() == testCase.first, "read of the bytes of " + std::to_string(testCase.first));
+  }
+}
+}  // namespace
+
+int main() {
+  MIRModule module("bin_mpl_num_test.mpl");
+  TestRoundTrip(module);
+  TestExtremeBytes(module);
+  if (failures != 0) {
+    std::cerr << failures << " failures\n";
+    return 1;
+  }
+  std::cout << "WriteNum/ReadNum: all checks passed\n";
+  return 0;
+}
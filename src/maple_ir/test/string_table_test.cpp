@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+// Checks that StringTable::GetOrCreateStrIdxFromName hands out one index per name when threads add the
+// same names at once, while the shards grow several times and lock-free lookups run against them.
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "global_tables.h"
+
+namespace {
+using maple::GStrIdx;
+using maple::StringTable;
+using maple::uint32;
+
+// 16 shards of 256 slots at most half full take 2048 names before the first grows, so this many names
+// make every shard grow five times, and fill six chunks of entries
+constexpr size_t kNames = 60000;
+constexpr size_t kThreads = 8;
+
+std::atomic<int> failures{ 0 };
+
+void Fail(const std::string &what) {
+  if (failures.fetch_add(1) < 20) {  // the first few are enough to go by
+    std::cerr << "FAIL " + what + "\n";
+  }
+}
+
+std::vector<std::string> MakeNames() {
+  std::vector<std::string> names;
+  names.reserve(kNames);
+  for (size_t i = 0; i < kNames; ++i) {
+    // long names are not kept inline by the small string optimization
+    names.push_back((i % 3 == 0 ? "Lcom/example/pkg/SomeLongClassName_" : "f") + std::to_string(i));
+  }
+  return names;
+}
+
+// each thread adds all names in its own order; every name it added before must keep its index while
+// the other threads grow the shards
+void AddNames(StringTable<std::string, GStrIdx> &table, const std::vector<std::string> &names, size_t seed,
+              std::vector<uint32> &indexes) {
+  std::vector<size_t> order(names.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::mt19937 gen(static_cast<uint32>(seed));
+  std::shuffle(order.begin(), order.end(), gen);
+  indexes.assign(names.size(), 0);
+  for (size_t n = 0; n < order.size(); ++n) {
+    size_t i = order[n];
+    uint32 idx = table.GetOrCreateStrIdxFromName(names[i]).GetIdx();
+    indexes[i] = idx;
+    if (idx == 0 || table.GetStringFromStrIdx(GStrIdx(idx)) != names[i]) {
+      Fail("index " + std::to_string(idx) + " of " + names[i]);
+    }
+    size_t earlier = order[gen() % (n + 1)];
+    if (table.GetStrIdxFromName(names[earlier]).GetIdx() != indexes[earlier]) {
+      Fail("lookup of " + names[earlier] + " while adding " + names[i]);
+    }
+  }
+}
+
+void TestConcurrentAdds() {
+  StringTable<std::string, GStrIdx> table;
+  table.Init();
+  std::vector<std::string> names = MakeNames();
+  std::vector<std::vector<uint32>> indexes(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back(AddNames, std::ref(table), std::cref(names), t + 1, std::ref(indexes[t]));
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  if (table.StringTableSize() != kNames + 1) {
+    Fail("table size " + std::to_string(table.StringTableSize()) + ", expected " + std::to_string(kNames + 1));
+  }
+  std::vector<bool> used(kNames + 1, false);
+  for (size_t i = 0; i < kNames; ++i) {
+    uint32 idx = indexes[0][i];
+    for (size_t t = 1; t < kThreads; ++t) {
+      if (indexes[t][i] != idx) {
+        Fail("threads disagree on the index of " + names[i]);
+      }
+    }
+    if (idx > kNames || used[idx]) {
+      Fail("index " + std::to_string(idx) + " of " + names[i] + " given twice or out of range");
+      continue;
+    }
+    used[idx] = true;
+    if (table.GetStrIdxFromName(names[i]).GetIdx() != idx) {
+      Fail("lookup of " + names[i] + " after all adds");
+    }
+  }
+  if (table.GetStrIdxFromName("not added").GetIdx() != 0) {
+    Fail("a name never added is found");
+  }
+}
+}  // namespace
+
+int main() {
+  TestConcurrentAdds();
+  if (failures != 0) {
+    std::cerr << failures << " failures\n";
+    return 1;
+  }
+  std::cout << "StringTable: all checks passed\n";
+  return 0;
+}
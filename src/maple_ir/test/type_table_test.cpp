@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+// Checks that the pointer, array and function type helpers of TypeTable, which look types up by their
+// components, give the TyIdx that interning a built type with GetOrCreateMIRType gives, in either order,
+// and that types differing in any one component stay apart.
+#include <iostream>
+#include <string>
+#include <vector>
+#include "global_tables.h"
+#include "mir_module.h"
+#include "mir_type.h"
+
+namespace {
+using namespace maple;
+
+int failures = 0;
+
+void Expect(bool cond, const std::string &what) {
+  if (!cond) {
+    std::cerr << "FAIL " << what << "\n";
+    ++failures;
+  }
+}
+
+TypeTable &Types() {
+  return GlobalTables::GetTypeTable();
+}
+
+// the helper is called first, then the built type must be found; size shows nothing new was entered
+template <typename Helper>
+void ExpectSameAsInterned(MIRType &built, Helper helper, const std::string &what) {
+  TyIdx helperTyIdx = helper()->GetTypeIndex();
+  size_t size = Types().GetTypeTableSize();
+  Expect(Types().GetOrCreateMIRType(&built) == helperTyIdx, what + ": interned after the helper");
+  Expect(helper()->GetTypeIndex() == helperTyIdx, what + ": helper called again");
+  Expect(Types().GetTypeTableSize() == size, what + ": entered twice");
+}
+
+// the built type is interned first, then the helper must find it
+template <typename Helper>
+void ExpectHelperFindsInterned(MIRType &built, Helper helper, const std::string &what) {
+  TyIdx builtTyIdx = Types().GetOrCreateMIRType(&built);
+  size_t size = Types().GetTypeTableSize();
+  Expect(helper()->GetTypeIndex() == builtTyIdx, what + ": helper after interning");
+  Expect(Types().GetTypeTableSize() == size, what + ": entered twice");
+}
+
+void TestPointerTypes() {
+  MIRType &i32 = *Types().GetInt32();
+  MIRType &f64 = *Types().GetDouble();
+  MIRPtrType ptrToI32(i32.GetTypeIndex(), PTY_ptr);
+  ExpectSameAsInterned(ptrToI32, [&i32]() { return Types().GetOrCreatePointerType(i32, PTY_ptr); }, "ptr to i32");
+  MIRPtrType refToI32(i32.GetTypeIndex(), PTY_ref);
+  ExpectSameAsInterned(refToI32, [&i32]() { return Types().GetOrCreatePointerType(i32, PTY_ref); }, "ref to i32");
+  Expect(Types().GetOrCreatePointerType(i32, PTY_ptr) != Types().GetOrCreatePointerType(i32, PTY_ref),
+         "ptr and ref to i32 kept apart");
+  MIRPtrType ptrToF64(f64.GetTypeIndex(), PTY_a64);
+  ExpectHelperFindsInterned(ptrToF64, [&f64]() { return Types().GetOrCreatePointerType(f64, PTY_a64); },
+                            "a64 to f64");
+  // a pointer to a pointer hashes by the index of a type entered above
+  MIRType &ptrPtr = *Types().GetOrCreatePointerType(i32, PTY_ptr);
+  MIRPtrType ptrToPtr(ptrPtr.GetTypeIndex(), PTY_ptr);
+  ExpectSameAsInterned(ptrToPtr, [&ptrPtr]() { return Types().GetOrCreatePointerType(ptrPtr, PTY_ptr); },
+                       "ptr to ptr");
+}
+
+void TestArrayTypes() {
+  MIRType &i32 = *Types().GetInt32();
+  MIRType &f64 = *Types().GetDouble();
+  MIRArrayType oneDim(i32.GetTypeIndex(), { 10 });
+  ExpectSameAsInterned(oneDim, [&i32]() { return Types().GetOrCreateArrayType(i32, 10); }, "[10] i32");
+  const uint32 sizes[] = { 2, 3, 4 };
+  MIRArrayType threeDims(i32.GetTypeIndex(), { 2, 3, 4 });
+  ExpectSameAsInterned(threeDims, [&i32, &sizes]() { return Types().GetOrCreateArrayType(i32, 3, sizes); },
+                       "[2][3][4] i32");
+  const uint32 otherSizes[] = { 2, 4, 3 };
+  MIRArrayType otherOrder(i32.GetTypeIndex(), { 2, 4, 3 });
+  ExpectHelperFindsInterned(otherOrder, [&i32, &otherSizes]() {
+    return Types().GetOrCreateArrayType(i32, 3, otherSizes);
+  }, "[2][4][3] i32");
+  Expect(Types().GetOrCreateArrayType(i32, 3, sizes) != Types().GetOrCreateArrayType(i32, 3, otherSizes),
+         "[2][3][4] and [2][4][3] kept apart");
+  Expect(Types().GetOrCreateArrayType(i32, 2, sizes) != Types().GetOrCreateArrayType(i32, 3, sizes),
+         "[2][3] and [2][3][4] kept apart");
+  // no size array stands for sizes of 0
+  MIRArrayType unsized(f64.GetTypeIndex(), { 0, 0 });
+  ExpectHelperFindsInterned(unsized, [&f64]() { return Types().GetOrCreateArrayType(f64, 2, nullptr); },
+                            "[0][0] f64");
+  MIRFarrayType farray(f64.GetTypeIndex());
+  ExpectSameAsInterned(farray, [&f64]() { return Types().GetOrCreateFarrayType(f64); }, "[] f64");
+  MIRJarrayType jarray(f64.GetTypeIndex());
+  ExpectSameAsInterned(jarray, [&f64]() { return Types().GetOrCreateJarrayType(f64); }, "jarray f64");
+  Expect(Types().GetOrCreateFarrayType(f64) != Types().GetOrCreateJarrayType(f64), "farray and jarray kept apart");
+}
+
+void TestFunctionTypes(MIRModule &module) {
+  TyIdx i32 = Types().GetInt32()->GetTypeIndex();
+  TyIdx f64 = Types().GetDouble()->GetTypeIndex();
+  TyIdx voidTy = Types().GetVoid()->GetTypeIndex();
+  TypeAttrs noAttrs;
+  TypeAttrs constAttrs;
+  constAttrs.SetAttr(ATTR_const);
+  auto helper = [&module](TyIdx ret, const std::vector<TyIdx> &params, const std::vector<TypeAttrs> &attrs,
+                          bool isVarg) {
+    return [&module, ret, params, attrs, isVarg]() {
+      return Types().GetOrCreateFunctionType(module, ret, params, attrs, isVarg);
+    };
+  };
+  MIRFuncType noParams(voidTy, {}, {}, module.GetMPAllocator());
+  ExpectSameAsInterned(noParams, helper(voidTy, {}, {}, false), "void ()");
+  MIRFuncType twoParams(i32, { i32, f64 }, { noAttrs, noAttrs }, module.GetMPAllocator());
+  ExpectSameAsInterned(twoParams, helper(i32, { i32, f64 }, { noAttrs, noAttrs }, false), "i32 (i32, f64)");
+  MIRFuncType varargs(i32, { i32, f64 }, { noAttrs, noAttrs }, module.GetMPAllocator());
+  varargs.SetVarArgs(true);
+  ExpectSameAsInterned(varargs, helper(i32, { i32, f64 }, { noAttrs, noAttrs }, true), "i32 (i32, f64, ...)");
+  MIRFuncType constParam(i32, { i32, f64 }, { constAttrs, noAttrs }, module.GetMPAllocator());
+  ExpectHelperFindsInterned(constParam, helper(i32, { i32, f64 }, { constAttrs, noAttrs }, false),
+                            "i32 (const i32, f64)");
+  // same hash index: the same return type, first parameter and number of parameters
+  MIRFuncType otherSecond(i32, { i32, i32 }, { noAttrs, noAttrs }, module.GetMPAllocator());
+  ExpectHelperFindsInterned(otherSecond, helper(i32, { i32, i32 }, { noAttrs, noAttrs }, false), "i32 (i32, i32)");
+  TyIdx plain = helper(i32, { i32, f64 }, { noAttrs, noAttrs }, false)()->GetTypeIndex();
+  Expect(helper(i32, { i32, f64 }, { noAttrs, noAttrs }, true)()->GetTypeIndex() != plain, "varargs kept apart");
+  Expect(helper(i32, { i32, f64 }, { constAttrs, noAttrs }, false)()->GetTypeIndex() != plain,
+         "parameter attributes kept apart");
+  Expect(helper(i32, { i32, i32 }, { noAttrs, noAttrs }, false)()->GetTypeIndex() != plain,
+         "second parameter kept apart");
+  Expect(helper(f64, { i32, f64 }, { noAttrs, noAttrs }, false)()->GetTypeIndex() != plain,
+         "return type kept apart");
+}
+}  // namespace
+
+int main() {
+  MIRModule module("type_table_test.mpl");
+  TestPointerTypes();
+  TestArrayTypes();
+  TestFunctionTypes(module);
+  if (failures != 0) {
+    std::cerr << failures << " failures\n";
+    return 1;
+  }
+  std::cout << "TypeTable: all checks passed\n";
+  return 0;
+}
@@ -23,6 +23,9 @@
 #include "alias_analysis_table.h"
 
 namespace maple {
+class FuncModRef;
+class ModRefAnalysis;
+
 class AliasElem {
   friend class AliasClass;
  public:
@@ -138,6 +141,11 @@ class AliasClass : public AnalysisResult {
     unionFind.Reinit();
   }
 
+  // the mod/ref summaries IPA left for the module, nullptr if it did not run
+  void SetModRefAnalysis(const ModRefAnalysis *result) {
+    modRefAnalysis = result;
+  }
+
   void ApplyUnionForCopies(StmtNode &stmt);
   void CreateAssignSets();
   void DumpAssignSets();
@@ -152,7 +160,8 @@ class AliasClass : public AnalysisResult {
   void CollectNotAllDefsSeenAes();
   void CreateClassSets();
   void DumpClassSets();
-  void InsertMayDefUseCall(StmtNode &stmt, bool hasSideEffect, bool hasNoPrivateDefEffect);
+  void InsertMayDefUseCall(StmtNode &stmt, bool hasSideEffect, bool hasNoPrivateDefEffect,
+                           const FuncModRef *calleeModRef = nullptr);
   void GenericInsertMayDefUse(StmtNode &stmt, BBId bbID);
 
  protected:
@@ -177,7 +186,12 @@ class AliasClass : public AnalysisResult {
   bool IsPointedTo(OriginalSt &oSt);
   AliasElem &FindOrCreateAliasElemOfAddrofOSt(OriginalSt &oSt);
   void CollectMayDefForMustDefs(const StmtNode &stmt, std::set<OriginalSt*> &mayDefOsts);
+  bool CollectMayUseForOpnd(BaseNode &opnd, std::set<OriginalSt*> &mayUseOsts);
   void CollectMayUseForCallOpnd(const StmtNode &stmt, std::set<OriginalSt*> &mayUseOsts);
+  const FuncModRef *GetCalleeModRef(const StmtNode &stmt) const;
+  bool IsReachedThroughJarray(const OriginalSt &ost) const;
+  bool MayBeModifiedByCallee(const OriginalSt &ost, const FuncModRef &calleeModRef) const;
+  void InsertMayDefUseCallWithModRef(StmtNode &stmt, bool hasNoPrivateDefEffect, const FuncModRef &calleeModRef);
   void InsertMayDefNodeForCall(std::set<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes,
                                StmtNode &stmt, bool hasNoPrivateDefEffect);
   void InsertMayUseExpr(BaseNode &expr);
@@ -222,6 +236,7 @@ class AliasClass : public AnalysisResult {
   bool calleeHasSideEffect;
   KlassHierarchy *klassHierarchy;
   AliasAnalysisTable *aliasAnalysisTable = nullptr;
+  const ModRefAnalysis *modRefAnalysis = nullptr;
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ALIAS_CLASS_H
@@ -60,6 +60,12 @@ class Dominance : public AnalysisResult {
   void ComputePdtDfn();
   bool PostDominate(const BB &bb1, const BB &bb2);  // true if bb1 postdominates bb2
   void DumpPdoms();
+  // keep the result valid after newBB, with pred as its only pred and succ as its only succ,
+  // has been inserted on the edge pred->succ; call UpdateTreeOrders once all edges are split
+  void UpdateAfterSplitEdge(BB &pred, BB &newBB, BB &succ);
+  void UpdateTreeOrders();
+  // dump both trees and their frontiers by bb id, so that an updated result can be compared with a new one
+  void DumpTrees() const;
 
   const MapleVector<BB*> &GetBBVec() const {
     return bbVec;
@@ -195,6 +201,10 @@ class Dominance : public AnalysisResult {
   bool CommonEntryBBIsPred(const BB &bb) const;
   void PdomPostOrderWalk(const BB &bb, int32 &pid, std::vector<bool> &visitedMap);
   BB *PdomIntersect(BB &bb1, const BB &bb2);
+  void GrowToBBVec();
+  bool IsReachable(const BB &bb) const;
+  void UpdateDomAfterSplitEdge(BB &pred, BB &newBB, BB &succ);
+  void UpdatePdomAfterSplitEdge(BB &pred, BB &newBB, BB &succ);
 
   MapleAllocator domAllocator;  // stores the analysis results
 
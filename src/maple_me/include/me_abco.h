@@ -205,8 +205,7 @@ class MeABC {
         memPool(&pool),
         allocator(&pool),
         inequalityGraph(nullptr),
-        prove(nullptr),
-        forbidenPi(nullptr) {}
+        prove(nullptr) {}
   ~MeABC() = default;
   void ExecuteABCO();
 
@@ -249,7 +248,7 @@ class MeABC {
   void AddCarePhi(MeVarPhiNode &defP);
   void BuildInequalityGraph();
   void FindRedundantABC(MeStmt &meStmt, NaryMeExpr &naryMeExpr);
-  void InitNewStartPoint(const MeStmt &meStmt, const NaryMeExpr &nMeExpr);
+  void InitGraph();
   void DeleteABC();
   bool CleanABCInStmt(MeStmt &meStmt, NaryMeExpr &naryMeExpr);
   MeExpr *ReplaceArrayExpr(MeExpr &rhs, MeExpr &naryMeExpr, MeStmt *ivarStmt);
@@ -277,7 +276,7 @@ class MeABC {
   MapleAllocator allocator;
   std::unique_ptr<InequalityGraph> inequalityGraph;
   std::unique_ptr<ABCD> prove;
-  MeStmt *forbidenPi;
+  std::map<MeStmt*, std::vector<InequalEdge*>> checkBoundEdges;  // the bounds each check gives after itself
   std::map<MeStmt*, NaryMeExpr*> arrayChecks;
   std::map<MeStmt*, NaryMeExpr*> arrayNewChecks;
   std::set<MeStmt*> careMeStmts;
@@ -32,6 +32,15 @@ class MeCondBased {
     return func;
   }
 
+ protected:
+  SSATab &GetSSATab() const {
+    return *func->GetMeSSATab();
+  }
+
+  const MIRFunction &GetMirFunc() const {
+    return *func->GetMirFunc();
+  }
+
  private:
   bool NullValueFromOneTestCond(const VarMeExpr&, const BB&, const BB&, bool) const;
   bool PointerWasDereferencedBefore(const VarMeExpr&, const UnaryMeStmt&, const BB&) const;
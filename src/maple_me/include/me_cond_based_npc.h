@@ -15,14 +15,22 @@
 #ifndef MAPLE_ME_INCLUDE_MECONDBASEDNPC_H
 #define MAPLE_ME_INCLUDE_MECONDBASEDNPC_H
 #include "me_cond_based.h"
+#include "nonnull_inference.h"
 
 namespace maple {
 class CondBasedNPC : public MeCondBased {
  public:
-  CondBasedNPC(MeFunction &func, Dominance &dom) : MeCondBased(func, dom) {}
+  CondBasedNPC(MeFunction &func, Dominance &dom, const NonNullInference *nonNull)
+      : MeCondBased(func, dom), nonNull(nonNull) {}
 
   ~CondBasedNPC() = default;
   void DoCondBasedNPC() const;
+
+ private:
+  // non-null by the facts inferred over the call graph: a formal on entry or the return value of a callee
+  bool IsNonNullAcrossCalls(const VarMeExpr &var) const;
+
+  const NonNullInference *nonNull;  // nullptr when the module phase did not run
 };
 
 class MeDoCondBasedNPC : public MeFuncPhase {
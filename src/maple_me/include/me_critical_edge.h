@@ -17,6 +17,7 @@
 
 #include "me_phase.h"
 #include "bb.h"
+#include "dominance.h"
 
 namespace maple {
 // Split critical edge
@@ -32,7 +33,8 @@ class MeDoSplitCEdge : public MeFuncPhase {
   }
 
  private:
-  void BreakCriticalEdge(MeFunction &func, BB &pred, BB &succ) const;
+  BB &BreakCriticalEdge(MeFunction &func, BB &pred, BB &succ) const;
+  void DumpUpdatedDominance(MeFunction &func, const Dominance &dom);
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_MECRITICALEDGE_H
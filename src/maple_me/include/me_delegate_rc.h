@@ -17,15 +17,17 @@
 #include "me_function.h"
 #include "me_phase.h"
 #include "me_irmap.h"
+#include "rc_summary.h"
 
 namespace maple {
 class DelegateRC {
  public:
-  DelegateRC(MeFunction &func, Dominance &dom, MemPool *memPool, bool enabledDebug)
+  DelegateRC(MeFunction &func, Dominance &dom, MemPool *memPool, const RCSummary *rcSummary, bool enabledDebug)
       : func(func),
         irMap(*func.GetIRMap()),
         ssaTab(*func.GetMeSSATab()),
         dominance(dom),
+        rcSummary(rcSummary),
         delegateRCAllocator(memPool),
         verStCantDelegate(irMap.GetVerst2MeExprTableSize(), false, delegateRCAllocator.Adapter()),
         verStUseCounts(irMap.GetVerst2MeExprTableSize(), 0, delegateRCAllocator.Adapter()),
@@ -52,6 +54,7 @@ class DelegateRC {
   bool FinalRefNoRC(const MeExpr &expr) const;
   void SetCantDelegate(const MapleMap<OStIdx, MeVarPhiNode*> &meVarPhiList);
   void SaveDerefedOrCopiedVst(const MeExpr *expr);
+  void SaveCantDecrefEarlyVst(const MeExpr *expr);
   void CollectDerefedOrCopied(const MeStmt &stmt);
   void CollectDerefedOrCopied(const MeExpr &expr);
   void CollectUsesInfo(const MeExpr &expr);
@@ -64,6 +67,7 @@ class DelegateRC {
   IRMap &irMap;
   SSATab &ssaTab;
   Dominance &dominance;
+  const RCSummary *rcSummary;                      // what callees do with their ref formals, may be null
   MapleAllocator delegateRCAllocator;
   MapleVector<bool> verStCantDelegate;             // true if it has appearance as phi opnd
   MapleVector<uint32> verStUseCounts;              // use counts of each SSA version
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
+#define MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
+#include <set>
+#include "me_function.h"
+#include "me_phase.h"
+#include "me_irmap.h"
+
+namespace maple {
+enum EscapeState : uint8 {
+  kNoEscape,      // only reachable from locals of the function
+  kArgEscape,     // reachable from the caller through a formal or the return value
+  kGlobalEscape   // reachable from statics, other threads or code we know nothing about
+};
+
+// bits of the per-formal summaries kept in MIRModule
+constexpr uint8 kParamEscapeGlobal = 0x1;   // the object or what it references may escape globally
+constexpr uint8 kParamReturned = 0x2;       // the object or what it references may be returned
+constexpr uint8 kParamFieldWritten = 0x4;   // fields of the object or of what it references may be written
+constexpr uint8 kParamEscapeAll = kParamEscapeGlobal | kParamReturned | kParamFieldWritten;
+
+enum EscapeNodeKind : uint8 {
+  kEscapeNodeUnknown,        // any object the function did not allocate and cannot name
+  kEscapeNodeFormal,         // the object a formal points to on entry
+  kEscapeNodeFormalContent,  // everything reachable from that object on entry
+  kEscapeNodeAlloc           // the objects allocated by one gcmalloc
+};
+
+struct EscapeNode {
+  EscapeNode(MapleAllocator &alloc, EscapeNodeKind nodeKind, const MeStmt *stmt, size_t formal)
+      : kind(nodeKind), allocStmt(stmt), formalIndex(formal), contents(alloc.Adapter()) {}
+
+  EscapeNodeKind kind;
+  const MeStmt *allocStmt;   // the allocating statement of kEscapeNodeAlloc
+  size_t formalIndex;        // the formal of kEscapeNodeFormal and kEscapeNodeFormalContent
+  EscapeState state = kNoEscape;
+  bool returned = false;
+  bool captured = false;      // stored into a field of some object
+  bool fieldWritten = false;  // one of its fields is written here or by a callee
+  MapleSet<uint32> contents;  // objects its fields may point to, fields are not told apart
+};
+
+// Flow-insensitive connection graph of the objects a function deals with, built over the SSA
+// versions of MeIR. Calls are resolved by the per-formal summaries that functions optimized
+// earlier left in the module; functions are optimized callees first, so the summaries of
+// non-recursive direct callees are available. Virtual and unknown calls let their arguments escape.
+// The only user is RCLowering: a new object passed to a call that leaves it alone keeps its
+// unwritten fields, so stores into them skip the decrement of the old value. Nothing is allocated
+// on the stack or scalar replaced, and no RC operation on the objects themselves is removed.
+class EscapeAnalysis : public AnalysisResult {
+ public:
+  using PointsToSet = std::set<uint32>;
+
+  EscapeAnalysis(MemPool &memPool, MeFunction &func, bool enabledDebug)
+      : AnalysisResult(&memPool),
+        func(func),
+        mirModule(func.GetMIRModule()),
+        ssaTab(*func.GetMeSSATab()),
+        escapeAlloc(&memPool),
+        nodes(escapeAlloc.Adapter()),
+        formalNodes(escapeAlloc.Adapter()),
+        allocNodes(escapeAlloc.Adapter()),
+        pointsTo(escapeAlloc.Adapter()),
+        returnedNodes(escapeAlloc.Adapter()),
+        enabledDebug(enabledDebug) {}
+
+  virtual ~EscapeAnalysis() = default;
+
+  void Run();
+  // the worst state of the objects expr may point to
+  EscapeState GetEscapeState(const MeStmt &stmt, const MeExpr &expr) const;
+  // true if expr points to a single object allocated here that the call can neither let escape nor
+  // write a field of, so what is known about its fields before the call holds after it
+  bool IsObjectUntouchedByCall(const MeStmt &call, const MeExpr &expr) const;
+  void Dump() const;
+
+ private:
+  uint32 NewNode(EscapeNodeKind kind, const MeStmt *stmt, size_t formalIndex);
+  void CreateNodes();
+  bool IsInitialEdge(const EscapeNode &from, const EscapeNode &to) const;
+  size_t GetFormalIndex(const OriginalSt &ost) const;
+  void GetPointsTo(const MeStmt &stmt, const MeExpr &expr, PointsToSet &result) const;
+  void GetVarPointsTo(const VarMeExpr &var, PointsToSet &result) const;
+  void GetRegPointsTo(const RegMeExpr &reg, PointsToSet &result) const;
+  void GetReachable(const PointsToSet &from, PointsToSet &result) const;
+  bool AddPointsTo(const MeExpr &lhs, const PointsToSet &objs);
+  bool AddContents(uint32 node, const PointsToSet &objs);
+  const MapleVector<uint8> *GetCallSummary(const MeStmt &call) const;
+  bool IsHarmlessIntrinsic(const MeStmt &stmt) const;
+  bool ProcessPhis(BB &bb);
+  bool ProcessStmt(MeStmt &stmt);
+  bool ProcessCall(MeStmt &stmt);
+  void PropagateEscapeState();
+  void RecordParamSummary();
+
+  MeFunction &func;
+  MIRModule &mirModule;
+  SSATab &ssaTab;
+  MapleAllocator escapeAlloc;
+  MapleVector<EscapeNode*> nodes;
+  MapleVector<uint32> formalNodes;                      // the kEscapeNodeFormal node of each formal
+  MapleMap<const MeStmt*, uint32> allocNodes;           // allocating statement to its node
+  MapleMap<int32, MapleSet<uint32>*> pointsTo;          // expr id of var and reg versions to objects
+  MapleSet<uint32> returnedNodes;
+  bool enabledDebug;
+};
+
+class MeDoEscapeAnalysis : public MeFuncPhase {
+ public:
+  explicit MeDoEscapeAnalysis(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoEscapeAnalysis() = default;
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr *mrm) override;
+  std::string PhaseName() const override {
+    return "escapeanalysis";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_ESCAPE_ANALYSIS_H
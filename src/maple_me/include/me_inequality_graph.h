@@ -16,6 +16,7 @@
 #define MAPLEME_INCLUDE_ME_INEQUALITY_GRAPH_H
 #include <iostream>
 #include <fstream>
+#include <tuple>
 #include <irmap.h>
 #include <me_function.h>
 
@@ -346,15 +347,38 @@ class InequalityGraph {
   int nodeCount;
 };
 
+// Proves the bounds of array indices on demand over one inequality graph built for a whole
+// function. The results of sub-proofs are memoized by (node, node, bound kind, query context): a
+// bound proven true is kept with the tightest value, one proven false with the loosest, so later
+// queries with any weaker or stronger bound get the answer without traversing the graph again. A
+// sub-proof is only memoized when it depends on no node or pair edge its callers made active or
+// invalid, i.e. when it is the same whatever path led to it. Edges that only some queries may use,
+// such as the bound of the array check being proven, are registered as query dependent. The query
+// context of a sub-proof that used or missed one of them is the set of query dependent edges its
+// query excludes, which decides every such edge; that of any other sub-proof is kSharedProveContext.
+constexpr uint32 kSharedProveContext = 0;
 class ABCD {
  public:
   static constexpr int kDFSLimit = 100000;
   explicit ABCD(InequalityGraph &graph) : inequalityGraph(&graph), recursiveCount(0) {}
   ~ABCD() = default;
 
-  bool DemandProve(const MeExpr &arrayNode, const MeExpr &idx);
+  void AddQueryDependentEdge(const InequalEdge &edge) {
+    (void)queryDependentEdges.insert(&edge);
+  }
+
+  // prove 0 <= idx < length(arrayNode) without the edges in excluded, which must be query dependent
+  bool DemandProve(const MeExpr &arrayNode, const MeExpr &idx, const std::vector<InequalEdge*> &excluded);
 
  private:
+  struct ProveCacheEntry {
+    bool hasTrue = false;
+    bool hasFalse = false;
+    int64 trueBound = 0;   // the hardest bound proven
+    int64 falseBound = 0;  // the easiest bound failed
+  };
+  using ProveCacheKey = std::tuple<const ESSABaseNode*, const ESSABaseNode*, EdgeType, uint32>;
+
   using MeetFunction = ProveResult (*)(ProveResult, ProveResult);
   static ProveResult Max(ProveResult res1, ProveResult res2) {
     if (res1 == kTrue || res2 == kTrue) {
@@ -376,14 +400,32 @@ class ABCD {
     return kReduced;
   }
 
+  // true if bound lhs is at least as easy to prove as bound rhs
+  static bool IsWeakerBound(EdgeType type, int64 lhs, int64 rhs) {
+    return type == kUpper ? lhs >= rhs : lhs <= rhs;
+  }
+
   bool DemandProve(ESSABaseNode &firstNode, ESSABaseNode &secondNode, EdgeType edgeType);
   ProveResult Prove(ESSABaseNode &a, ESSABaseNode &b, InequalEdge &e);
   ProveResult UpdateCacheResult(ESSABaseNode &a, ESSABaseNode &b, InequalEdge &e, MeetFunction meet);
+  bool IsUsableEdge(const InequalEdge &in, EdgeType type);
+  void InvalidatePairEdge(InequalEdge &in);
+  void ValidatePairEdge(InequalEdge &in);
+  bool LookupCache(const ProveCacheKey &key, int64 bound, ProveResult &res) const;
+  void UpdateCache(ProveCacheKey key, int64 bound, ProveResult res);
   void PrintTracing() const;
   InequalityGraph *inequalityGraph;
   std::map<ESSABaseNode*, InequalEdge*> active;
+  std::map<ESSABaseNode*, size_t> activeDepth;
+  std::map<const InequalEdge*, size_t> invalidPairDepth;  // the depth of the proof that disabled the pair edge
+  std::set<const InequalEdge*> queryDependentEdges;
+  std::map<ProveCacheKey, ProveCacheEntry> proveCache;
+  std::map<std::vector<const InequalEdge*>, uint32> queryContexts;  // sorted excluded edges -> context
+  uint32 queryContext = kSharedProveContext;                         // the context of the current query
   std::vector<ESSABaseNode*> tracing;
   int recursiveCount;
+  size_t minDependDepth = 0;   // the outermost enclosing proof the current one depends on
+  bool usesQueryEdge = false;  // the current proof used or missed a query dependent edge
 };
 } // namespace maple
 #endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_IVOPTS_H
+#define MAPLE_ME_INCLUDE_ME_IVOPTS_H
+#include <map>
+#include <set>
+#include <vector>
+#include "me_function.h"
+#include "me_phase.h"
+#include "me_irmap.h"
+#include "me_loop_analysis.h"
+
+namespace maple {
+// Induction variable strength reduction on the SSA form of MeIR. In innermost canonical loops, a
+// basic induction variable is a phi on the loop head whose value from the latch is the phi plus a
+// constant. Every address array(a, iv) with a loop invariant and no bounds check left is rewritten to
+// a + off, off being an offset induction variable shared by the arrays of the same type, initialized
+// to array(a, init) - a in the preheader and advanced by the element size times the step right after
+// iv is, so the lowerer no longer has to form the header plus iv * size on every access. The base
+// stays an operand of every access, which keeps a referenced object live and reachable by the
+// collector. When iv is then only used by the exit test, the test is rewritten to compare off against
+// array(a, n) - a instead (linear function test replacement) and iv is left for hdse to remove.
+class MeIVOpts {
+ public:
+  MeIVOpts(MeFunction &func, MeIRMap &irMap, IdentifyLoops &identLoops, bool enabledDebug)
+      : func(func), irMap(irMap), identLoops(identLoops), enabledDebug(enabledDebug) {}
+
+  ~MeIVOpts() = default;
+
+  // returns true if some loop was changed
+  bool Run();
+
+ private:
+  struct BasicIV {
+    MeVarPhiNode *phi = nullptr;
+    VarMeExpr *init = nullptr;     // the value coming from the preheader
+    VarMeExpr *next = nullptr;     // the value coming from the latch
+    MeStmt *incStmt = nullptr;     // next = phi + step
+    int64 step = 0;
+  };
+
+  struct OffsetIV {
+    NaryMeExpr *array = nullptr;   // array(a, iv), iv being the phi of the basic iv
+    RegMeExpr *cur = nullptr;      // the phi on the loop head, equal to array - a
+    RegMeExpr *next = nullptr;     // defined right after the increment of the basic iv
+  };
+
+  bool IsInvariant(MeExpr &expr, const LoopDesc &loop) const;
+  bool IsCandidateIV(const VarMeExpr &var) const;
+  bool FindBasicIV(const LoopDesc &loop, MeVarPhiNode &phi, BasicIV &iv) const;
+  void CollectBBsAfterInc(const LoopDesc &loop, const BasicIV &iv);
+  bool SeesIVOnHead(const MeStmt &stmt, const BasicIV &iv) const;
+  static int64 GetElemSize(const NaryMeExpr &array);
+  static PrimType GetOffsetType(const NaryMeExpr &array);
+  bool IsReducibleArray(const MeExpr &expr, const LoopDesc &loop, const BasicIV &iv) const;
+  void CollectArrays(MeExpr &expr, const LoopDesc &loop, const BasicIV &iv, std::vector<NaryMeExpr*> &arrays) const;
+  MeExpr *CreateArrayAt(const NaryMeExpr &array, MeExpr &index);
+  MeExpr *CreateOffsetAt(const NaryMeExpr &array, MeExpr &index);
+  OffsetIV CreateOffsetIV(const LoopDesc &loop, const BasicIV &iv, NaryMeExpr &array);
+  void StrengthReduce(const LoopDesc &loop, const BasicIV &iv, std::vector<OffsetIV> &offsetIVs);
+  static bool IsNonNegative(const MeExpr &expr);
+  bool HasOtherUses(const MeExpr &expr, const MeExpr &target) const;
+  bool IsIVUsedElsewhere(const BasicIV &iv, const MeStmt &test) const;
+  bool ReplaceTest(const LoopDesc &loop, const BasicIV &iv, const OffsetIV &offsetIV, MeStmt &test);
+  void ReplaceExitTests(const LoopDesc &loop, const BasicIV &iv, const OffsetIV &offsetIV);
+  bool IsInnermost(const LoopDesc &loop) const;
+  bool OptimizeLoop(const LoopDesc &loop);
+
+  MeFunction &func;
+  MeIRMap &irMap;
+  IdentifyLoops &identLoops;
+  bool enabledDebug;
+  std::set<BBId> bbsAfterInc;  // loop bbs reached from the increment of the current iv without passing the head
+  uint32 reducedArrays = 0;
+  uint32 replacedTests = 0;
+};
+
+class MeDoIVOpts : public MeFuncPhase {
+ public:
+  explicit MeDoIVOpts(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoIVOpts() = default;
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) override;
+  std::string PhaseName() const override {
+    return "ivopts";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_IVOPTS_H
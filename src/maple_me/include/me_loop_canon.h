@@ -40,9 +40,9 @@ class MeDoLoopCanon : public MeFuncPhase {
   bool IsDoWhileLoop(MeFunction &func, const LoopDesc &loop) const;
   void Merge(MeFunction &func);
   void AddPreheader(MeFunction &func);
-  void InsertNewExitBB(MeFunction &func, LoopDesc &loop);
-  void InsertExitBB(MeFunction &func, LoopDesc &loop);
-  void SplitCondGotBB(MeFunction &func, LoopDesc &loop);
+  void InsertNewExitBB(MeFunction &func, LoopDesc &loop, Dominance *dom);
+  void InsertExitBB(MeFunction &func, LoopDesc &loop, Dominance *dom);
+  bool SplitCondGotBB(MeFunction &func, LoopDesc &loop);
   void ExecuteLoopCanon(MeFunction &func, MeFuncResultMgr &m, Dominance &dom);
   void ExecuteLoopNormalization(MeFunction &func,  MeFuncResultMgr *m, Dominance &dom);
 };
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_LOOP_VERSIONING_H
+#define MAPLE_ME_INCLUDE_ME_LOOP_VERSIONING_H
+#include <set>
+#include <vector>
+#include "me_function.h"
+#include "me_phase.h"
+#include "me_loop_analysis.h"
+#include "dominance.h"
+
+namespace maple {
+// Versions innermost counted loops of the form
+//   do { ... a[iv] ... iv = iv + 1 } while (iv < n)
+// where the arrays and n are loop invariant. Checks placed on loop entry make sure every index the
+// loop can use is within the arrays, and branch to a clone of the loop whose accesses through iv
+// have their bounds checks removed; when one of them fails, the original loop runs unchanged.
+// Works on the statements of the cfg before SSA, right after loop canonicalization.
+class LoopVersioning {
+ public:
+  LoopVersioning(MeFunction &func, IdentifyLoops &identLoops, Dominance &dom, bool enabledDebug)
+      : func(func), mirModule(func.GetMIRModule()), identLoops(identLoops), dom(dom), enabledDebug(enabledDebug) {}
+
+  ~LoopVersioning() = default;
+
+  // returns true if some loop was versioned
+  bool Run();
+
+ private:
+  struct Candidate {
+    LoopDesc *loop = nullptr;
+    StIdx ivStIdx;
+    BaseNode *bound = nullptr;  // n
+    bool inclusive = false;     // the loop continues while iv <= n rather than iv < n
+    std::vector<StIdx> bases;   // the arrays indexed by iv, in order of appearance
+    std::set<const StmtNode*> checkedStmts;  // where an access sees the value iv has on loop head
+  };
+
+  void CollectAddrTaken(const BaseNode &expr);
+  void CollectLoopDefs(const LoopDesc &loop);
+  bool IsInvariantLocal(const BaseNode &expr) const;
+  bool IsInvariantBound(const BaseNode &expr) const;
+  bool IsIvRead(const BaseNode &expr, const StIdx &ivStIdx) const;
+  bool IsIncrement(const StmtNode &stmt, const StIdx &ivStIdx) const;
+  bool IsVersionableArray(const BaseNode &expr, const Candidate &cand) const;
+  BB *GetTestBB(const LoopDesc &loop) const;
+  bool AnalyzeTest(const LoopDesc &loop, const BB &testBB, Candidate &cand) const;
+  bool CollectCheckedStmts(const BB &testBB, Candidate &cand) const;
+  void CollectArrayBases(const BaseNode &expr, Candidate &cand) const;
+  void ClearBoundsChecks(BaseNode &expr, const Candidate &cand) const;
+  bool IsCandidateLoop(const LoopDesc &loop) const;
+  BaseNode *CreateArrayLength(const StIdx &arrayStIdx) const;
+  BaseNode *CreateDread(const StIdx &stIdx, PrimType primType) const;
+  void CreateEntryChecks(const Candidate &cand, std::vector<BaseNode*> &conds) const;
+  BB *NewBBOutsideLoop(const BB &preheader, BBKind kind);
+  void Version(const Candidate &cand);
+
+  MeFunction &func;
+  MIRModule &mirModule;
+  IdentifyLoops &identLoops;
+  Dominance &dom;
+  std::set<StIdx> addrTaken;  // locals whose address is taken somewhere in the function
+  std::set<StIdx> loopDefs;   // locals assigned in the loop being looked at
+  bool enabledDebug;
+};
+
+class MeDoLoopVersioning : public MeFuncPhase {
+ public:
+  explicit MeDoLoopVersioning(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoLoopVersioning() = default;
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) override;
+  std::string PhaseName() const override {
+    return "loopversioning";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_LOOP_VERSIONING_H
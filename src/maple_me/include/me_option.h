@@ -95,6 +95,9 @@ class MeOption : public MapleDriverOptionBase {
   static bool lpreSpeculate;
   static bool spillAtCatch;
   static bool optDirectCall;
+  static bool memPoolStat;
+  static bool releaseDeadResults;
+  static bool escapeAnalysis;
  private:
   void DecideMeRealLevel(const std::vector<mapleOption::Option> &inputOptions) const;
   std::unordered_set<std::string> skipPhases;
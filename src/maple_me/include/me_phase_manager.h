@@ -14,6 +14,8 @@
  */
 #ifndef MAPLE_ME_INCLUDE_ME_PHASE_MANAGER_H
 #define MAPLE_ME_INCLUDE_ME_PHASE_MANAGER_H
+#include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include "mempool.h"
@@ -89,6 +91,19 @@ class MeFuncPhaseManager : public PhaseManager {
   }
 
  private:
+  // mempool usage of the function being optimized, collected with --mempool-stat
+  struct MemPoolStat {
+    size_t peakBytes = 0;
+    std::string peakPhase;
+    size_t releasedBytes = 0;
+  };
+
+  void ComputeResultLastUses();
+  void ReleaseDeadResults(MeFunction &func, size_t phaseIndex);
+  void CheckRecomputedResults(MeFunction &func, const MeFuncPhase &phase, size_t phaseIndex);
+  void RecordMemPoolStat(MeFunction &func, const MeFuncPhase &phase);
+  void DumpMemPoolStat(const MeFunction &func) const;
+
   // analysis phase result manager
   MeFuncResultMgr arFuncManager{ GetMemAllocator() };
   MIRModule &mirModule;
@@ -97,6 +112,13 @@ class MeFuncPhaseManager : public PhaseManager {
   bool genMeMpl = false;
   bool timePhases = false;
   bool ipa = false;
+  // index of the last phase in the sequence that may use the result of an analysis
+  std::map<MePhaseID, size_t> resultLastUses;
+  size_t resultLastUsesSeqSize = 0;
+  // consumers missing from the table of result consumers, found when a released result was asked for again
+  std::map<MePhaseID, std::set<MePhaseID>> foundConsumers;
+  std::set<MePhaseID> releasedResults;  // of the function being optimized
+  MemPoolStat memPoolStat;
 };
 }  // namespace maple
 #endif  // MAPLE_ME_INCLUDE_ME_PHASE_MANAGER_H
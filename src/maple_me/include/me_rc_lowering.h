@@ -19,6 +19,7 @@
 #include "me_irmap.h"
 #include "me_phase.h"
 #include "mir_builder.h"
+#include "me_escape_analysis.h"
 
 namespace maple {
 class RCLowering {
@@ -41,6 +42,10 @@ class RCLowering {
     return isAnalyzed;
   }
 
+  void SetEscapeAnalysis(EscapeAnalysis *analysis) {
+    escapeAnalysis = analysis;
+  }
+
  private:
   void MarkLocalRefVar();
   void MarkAllRefOpnds();
@@ -106,6 +111,8 @@ class RCLowering {
   std::map<OStIdx, OriginalSt*> varOStMap{};
   // used to store initialized map, help to optimize dec ref in first assignment
   std::unordered_map<MeExpr*, std::set<FieldID>> initializedFields{};
+  // tells which new objects a call leaves alone, so that what is known about their fields survives it
+  EscapeAnalysis *escapeAnalysis = nullptr;
   bool enabledDebug;
 };
 
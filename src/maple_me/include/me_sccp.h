@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MAPLE_ME_INCLUDE_ME_SCCP_H
+#define MAPLE_ME_INCLUDE_ME_SCCP_H
+#include <set>
+#include <vector>
+#include "me_function.h"
+#include "me_phase.h"
+#include "me_irmap.h"
+#include "constantfold.h"
+
+namespace maple {
+// Sparse conditional constant propagation (Wegman and Zadeck) over the SSA form of MeIR.
+// Integer scalars defined by dassign, regassign and phis get a lattice value, phis only merging
+// the operands whose incoming edge has been found executable and conditional branches only making
+// the edges their condition allows executable. Afterwards the constant values replace their uses,
+// branches and switches on constants become gotos and the blocks no longer reachable are removed.
+// Operations on constants are evaluated by the tree-level ConstantFold, so both agree on semantics.
+class MeSCCP {
+ public:
+  MeSCCP(MeFunction &func, MeIRMap &irMap, bool enabledDebug)
+      : func(func), irMap(irMap), constantFold(func.GetMIRModule()), enabledDebug(enabledDebug) {}
+
+  ~MeSCCP() = default;
+
+  // returns true if the cfg was changed
+  bool Run();
+
+ private:
+  enum LatticeKind {
+    kLatticeTop,    // no definition seen executed yet
+    kLatticeConst,
+    kLatticeBottom  // may have more than one value
+  };
+
+  struct LatticeValue {
+    LatticeKind kind = kLatticeTop;
+    int64 value = 0;
+
+    bool operator==(const LatticeValue &other) const {
+      return kind == other.kind && (kind != kLatticeConst || value == other.value);
+    }
+
+    bool operator!=(const LatticeValue &other) const {
+      return !(*this == other);
+    }
+  };
+
+  struct PhiUse {
+    BB *bb;
+    MeVarPhiNode *varPhi;
+    MeRegPhiNode *regPhi;
+  };
+
+  static LatticeValue Bottom() {
+    LatticeValue result;
+    result.kind = kLatticeBottom;
+    return result;
+  }
+
+  static LatticeValue Const(int64 value) {
+    LatticeValue result;
+    result.kind = kLatticeConst;
+    result.value = value;
+    return result;
+  }
+
+  static LatticeValue Meet(const LatticeValue &a, const LatticeValue &b);
+  static bool IsTrackedType(PrimType primType) {
+    return IsPrimitivePureScalar(primType);
+  }
+
+  void CollectUses(MeExpr &expr, MeStmt &stmt);
+  void BuildUses();
+  LatticeValue &GetValue(const MeExpr &expr);
+  void SetValue(MeExpr &expr, const LatticeValue &value);
+  LatticeValue EvaluateDef(MeExpr &expr);
+  LatticeValue EvaluateOp(OpMeExpr &expr);
+  LatticeValue FoldOp(OpMeExpr &expr, const std::vector<LatticeValue> &opnds);
+  LatticeValue Evaluate(MeExpr &expr);
+  void AddEdge(BB &pred, BB &succ);
+  bool IsEdgeExecutable(const BB &pred, const BB &succ) const;
+  BB *GetSwitchTarget(SwitchMeStmt &switchStmt, int64 value);
+  void VisitVarPhi(const BB &bb, MeVarPhiNode &phi);
+  void VisitRegPhi(const BB &bb, MeRegPhiNode &phi);
+  void VisitPhis(BB &bb);
+  void VisitStmt(MeStmt &stmt);
+  void VisitBB(BB &bb);
+  void Propagate();
+  void ReplaceBranch(BB &bb, MeStmt &branch, BB &target);
+  void FoldBranch(BB &bb, MeStmt &branch);
+  void CollectConstExprs(MeExpr &expr, std::vector<MeExpr*> &constExprs);
+  void ReplaceConstUses(MeStmt &stmt);
+  bool Rewrite();
+
+  MeFunction &func;
+  MeIRMap &irMap;
+  ConstantFold constantFold;
+  bool enabledDebug;
+  std::vector<LatticeValue> values;                  // indexed by expr id
+  std::vector<std::vector<MeStmt*>> stmtUses;        // indexed by expr id of var and reg versions
+  std::vector<std::vector<PhiUse>> phiUses;          // indexed by expr id of var and reg versions
+  std::vector<bool> executableBBs;                   // indexed by bb id
+  std::set<std::pair<BBId, BBId>> executableEdges;
+  std::vector<std::pair<BB*, BB*>> cfgWorkList;
+  std::vector<MeExpr*> ssaWorkList;
+  uint32 replacedUses = 0;
+  uint32 foldedBranches = 0;
+};
+
+class MeDoSCCP : public MeFuncPhase {
+ public:
+  explicit MeDoSCCP(MePhaseID id) : MeFuncPhase(id) {}
+
+  virtual ~MeDoSCCP() = default;
+  AnalysisResult *Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) override;
+  std::string PhaseName() const override {
+    return "sccp";
+  }
+};
+}  // namespace maple
+#endif  // MAPLE_ME_INCLUDE_ME_SCCP_H
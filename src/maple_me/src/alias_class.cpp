@@ -18,6 +18,7 @@
 #include "ssa_mir_nodes.h"
 #include "mir_function.h"
 #include "mir_builder.h"
+#include "mod_ref.h"
 
 namespace {
 using namespace maple;
@@ -883,38 +884,43 @@ void AliasClass::CollectMayDefForMustDefs(const StmtNode &stmt, std::set<Origina
   }
 }
 
-void AliasClass::CollectMayUseForCallOpnd(const StmtNode &stmt, std::set<OriginalSt*> &mayUseOsts) {
-  for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
-    BaseNode *expr = stmt.Opnd(i);
-    if (!IsPotentialAddress(expr->GetPrimType())) {
-      continue;
-    }
+// collect the osts opnd may point to; return false if they are left to the not_all_def_seen_ae
+bool AliasClass::CollectMayUseForOpnd(BaseNode &opnd, std::set<OriginalSt*> &mayUseOsts) {
+  if (!IsPotentialAddress(opnd.GetPrimType())) {
+    return true;
+  }
 
-    AliasElem *aliasElem = CreateAliasElemsExpr(*expr);
-    if (aliasElem == nullptr || aliasElem->IsNextLevNotAllDefsSeen()) {
-      continue;
-    }
+  AliasElem *aliasElem = CreateAliasElemsExpr(opnd);
+  if (aliasElem == nullptr || aliasElem->IsNextLevNotAllDefsSeen()) {
+    return false;
+  }
 
-    if (GlobalTables::GetTypeTable().GetTypeFromTyIdx(aliasElem->GetOriginalSt().GetTyIdx())->PointsToConstString()) {
-      continue;
-    }
+  if (GlobalTables::GetTypeTable().GetTypeFromTyIdx(aliasElem->GetOriginalSt().GetTyIdx())->PointsToConstString()) {
+    return true;
+  }
 
-    for (OriginalSt *nextLevelOst : *(GetAliasAnalysisTable()->GetNextLevelNodes(aliasElem->GetOriginalSt()))) {
-      AliasElem *indAe = FindAliasElem(*nextLevelOst);
+  for (OriginalSt *nextLevelOst : *(GetAliasAnalysisTable()->GetNextLevelNodes(aliasElem->GetOriginalSt()))) {
+    AliasElem *indAe = FindAliasElem(*nextLevelOst);
 
-      if (indAe->GetOriginalSt().IsFinal()) {
-        continue;
-      }
+    if (indAe->GetOriginalSt().IsFinal()) {
+      continue;
+    }
 
-      if (indAe->GetClassSet() == nullptr) {
-        mayUseOsts.insert(&indAe->GetOriginalSt());
-      } else {
-        for (unsigned int elemID : *(indAe->GetClassSet())) {
-          mayUseOsts.insert(&id2Elem[elemID]->GetOriginalSt());
-        }
+    if (indAe->GetClassSet() == nullptr) {
+      mayUseOsts.insert(&indAe->GetOriginalSt());
+    } else {
+      for (unsigned int elemID : *(indAe->GetClassSet())) {
+        mayUseOsts.insert(&id2Elem[elemID]->GetOriginalSt());
       }
     }
   }
+  return true;
+}
+
+void AliasClass::CollectMayUseForCallOpnd(const StmtNode &stmt, std::set<OriginalSt*> &mayUseOsts) {
+  for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+    (void)CollectMayUseForOpnd(*stmt.Opnd(i), mayUseOsts);
+  }
 }
 
 void AliasClass::InsertMayDefNodeForCall(std::set<OriginalSt*> &mayDefOsts, MapleMap<OStIdx, MayDefNode> &mayDefNodes,
@@ -931,7 +937,12 @@ void AliasClass::InsertMayDefNodeForCall(std::set<OriginalSt*> &mayDefOsts, Mapl
 // Insert mayDefs and mayUses for the callees.
 // Four kinds of mayDefs and mayUses are inserted, which are caused by callee
 // opnds, not_all_def_seen_ae, globalsAffectedByCalls, and mustDefs.
-void AliasClass::InsertMayDefUseCall(StmtNode &stmt, bool hasSideEffect, bool hasNoPrivateDefEffect) {
+void AliasClass::InsertMayDefUseCall(StmtNode &stmt, bool hasSideEffect, bool hasNoPrivateDefEffect,
+                                     const FuncModRef *calleeModRef) {
+  if (hasSideEffect && calleeModRef != nullptr) {
+    InsertMayDefUseCallWithModRef(stmt, hasNoPrivateDefEffect, *calleeModRef);
+    return;
+  }
   auto *theSSAPart = static_cast<MayDefMayUsePart*>(ssaTab.GetStmtsSSAPart().SSAPartOf(stmt));
   std::set<OriginalSt*> mayDefUseOstsA;
   // 1. collect mayDefs and mayUses caused by callee-opnds
@@ -959,6 +970,122 @@ void AliasClass::InsertMayDefUseCall(StmtNode &stmt, bool hasSideEffect, bool ha
   }
 }
 
+// the mod/ref summary of a direct callee, nullptr if its effects are unknown
+const FuncModRef *AliasClass::GetCalleeModRef(const StmtNode &stmt) const {
+  if (modRefAnalysis == nullptr || calleeHasSideEffect) {
+    return nullptr;
+  }
+  Opcode op = stmt.GetOpCode();
+  if (op != OP_call && op != OP_callassigned && op != OP_superclasscall && op != OP_superclasscallassigned) {
+    return nullptr;
+  }
+  const FuncModRef *calleeModRef = modRefAnalysis->GetSummary(static_cast<const CallNode&>(stmt).GetPUIdx());
+  return (calleeModRef == nullptr || calleeModRef->IsUnknown()) ? nullptr : calleeModRef;
+}
+
+// whether ost is an array element or lies in memory found through one: arrays are covariant in Java,
+// so the callee may have stored the element as any supertype of what we read it as
+bool AliasClass::IsReachedThroughJarray(const OriginalSt &ost) const {
+  const OriginalSt *cur = &ost;
+  while (cur != nullptr && cur->GetIndirectLev() > 0) {
+    const OriginalSt *prevLevOst =
+        (aliasAnalysisTable == nullptr) ? nullptr : aliasAnalysisTable->GetPrevLevelNode(*cur);
+    if (prevLevOst == nullptr) {
+      return true;
+    }
+    const MIRType *prevType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(prevLevOst->GetTyIdx());
+    if (prevType->IsMIRPtrType()) {
+      const MIRType *pointedType = static_cast<const MIRPtrType*>(prevType)->GetPointedType();
+      if (pointedType == nullptr || pointedType->IsMIRJarrayType()) {
+        return true;
+      }
+    }
+    cur = prevLevOst;
+  }
+  return false;
+}
+
+// memory reached through pointers is told apart by the type of the field or element; only Java keeps
+// the type of a field the same in every function accessing it
+bool AliasClass::MayBeModifiedByCallee(const OriginalSt &ost, const FuncModRef &calleeModRef) const {
+  if (ost.GetIndirectLev() <= 0 || !mirModule.IsJavaModule()) {
+    return true;
+  }
+  PrimType primType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(ost.GetTyIdx())->GetPrimType();
+  if (primType == PTY_agg || primType == PTY_void || IsReachedThroughJarray(ost)) {
+    return true;
+  }
+  return calleeModRef.MayModHeapType(ost.GetTyIdx());
+}
+
+// Insert mayDefs and mayUses for a direct call to a function IPA summarized: the same four kinds as
+// InsertMayDefUseCall, each kept only if the callee may read or write it.
+void AliasClass::InsertMayDefUseCallWithModRef(StmtNode &stmt, bool hasNoPrivateDefEffect,
+                                               const FuncModRef &calleeModRef) {
+  auto *theSSAPart = static_cast<MayDefMayUsePart*>(ssaTab.GetStmtsSSAPart().SSAPartOf(stmt));
+  std::set<OriginalSt*> mayUseOstsA;
+  std::set<OriginalSt*> mayDefOstsA;
+  // 1. callee-opnds, written only if the callee writes through the formal
+  bool mayDefNADS = calleeModRef.MayModUnrelatedHeap();
+  for (size_t i = 0; i < stmt.NumOpnds(); ++i) {
+    std::set<OriginalSt*> opndOsts;
+    if (!CollectMayUseForOpnd(*stmt.Opnd(i), opndOsts)) {
+      mayDefNADS = mayDefNADS || calleeModRef.MayModThroughFormal(i);
+      continue;
+    }
+    mayUseOstsA.insert(opndOsts.begin(), opndOsts.end());
+    if (calleeModRef.MayModThroughFormal(i)) {
+      mayDefOstsA.insert(opndOsts.begin(), opndOsts.end());
+    }
+  }
+  // 2. not_all_def_seen_ae
+  std::set<OriginalSt*> nadsOsts;
+  CollectMayUseFromNADS(nadsOsts);
+  mayUseOstsA.insert(nadsOsts.begin(), nadsOsts.end());
+  if (mayDefNADS) {
+    mayDefOstsA.insert(nadsOsts.begin(), nadsOsts.end());
+  }
+  if (calleeModRef.MayRefHeap()) {
+    InsertMayUseNode(mayUseOstsA, theSSAPart->GetMayUseNodes());
+  }
+  for (auto it = mayDefOstsA.begin(); it != mayDefOstsA.end();) {
+    it = MayBeModifiedByCallee(**it, calleeModRef) ? std::next(it) : mayDefOstsA.erase(it);
+  }
+  InsertMayDefNodeForCall(mayDefOstsA, theSSAPart->GetMayDefNodes(), stmt, hasNoPrivateDefEffect);
+  // 3. globalsAffectedByCalls, by symbol; what global pointers point to is memory like any other
+  std::set<OriginalSt*> globalOsts;
+  CollectMayUseFromGlobalsAffectedByCalls(globalOsts);
+  std::set<OriginalSt*> mayUseOstsB;
+  std::set<OriginalSt*> mayDefOstsB;
+  for (OriginalSt *ost : globalOsts) {
+    bool mayRef = false;
+    bool mayDef = false;
+    if (ost->GetIndirectLev() > 0) {
+      mayRef = calleeModRef.MayRefHeap();
+      mayDef = calleeModRef.MayModHeap() && MayBeModifiedByCallee(*ost, calleeModRef);
+    } else {
+      StIdx stIdx = ost->GetMIRSymbol()->GetStIdx();
+      mayRef = calleeModRef.MayRefGlobal(stIdx);
+      // outside Java a global may also be written through a pointer to it
+      mayDef = calleeModRef.MayModGlobal(stIdx) || (!mirModule.IsJavaModule() && calleeModRef.MayModHeap());
+    }
+    if (mayRef || mayDef) {
+      mayUseOstsB.insert(ost);
+    }
+    if (mayDef) {
+      mayDefOstsB.insert(ost);
+    }
+  }
+  InsertMayUseNode(mayUseOstsB, theSSAPart->GetMayUseNodes());
+  InsertMayDefNodeExcludeFinalOst(mayDefOstsB, theSSAPart->GetMayDefNodes(), stmt);
+  if (kOpcodeInfo.IsCallAssigned(stmt.GetOpCode())) {
+    // 4. insert mayDefs caused by the mustDefs
+    std::set<OriginalSt*> mayDefOstsC;
+    CollectMayDefForMustDefs(stmt, mayDefOstsC);
+    InsertMayDefNodeExcludeFinalOst(mayDefOstsC, theSSAPart->GetMayDefNodes(), stmt);
+  }
+}
+
 void AliasClass::InsertMayUseNodeExcludeFinalOst(const std::set<OriginalSt*> &mayUseOsts,
                                                  MapleMap<OStIdx, MayUseNode> &mayUseNodes) {
   for (OriginalSt *mayUseOst : mayUseOsts) {
@@ -1056,7 +1183,7 @@ void AliasClass::GenericInsertMayDefUse(StmtNode &stmt, BBId bbID) {
     case OP_polymorphiccall:
     case OP_icall: {
       InsertMayDefUseCall(stmt, CallHasSideEffect(static_cast<CallNode&>(stmt)),
-          CallHasNoPrivateDefEffect(static_cast<CallNode&>(stmt)));
+          CallHasNoPrivateDefEffect(static_cast<CallNode&>(stmt)), GetCalleeModRef(stmt));
       return;
     }
     case OP_intrinsiccallwithtype: {
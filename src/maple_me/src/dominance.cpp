@@ -174,6 +174,152 @@ bool Dominance::Dominate(const BB &bb1, const BB &bb2) {
   return false;
 }
 
+/* ================= for incremental update ================= */
+void Dominance::GrowToBBVec() {
+  size_t size = bbVec.size();
+  if (domFrontier.size() >= size) {
+    return;
+  }
+  domFrontier.resize(size, MapleSet<BBId>(domAllocator.Adapter()));
+  domChildren.resize(size, MapleSet<BBId>(domAllocator.Adapter()));
+  pdomFrontier.resize(size, MapleSet<BBId>(domAllocator.Adapter()));
+  pdomChildren.resize(size, MapleSet<BBId>(domAllocator.Adapter()));
+}
+
+bool Dominance::IsReachable(const BB &bb) const {
+  auto it = doms.find(bb.GetBBId());
+  return it != doms.end() && it->second != nullptr;
+}
+
+// Splitting pred->succ leaves every dominator tree edge in place but those of newBB and succ:
+// newBB is dominated by pred, and it takes pred's place as idom of succ when succ can only be
+// entered through that edge, i.e. when succ was dominated by pred and dominates its other preds.
+// The frontiers of all other blocks are the same as newBB lies on no new path.
+void Dominance::UpdateDomAfterSplitEdge(BB &pred, BB &newBB, BB &succ) {
+  if (!IsReachable(pred) || !IsReachable(succ)) {
+    return;
+  }
+  doms[newBB.GetBBId()] = &pred;
+  (void)domChildren[pred.GetBBId()].insert(newBB.GetBBId());
+  bool newBBIsIDom = (doms[succ.GetBBId()] == &pred) && !CommonEntryBBIsPred(succ);
+  for (size_t i = 0; newBBIsIDom && i < succ.GetPred().size(); ++i) {
+    BB *otherPred = succ.GetPred(i);
+    if (otherPred != &newBB && IsReachable(*otherPred) && !Dominate(succ, *otherPred)) {
+      newBBIsIDom = false;
+    }
+  }
+  MapleSet<BBId> &newFrontier = domFrontier[newBB.GetBBId()];
+  newFrontier.clear();
+  if (!newBBIsIDom) {
+    (void)newFrontier.insert(succ.GetBBId());
+    return;
+  }
+  doms[succ.GetBBId()] = &newBB;
+  (void)domChildren[pred.GetBBId()].erase(succ.GetBBId());
+  (void)domChildren[newBB.GetBBId()].insert(succ.GetBBId());
+  newFrontier = domFrontier[succ.GetBBId()];
+  (void)newFrontier.erase(succ.GetBBId());
+}
+
+// the mirror image of UpdateDomAfterSplitEdge on the reverse CFG
+void Dominance::UpdatePdomAfterSplitEdge(BB &pred, BB &newBB, BB &succ) {
+  auto succIt = pdoms.find(succ.GetBBId());
+  if (succIt == pdoms.end() || succIt->second == nullptr) {
+    return;
+  }
+  pdoms[newBB.GetBBId()] = &succ;
+  (void)pdomChildren[succ.GetBBId()].insert(newBB.GetBBId());
+  MapleSet<BBId> &newFrontier = pdomFrontier[newBB.GetBBId()];
+  newFrontier.clear();
+  auto predIt = pdoms.find(pred.GetBBId());
+  if (&pred == &commonEntryBB || predIt == pdoms.end() || predIt->second == nullptr) {
+    return;
+  }
+  bool newBBIsIPdom = (predIt->second == &succ) && !pred.GetAttributes(kBBAttrIsExit);
+  for (size_t i = 0; newBBIsIPdom && i < pred.GetSucc().size(); ++i) {
+    BB *otherSucc = pred.GetSucc(i);
+    auto otherIt = pdoms.find(otherSucc->GetBBId());
+    if (otherSucc != &newBB && otherIt != pdoms.end() && otherIt->second != nullptr &&
+        !PostDominate(pred, *otherSucc)) {
+      newBBIsIPdom = false;
+    }
+  }
+  if (!newBBIsIPdom) {
+    (void)newFrontier.insert(pred.GetBBId());
+    return;
+  }
+  pdoms[pred.GetBBId()] = &newBB;
+  (void)pdomChildren[succ.GetBBId()].erase(pred.GetBBId());
+  (void)pdomChildren[newBB.GetBBId()].insert(pred.GetBBId());
+  newFrontier = pdomFrontier[pred.GetBBId()];
+  (void)newFrontier.erase(pred.GetBBId());
+}
+
+void Dominance::UpdateAfterSplitEdge(BB &pred, BB &newBB, BB &succ) {
+  GrowToBBVec();
+  UpdateDomAfterSplitEdge(pred, newBB, succ);
+  UpdatePdomAfterSplitEdge(pred, newBB, succ);
+}
+
+// the preorders and their positions of both trees, postorder ids are not kept after the analysis phase
+void Dominance::UpdateTreeOrders() {
+  GrowToBBVec();
+  size_t num = 0;
+  dtPreOrder.assign(bbVec.size(), BBId(0));
+  ComputeDtPreorder(commonEntryBB, num);
+  dtPreOrder.resize(num);
+  dtDfn.assign(bbVec.size(), -1);
+  ComputeDtDfn();
+  num = 0;
+  pdtPreOrder.assign(bbVec.size(), BBId(0));
+  ComputePdtPreorder(commonExitBB, num);
+  pdtPreOrder.resize(num);
+  pdtDfn.assign(bbVec.size(), -1);
+  ComputePdtDfn();
+}
+
+void Dominance::DumpTrees() const {
+  for (size_t i = 0; i < bbVec.size(); ++i) {
+    auto it = doms.find(BBId(i));
+    if (it == doms.end() || it->second == nullptr) {
+      continue;
+    }
+    LogInfo::MapleLogger() << "bb:" << i << " im_dom is bb:" << it->second->GetBBId() << " domfrontier: [";
+    for (BBId id : domFrontier[i]) {
+      LogInfo::MapleLogger() << id << " ";
+    }
+    LogInfo::MapleLogger() << "] domchildren: [";
+    for (BBId id : domChildren[i]) {
+      LogInfo::MapleLogger() << id << " ";
+    }
+    LogInfo::MapleLogger() << "] dtdfn: " << dtDfn[i] << "\n";
+  }
+  for (size_t i = 0; i < bbVec.size(); ++i) {
+    auto it = pdoms.find(BBId(i));
+    if (it == pdoms.end() || it->second == nullptr) {
+      continue;
+    }
+    LogInfo::MapleLogger() << "bb:" << i << " im_pdom is bb:" << it->second->GetBBId() << " pdomfrontier: [";
+    for (BBId id : pdomFrontier[i]) {
+      LogInfo::MapleLogger() << id << " ";
+    }
+    LogInfo::MapleLogger() << "] pdomchildren: [";
+    for (BBId id : pdomChildren[i]) {
+      LogInfo::MapleLogger() << id << " ";
+    }
+    LogInfo::MapleLogger() << "] pdtdfn: " << pdtDfn[i] << "\n";
+  }
+  LogInfo::MapleLogger() << "preorder traversal of dominator tree:";
+  for (BBId id : dtPreOrder) {
+    LogInfo::MapleLogger() << id << " ";
+  }
+  LogInfo::MapleLogger() << "\npreorder traversal of post-dominator tree:";
+  for (BBId id : pdtPreOrder) {
+    LogInfo::MapleLogger() << id << " ";
+  }
+  LogInfo::MapleLogger() << "\n";
+}
+
 /* ================= for PostDominance ================= */
 void Dominance::PdomPostOrderWalk(const BB &bb, int32 &pid, std::vector<bool> &visitedMap) {
   ASSERT(bb.GetBBId() < visitedMap.size(), "index out of range in  Dominance::PdomPostOrderWalk");
@@ -13,6 +13,7 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "me_abco.h"
+#include <algorithm>
 
 // This phase removes redundant array bounds checks.
 // ABCD: Eliminating Array Bounds Checks on Demand.
@@ -650,13 +651,13 @@ void MeABC::BuildSoloPiInGraph(const PiassignMeStmt &piMeStmt) {
   (void)inequalityGraph->AddEdge(*piLHSNode, *piRHSNode, 0, EdgeType::kLower);
 }
 
+// the bound a check establishes after itself must not be used to prove that very check, so its
+// edges are left out of the proof for it and only of that one
+
 bool MeABC::BuildArrayCheckInGraph(MeStmt &meStmt) {
   CHECK_FATAL(meStmt.GetOp() == OP_piassign, "must be");
   auto *piMeStmt = static_cast<PiassignMeStmt*>(&meStmt);
   BuildSoloPiInGraph(*piMeStmt);
-  if (piMeStmt == forbidenPi) {
-    return true;
-  }
   MeStmt *generatedByMeStmt = piMeStmt->GetGeneratedBy();
   CHECK_FATAL(arrayChecks.find(generatedByMeStmt) != arrayChecks.end(), "must be");
   NaryMeExpr *arrCheck = arrayChecks[generatedByMeStmt];
@@ -669,8 +670,16 @@ bool MeABC::BuildArrayCheckInGraph(MeStmt &meStmt) {
   VarMeExpr *piLHS = piMeStmt->GetLHS();
   ESSAArrayNode *arrayNode = inequalityGraph->GetOrCreateArrayNode(*opnd1);
   ESSAVarNode *piLHSNode = inequalityGraph->GetOrCreateVarNode(*piLHS);
-  (void)inequalityGraph->AddEdge(*arrayNode, *piLHSNode, -1, EdgeType::kNone);
-  (void)inequalityGraph->AddEdge(*piLHSNode, *(inequalityGraph->GetOrCreateConstNode(0)), 0, EdgeType::kNone);
+  InequalEdge *upperEdge = inequalityGraph->AddEdge(*arrayNode, *piLHSNode, -1, EdgeType::kNone);
+  InequalEdge *lowerEdge =
+      inequalityGraph->AddEdge(*piLHSNode, *(inequalityGraph->GetOrCreateConstNode(0)), 0, EdgeType::kNone);
+  std::vector<InequalEdge*> &edges = checkBoundEdges[generatedByMeStmt];
+  for (InequalEdge *edge : { upperEdge, lowerEdge }) {
+    if (std::find(edges.begin(), edges.end(), edge) == edges.end()) {
+      edges.push_back(edge);
+      prove->AddQueryDependentEdge(*edge);
+    }
+  }
   return true;
 }
 
@@ -1208,7 +1217,9 @@ void MeABC::FindRedundantABC(MeStmt &meStmt, NaryMeExpr &naryMeExpr) {
     }
     return;
   }
-  if (prove->DemandProve(*opnd1, *opnd2)) {
+  auto edgesIt = checkBoundEdges.find(&meStmt);
+  const std::vector<InequalEdge*> noEdges;
+  if (prove->DemandProve(*opnd1, *opnd2, edgesIt == checkBoundEdges.end() ? noEdges : edgesIt->second)) {
     if (MeABC::isDebug) {
       LogInfo::MapleLogger() << "Find One OPT" << '\n';
       meStmt.Dump(irMap);
@@ -1297,36 +1308,41 @@ void MeABC::DeleteABC() {
   }
 }
 
-void MeABC::InitNewStartPoint(const MeStmt &meStmt, const NaryMeExpr &nMeExpr) {
+// one inequality graph covers the operands of all checks, so that the proofs for checks sharing
+// an array length or index share the memoized sub-proofs too
+void MeABC::InitGraph() {
   careMeStmts.clear();
   careMePhis.clear();
   carePoints.clear();
+  checkBoundEdges.clear();
   inequalityGraph = std::make_unique<InequalityGraph>(*meFunc);
   CHECK_FATAL(inequalityGraph != nullptr, "inequalityGraph is nullptr");
   prove = std::make_unique<ABCD>(*inequalityGraph);
   CHECK_FATAL(prove != nullptr, "prove is nullptr");
-  CHECK_FATAL(nMeExpr.GetNumOpnds() == kNumOpnds, "msut be");
-  MeExpr *opnd1 = nMeExpr.GetOpnd(0);
-  MeExpr *opnd2 = nMeExpr.GetOpnd(1);
-  CHECK_FATAL(opnd1->GetMeOp() == kMeOpVar, "must be");
-  AddUseDef(*opnd1);
-  if (opnd2->GetMeOp() == kMeOpVar) {
-    AddUseDef(*opnd2);
-  } else {
-    CHECK_FATAL(opnd2->GetMeOp() == kMeOpConst, "must be");
-    (void)inequalityGraph->GetOrCreateConstNode(static_cast<ConstMeExpr*>(opnd2)->GetIntValue());
-  }
-  BB *curBB = meStmt.GetBB();
-  if (curBB->GetPiList().size()) {
-    for (auto pair : curBB->GetPiList()) {
-      CHECK_FATAL(pair.second.size() >= 1, "must be");
-      PiassignMeStmt *pi = pair.second[0];
+  for (auto pair : arrayNewChecks) {
+    const MeStmt &meStmt = *(pair.first);
+    auto &nMeExpr = static_cast<const NaryMeExpr&>(*(pair.second));
+    CHECK_FATAL(nMeExpr.GetNumOpnds() == kNumOpnds, "msut be");
+    MeExpr *opnd1 = nMeExpr.GetOpnd(0);
+    MeExpr *opnd2 = nMeExpr.GetOpnd(1);
+    CHECK_FATAL(opnd1->GetMeOp() == kMeOpVar, "must be");
+    AddUseDef(*opnd1);
+    if (opnd2->GetMeOp() == kMeOpVar) {
+      AddUseDef(*opnd2);
+    } else {
+      CHECK_FATAL(opnd2->GetMeOp() == kMeOpConst, "must be");
+      (void)inequalityGraph->GetOrCreateConstNode(static_cast<ConstMeExpr*>(opnd2)->GetIntValue());
+    }
+    BB *curBB = meStmt.GetBB();
+    for (auto piPair : curBB->GetPiList()) {
+      CHECK_FATAL(piPair.second.size() >= 1, "must be");
+      PiassignMeStmt *pi = piPair.second[0];
       AddUseDef(*pi->GetLHS());
     }
+    MeStmt *checkPi = meStmt.GetNextMeStmt();
+    CHECK_FATAL(checkPi != nullptr, "checkPi is nullptr");
+    CHECK_FATAL(checkPi->GetOp() == OP_piassign, "must be");
   }
-  forbidenPi = meStmt.GetNextMeStmt();
-  CHECK_FATAL(forbidenPi != nullptr, "forbidenPi is nullptr");
-  CHECK_FATAL(forbidenPi->GetOp() == OP_piassign, "must be");
 }
 
 void MeABC::ExecuteABCO() {
@@ -1340,14 +1356,14 @@ void MeABC::ExecuteABCO() {
     InsertPhiNodes();
     Rename();
     CollectCareInsns();
+    InitGraph();
+    BuildInequalityGraph();
+    if (MeABC::isDebug) {
+      meFunc->GetTheCfg()->DumpToFile(meFunc->GetName());
+      inequalityGraph->DumpDotFile(*irMap, DumpType::kDumpUpperAndNone);
+      inequalityGraph->DumpDotFile(*irMap, DumpType::kDumpLowerAndNone);
+    }
     for (auto pair : arrayNewChecks) {
-      InitNewStartPoint(*(pair.first), *(static_cast<NaryMeExpr*>(pair.second)));
-      BuildInequalityGraph();
-      if (MeABC::isDebug) {
-        meFunc->GetTheCfg()->DumpToFile(meFunc->GetName());
-        inequalityGraph->DumpDotFile(*irMap, DumpType::kDumpUpperAndNone);
-        inequalityGraph->DumpDotFile(*irMap, DumpType::kDumpLowerAndNone);
-      }
       FindRedundantABC(*(pair.first), *(static_cast<NaryMeExpr*>(pair.second)));
     }
     RemoveExtraNodes();
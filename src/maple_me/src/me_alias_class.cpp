@@ -19,6 +19,7 @@
 #include "ssa_tab.h"
 #include "me_function.h"
 #include "mpl_timer.h"
+#include "mod_ref.h"
 
 namespace maple {
 // This phase performs alias analysis based on Steensgaard's algorithm and
@@ -88,6 +89,8 @@ AnalysisResult *MeDoAliasClass::Run(MeFunction *func, MeFuncResultMgr *funcResMg
   auto *aliasClass = aliasClassMp->New<MeAliasClass>(
       *aliasClassMp, func->GetMIRModule(), *func->GetMeSSATab(), *func, MeOption::lessThrowAlias,
       MeOption::ignoreIPA, DEBUGFUNC(func), MeOption::setCalleeHasSideEffect, kh);
+  aliasClass->SetModRefAnalysis(static_cast<ModRefAnalysis*>(moduleResMgr->FindAnalysisResult(
+      MoPhase_MODREF, &func->GetMIRModule())));
   // pass 1 through the program statements
   if (DEBUGFUNC(func)) {
     LogInfo::MapleLogger() << "\n============ Alias Classification Pass 1 ============" << '\n';
@@ -428,7 +428,7 @@ void AnalyzeRC::Run() {
   OptimizeRC();
 }
 
-AnalysisResult *MeDoAnalyzeRC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+AnalysisResult *MeDoAnalyzeRC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr *mrm) {
   auto *dom = static_cast<Dominance*>(m->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
   ASSERT(dom != nullptr, "dominance phase has problem");
   auto *aliasClass = static_cast<AliasClass*>(m->GetAnalysisResult(MeFuncPhase_ALIASCLASS, func));
@@ -445,7 +445,8 @@ AnalysisResult *MeDoAnalyzeRC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleR
     func->Dump(false);
   }
   if (!MeOption::noDelegateRC && MeOption::rcLowering && MeOption::optLevel > 0) {
-    m->GetAnalysisResult(MeFuncPhase_DELEGATERC, func);
+    // with the module results, so that it sees the rc summaries of the callees
+    (void)m->GetAnalysisResult(MeFuncPhase_DELEGATERC, func, mrm);
   }
   if (!MeOption::noCondBasedRC && MeOption::rcLowering && MeOption::optLevel > 0) {
     m->GetAnalysisResult(MeFuncPhase_CONDBASEDRC, func);
@@ -220,6 +220,38 @@ bool MeCondBased::IsNotNullValue(const VarMeExpr &varMeExpr, const UnaryMeStmt &
   return PointerWasDereferencedRightAfter(varMeExpr, assertMeStmt);
 }
 
+bool CondBasedNPC::IsNonNullAcrossCalls(const VarMeExpr &var) const {
+  if (nonNull == nullptr) {
+    return false;
+  }
+  const MIRFunction &mirFunc = GetMirFunc();
+  if (var.GetDefBy() == kDefByNo) {
+    const OriginalSt *ost = GetSSATab().GetSymbolOriginalStFromID(var.GetOStIdx());
+    if (!ost->IsFormal()) {
+      return false;
+    }
+    for (size_t i = 0; i < mirFunc.GetFormalCount(); ++i) {
+      if (mirFunc.GetFormal(i) == ost->GetMIRSymbol()) {
+        return nonNull->IsFormalNonNull(mirFunc.GetPuidx(), i);
+      }
+    }
+    return false;
+  }
+  if (var.GetDefBy() == kDefByMustDef) {
+    const MeStmt *callStmt = var.GetDefMustDef().GetBase();
+    if (callStmt != nullptr &&
+        (callStmt->GetOp() == OP_callassigned || callStmt->GetOp() == OP_superclasscallassigned)) {
+      return nonNull->IsReturnNonNull(static_cast<const CallMeStmt*>(callStmt)->GetPUIdx());
+    }
+    return false;
+  }
+  if (var.GetDefBy() == kDefByStmt && var.GetDefStmt()->GetOp() == OP_dassign) {
+    MeExpr *rhs = static_cast<DassignMeStmt*>(var.GetDefStmt())->GetRHS();
+    return rhs->GetMeOp() == kMeOpVar && IsNonNullAcrossCalls(static_cast<const VarMeExpr&>(*rhs));
+  }
+  return false;
+}
+
 void CondBasedNPC::DoCondBasedNPC() const {
   auto eIt = GetFunc()->valid_end();
   for (auto bIt = GetFunc()->valid_begin(); bIt != eIt; ++bIt) {
@@ -233,7 +265,8 @@ void CondBasedNPC::DoCondBasedNPC() const {
         continue;
       }
       auto *varMeExpr = static_cast<VarMeExpr*>(assertMeStmt.GetOpnd());
-      if (NullValueFromTestCond(*varMeExpr, *bb, false) || IsNotNullValue(*varMeExpr, assertMeStmt, *bb)) {
+      if (NullValueFromTestCond(*varMeExpr, *bb, false) || IsNotNullValue(*varMeExpr, assertMeStmt, *bb) ||
+          IsNonNullAcrossCalls(*varMeExpr)) {
         bb->RemoveMeStmt(&stmt);
       }
     }
@@ -276,10 +309,14 @@ AnalysisResult *MeDoCondBasedRC::Run(MeFunction *func, MeFuncResultMgr *m, Modul
   return nullptr;
 }
 
-AnalysisResult *MeDoCondBasedNPC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+AnalysisResult *MeDoCondBasedNPC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr *mrm) {
   auto *dom = static_cast<Dominance*>(m->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
   ASSERT(dom != nullptr, "dominance phase has problem");
-  CondBasedNPC condBasedNPC(*func, *dom);
+  const NonNullInference *nonNull = nullptr;
+  if (mrm != nullptr) {
+    nonNull = static_cast<NonNullInference*>(mrm->FindAnalysisResult(MoPhase_NONNULL, &func->GetMIRModule()));
+  }
+  CondBasedNPC condBasedNPC(*func, *dom, nonNull);
   condBasedNPC.DoCondBasedNPC();
   return nullptr;
 }
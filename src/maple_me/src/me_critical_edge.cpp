@@ -32,7 +32,7 @@
 // newbb is always appended at the end of bb_vec_ and pred/succ will be updated.
 // The bblayout phase will determine the final layout order of the bbs.
 namespace maple {
-void MeDoSplitCEdge::BreakCriticalEdge(MeFunction &func, BB &pred, BB &succ) const {
+BB &MeDoSplitCEdge::BreakCriticalEdge(MeFunction &func, BB &pred, BB &succ) const {
   if (DEBUGFUNC(&func)) {
     LogInfo::MapleLogger() << "******before break : critical edge : BB" << pred.GetBBId() << " -> BB" <<
         succ.GetBBId() << "\n";
@@ -103,6 +103,35 @@ void MeDoSplitCEdge::BreakCriticalEdge(MeFunction &func, BB &pred, BB &succ) con
       succ.Dump(&func.GetMIRModule());
     }
   }
+  return *newBB;
+}
+
+// the dominance updated in place is dumped next to the one a full computation gives, they should read the same
+void MeDoSplitCEdge::DumpUpdatedDominance(MeFunction &func, const Dominance &dom) {
+  LogInfo::MapleLogger() << "-----------------updated dominance after splitting edges---------\n";
+  dom.DumpTrees();
+  MemPool *memPool = NewMemPool();
+  auto *newDom = memPool->New<Dominance>(*memPool, *NewMemPool(), func.GetAllBBs(),
+                                         *func.GetCommonEntryBB(), *func.GetCommonExitBB());
+  newDom->GenPostOrderID();
+  newDom->ComputeDominance();
+  newDom->ComputeDomFrontiers();
+  newDom->ComputeDomChildren();
+  size_t num = 0;
+  newDom->ComputeDtPreorder(*func.GetCommonEntryBB(), num);
+  newDom->GetDtPreOrder().resize(num);
+  newDom->ComputeDtDfn();
+  newDom->PdomGenPostOrderID();
+  newDom->ComputePostDominance();
+  newDom->ComputePdomFrontiers();
+  newDom->ComputePdomChildren();
+  num = 0;
+  newDom->ComputePdtPreorder(*func.GetCommonExitBB(), num);
+  newDom->ResizePdtPreOrder(num);
+  newDom->ComputePdtDfn();
+  LogInfo::MapleLogger() << "-----------------recomputed dominance after splitting edges---------\n";
+  newDom->DumpTrees();
+  LogInfo::MapleLogger() << "-----------------end of dominance after splitting edges---------\n";
 }
 
 AnalysisResult *MeDoSplitCEdge::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
@@ -140,8 +169,25 @@ AnalysisResult *MeDoSplitCEdge::Run(MeFunction *func, MeFuncResultMgr *m, Module
       LogInfo::MapleLogger() << "*******************before break dump function*****************\n";
       func->GetTheCfg()->DumpToFile("cfgbeforebreak");
     }
+    // a dominance computed before is updated in place rather than computed again by the next phase
+    // asking for it, unless a new entry is inserted: that renumbers the bbs the result is indexed by
+    auto *dom = static_cast<Dominance*>(m->FindAnalysisResult(MeFuncPhase_DOMINANCE, func));
     for (auto it = criticalEdge.begin(); it != criticalEdge.end(); ++it) {
-      BreakCriticalEdge(*func, *((*it).first), *((*it).second));
+      BB &pred = *((*it).first);
+      BB &succ = *((*it).second);
+      if (&pred == func->GetCommonEntryBB()) {
+        dom = nullptr;
+      }
+      BB &newBB = BreakCriticalEdge(*func, pred, succ);
+      if (dom != nullptr) {
+        dom->UpdateAfterSplitEdge(pred, newBB, succ);
+      }
+    }
+    if (dom != nullptr) {
+      dom->UpdateTreeOrders();
+      if (DEBUGFUNC(func)) {
+        DumpUpdatedDominance(*func, *dom);
+      }
     }
     if (DEBUGFUNC(func)) {
       LogInfo::MapleLogger() << "******************after break dump function******************\n";
@@ -149,7 +195,11 @@ AnalysisResult *MeDoSplitCEdge::Run(MeFunction *func, MeFuncResultMgr *m, Module
       func->GetTheCfg()->DumpToFile("cfgafterbreak");
     }
     if (func->GetMIRModule().IsInIPA()) {
-      m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+      if (dom == nullptr) {
+        m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+      }
+    } else if (dom != nullptr) {
+      m->InvalidIRbaseAnalysisResultExcept(*func, MeFuncPhase_DOMINANCE);
     } else {
       m->InvalidAllResults();
     }
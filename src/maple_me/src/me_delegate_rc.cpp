@@ -49,6 +49,11 @@
 //     dread of a static final field.
 // B3: Within the SSA version's live range, there is no operation that can result
 //     in decref of any object.
+//
+// For B1, passing the SSA version to a direct call does not count as copying it
+// when the rcsummary phase found the callee neither retains nor dereferences
+// that formal; the call then only compares it, so it is handled like a compare
+// in the caller and just prevents the early decref.
 namespace {
 // following intrinsics can throw exception
 const std::set<maple::MIRIntrinsicID> canThrowIntrinsicsList {
@@ -107,6 +112,17 @@ void DelegateRC::SaveDerefedOrCopiedVst(const MeExpr *expr) {
   }
 }
 
+void DelegateRC::SaveCantDecrefEarlyVst(const MeExpr *expr) {
+  CHECK_NULL_FATAL(expr);
+  while (expr->GetOp() == OP_retype) {
+    expr = expr->GetOpnd(0);
+  }
+  if (expr->GetMeOp() == kMeOpVar) {
+    const auto *varExpr = static_cast<const VarMeExpr*>(expr);
+    verStCantDecrefEarly[varExpr->GetVstIdx()] = true;
+  }
+}
+
 bool DelegateRC::IsCopiedOrDerefedOp(Opcode op) const {
   return op == OP_dassign || op == OP_maydassign || op == OP_regassign || op == OP_syncenter ||
          op == OP_syncexit || op == OP_throw || op == OP_return || op == OP_iassign ||  // cause var copied
@@ -118,8 +134,15 @@ void DelegateRC::CollectDerefedOrCopied(const MeStmt &stmt) {
   if (!IsCopiedOrDerefedOp(op)) {
     return;
   }
+  bool isDirectCall = op == OP_call || op == OP_callassigned || op == OP_superclasscall ||
+                      op == OP_superclasscallassigned;
   for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
     MeExpr *curOpnd = stmt.GetOpnd(i);
+    if (isDirectCall && rcSummary != nullptr &&
+        rcSummary->IsFormalInert(static_cast<const CallMeStmt&>(stmt).GetPUIdx(), i)) {
+      SaveCantDecrefEarlyVst(curOpnd);
+      continue;
+    }
     SaveDerefedOrCopiedVst(curOpnd);
   }
 }
@@ -769,7 +792,7 @@ void DelegateRC::CleanUpDeadLocalRefVar(const std::set<OStIdx> &liveLocalrefvars
   }
 }
 
-AnalysisResult *MeDoDelegateRC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+AnalysisResult *MeDoDelegateRC::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr *mrm) {
   static uint32 puCount = 0;
   auto *dom = static_cast<Dominance*>(m->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
   ASSERT(dom != nullptr, "dominance phase has problem");
@@ -781,7 +804,11 @@ AnalysisResult *MeDoDelegateRC::Run(MeFunction *func, MeFuncResultMgr *m, Module
   if (DEBUGFUNC(func)) {
     LogInfo::MapleLogger() << " Processing " << func->GetMirFunc()->GetName() << '\n';
   }
-  DelegateRC delegaterc(*func, *dom, NewMemPool(), DEBUGFUNC(func));
+  const RCSummary *rcSummary = nullptr;
+  if (mrm != nullptr) {
+    rcSummary = static_cast<RCSummary*>(mrm->FindAnalysisResult(MoPhase_RCSUMMARY, &func->GetMIRModule()));
+  }
+  DelegateRC delegaterc(*func, *dom, NewMemPool(), rcSummary, DEBUGFUNC(func));
   if (puCount > MeOption::delRcPULimit) {
     ++puCount;
     return nullptr;
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_escape_analysis.h"
+#include <algorithm>
+
+// This phase builds a connection graph of the objects the function handles:
+// the objects of each gcmalloc, the objects its formals point to on entry
+// together with everything reachable from them, and a single unknown object
+// standing for the rest of the heap. SSA versions of locals and pregs point to
+// sets of these objects, and each object has the set of objects its fields may
+// point to. The graph is built flow-insensitively until it stops growing, then
+// the escape states are propagated along the field edges:
+//   statics, thrown objects and arguments of unknown calls reach the unknown
+//   object and escape globally;
+//   formals and returned objects escape to the caller.
+// At the end, what the function may do to each of its formals is recorded in
+// the module, so that callers optimized later can see through the call.
+namespace maple {
+namespace {
+constexpr uint32 kUnknownNode = 0;
+}  // namespace
+
+uint32 EscapeAnalysis::NewNode(EscapeNodeKind kind, const MeStmt *stmt, size_t formalIndex) {
+  uint32 id = static_cast<uint32>(nodes.size());
+  nodes.push_back(escapeAlloc.GetMemPool()->New<EscapeNode>(escapeAlloc, kind, stmt, formalIndex));
+  return id;
+}
+
+void EscapeAnalysis::CreateNodes() {
+  uint32 unknown = NewNode(kEscapeNodeUnknown, nullptr, 0);
+  nodes[unknown]->state = kGlobalEscape;
+  (void)nodes[unknown]->contents.insert(unknown);
+  MIRFunction *mirFunc = func.GetMirFunc();
+  for (size_t i = 0; i < mirFunc->GetFormalCount(); ++i) {
+    uint32 formal = NewNode(kEscapeNodeFormal, nullptr, i);
+    uint32 content = NewNode(kEscapeNodeFormalContent, nullptr, i);
+    nodes[formal]->state = kArgEscape;
+    nodes[content]->state = kArgEscape;
+    (void)nodes[formal]->contents.insert(content);
+    (void)nodes[content]->contents.insert(content);
+    formalNodes.push_back(formal);
+  }
+  auto eIt = func.valid_end();
+  for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+    for (auto &stmt : (*bIt)->GetMeStmts()) {
+      if (stmt.GetOp() != OP_dassign && stmt.GetOp() != OP_regassign) {
+        continue;
+      }
+      Opcode rhsOp = stmt.GetRHS()->GetOp();
+      if (rhsOp == OP_gcmalloc || rhsOp == OP_gcmallocjarray) {
+        allocNodes[&stmt] = NewNode(kEscapeNodeAlloc, &stmt, 0);
+      }
+    }
+  }
+}
+
+// the edges the graph starts with, they do not capture anything
+bool EscapeAnalysis::IsInitialEdge(const EscapeNode &from, const EscapeNode &to) const {
+  if (to.kind != kEscapeNodeFormalContent) {
+    return false;
+  }
+  return (from.kind == kEscapeNodeFormal || from.kind == kEscapeNodeFormalContent) &&
+         from.formalIndex == to.formalIndex;
+}
+
+size_t EscapeAnalysis::GetFormalIndex(const OriginalSt &ost) const {
+  MIRFunction *mirFunc = func.GetMirFunc();
+  for (size_t i = 0; i < mirFunc->GetFormalCount(); ++i) {
+    if (mirFunc->GetFormal(i) == ost.GetMIRSymbol()) {
+      return i;
+    }
+  }
+  return formalNodes.size();
+}
+
+void EscapeAnalysis::GetVarPointsTo(const VarMeExpr &var, PointsToSet &result) const {
+  const VarMeExpr *cur = &var;
+  while (cur != nullptr) {
+    const OriginalSt *ost = ssaTab.GetOriginalStFromID(cur->GetOStIdx());
+    if (!ost->IsLocal()) {
+      (void)result.insert(kUnknownNode);
+      return;
+    }
+    auto it = pointsTo.find(cur->GetExprID());
+    if (it != pointsTo.end()) {
+      result.insert(it->second->begin(), it->second->end());
+    }
+    switch (cur->GetDefBy()) {
+      case kDefByNo: {
+        if (ost->IsFormal()) {
+          size_t index = GetFormalIndex(*ost);
+          (void)result.insert(index < formalNodes.size() ? formalNodes[index] : kUnknownNode);
+        }
+        return;
+      }
+      case kDefByChi:
+        // may be defined through an alias, or keeps the value of the previous version
+        (void)result.insert(kUnknownNode);
+        cur = cur->GetDefChi().GetRHS();
+        break;
+      default:
+        return;
+    }
+  }
+}
+
+void EscapeAnalysis::GetRegPointsTo(const RegMeExpr &reg, PointsToSet &result) const {
+  // thrown value, return value and the like
+  if (reg.GetRegIdx() < 0 || reg.GetDefBy() == kDefByNo) {
+    (void)result.insert(kUnknownNode);
+    return;
+  }
+  auto it = pointsTo.find(reg.GetExprID());
+  if (it != pointsTo.end()) {
+    result.insert(it->second->begin(), it->second->end());
+  }
+}
+
+void EscapeAnalysis::GetPointsTo(const MeStmt &stmt, const MeExpr &expr, PointsToSet &result) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpVar:
+      GetVarPointsTo(static_cast<const VarMeExpr&>(expr), result);
+      return;
+    case kMeOpReg:
+      GetRegPointsTo(static_cast<const RegMeExpr&>(expr), result);
+      return;
+    case kMeOpIvar: {
+      PointsToSet bases;
+      GetPointsTo(stmt, *static_cast<const IvarMeExpr&>(expr).GetBase(), bases);
+      for (uint32 base : bases) {
+        result.insert(nodes[base]->contents.begin(), nodes[base]->contents.end());
+      }
+      return;
+    }
+    case kMeOpAddrof:
+    case kMeOpConststr:
+    case kMeOpConststr16:
+      (void)result.insert(kUnknownNode);
+      return;
+    case kMeOpConst:
+    case kMeOpAddroffunc:
+    case kMeOpSizeoftype:
+    case kMeOpFieldsDist:
+      return;
+    default:
+      break;
+  }
+  if (expr.IsGcmalloc()) {
+    auto it = allocNodes.find(&stmt);
+    // permanent objects and allocations created after the analysis are never tracked
+    (void)result.insert(it != allocNodes.end() ? it->second : kUnknownNode);
+    return;
+  }
+  if (expr.GetOp() == OP_intrinsicop || expr.GetOp() == OP_intrinsicopwithtype) {
+    (void)result.insert(kUnknownNode);
+  }
+  // conversions, address arithmetic and array element addresses point to what their operands point to
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    GetPointsTo(stmt, *expr.GetOpnd(i), result);
+  }
+}
+
+void EscapeAnalysis::GetReachable(const PointsToSet &from, PointsToSet &result) const {
+  std::vector<uint32> workList(from.begin(), from.end());
+  while (!workList.empty()) {
+    uint32 node = workList.back();
+    workList.pop_back();
+    if (!result.insert(node).second) {
+      continue;
+    }
+    for (uint32 content : nodes[node]->contents) {
+      workList.push_back(content);
+    }
+  }
+}
+
+bool EscapeAnalysis::AddPointsTo(const MeExpr &lhs, const PointsToSet &objs) {
+  if (objs.empty()) {
+    return false;
+  }
+  MapleSet<uint32> *&objSet = pointsTo[lhs.GetExprID()];
+  if (objSet == nullptr) {
+    objSet = escapeAlloc.GetMemPool()->New<MapleSet<uint32>>(escapeAlloc.Adapter());
+  }
+  size_t oldSize = objSet->size();
+  objSet->insert(objs.begin(), objs.end());
+  return objSet->size() != oldSize;
+}
+
+bool EscapeAnalysis::AddContents(uint32 node, const PointsToSet &objs) {
+  MapleSet<uint32> &contents = nodes[node]->contents;
+  size_t oldSize = contents.size();
+  contents.insert(objs.begin(), objs.end());
+  return contents.size() != oldSize;
+}
+
+const MapleVector<uint8> *EscapeAnalysis::GetCallSummary(const MeStmt &call) const {
+  switch (call.GetOp()) {
+    case OP_call:
+    case OP_callassigned:
+    case OP_superclasscall:
+    case OP_superclasscallassigned:
+      return mirModule.GetParamEscapeSummary(static_cast<const CallMeStmt&>(call).GetPUIdx());
+    default:
+      return nullptr;
+  }
+}
+
+// RC intrinsics inserted by earlier phases only count references, they neither store nor publish them
+bool EscapeAnalysis::IsHarmlessIntrinsic(const MeStmt &stmt) const {
+  if (stmt.GetOp() != OP_intrinsiccall) {
+    return false;
+  }
+  MIRIntrinsicID intrinsic = static_cast<const IntrinsiccallMeStmt&>(stmt).GetIntrinsic();
+  return intrinsic == INTRN_MCCIncRef || intrinsic == INTRN_MCCDecRef || intrinsic == INTRN_MCCIncDecRef ||
+         intrinsic == INTRN_MPL_CLEANUP_LOCALREFVARS || intrinsic == INTRN_MPL_CLEANUP_LOCALREFVARS_SKIP;
+}
+
+bool EscapeAnalysis::ProcessPhis(BB &bb) {
+  bool changed = false;
+  for (auto &phiPair : bb.GetMevarPhiList()) {
+    MeVarPhiNode *phi = phiPair.second;
+    PointsToSet objs;
+    for (VarMeExpr *opnd : phi->GetOpnds()) {
+      GetVarPointsTo(*opnd, objs);
+    }
+    changed = AddPointsTo(*phi->GetLHS(), objs) || changed;
+  }
+  for (auto &phiPair : bb.GetMeRegPhiList()) {
+    MeRegPhiNode *phi = phiPair.second;
+    PointsToSet objs;
+    for (RegMeExpr *opnd : phi->GetOpnds()) {
+      GetRegPointsTo(*opnd, objs);
+    }
+    changed = AddPointsTo(*phi->GetLHS(), objs) || changed;
+  }
+  return changed;
+}
+
+bool EscapeAnalysis::ProcessCall(MeStmt &stmt) {
+  bool changed = false;
+  const MapleVector<uint8> *summary = GetCallSummary(stmt);
+  bool harmless = IsHarmlessIntrinsic(stmt);
+  PointsToSet returned = { kUnknownNode };
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    PointsToSet args;
+    GetPointsTo(stmt, *stmt.GetOpnd(i), args);
+    if (args.empty() || harmless) {
+      continue;
+    }
+    uint8 flags = (summary != nullptr && i < summary->size()) ? (*summary)[i] : kParamEscapeAll;
+    if ((flags & kParamEscapeGlobal) != 0) {
+      changed = AddContents(kUnknownNode, args) || changed;
+    }
+    if ((flags & (kParamReturned | kParamFieldWritten)) == 0) {
+      continue;
+    }
+    PointsToSet reachable;
+    GetReachable(args, reachable);
+    if ((flags & kParamReturned) != 0) {
+      returned.insert(reachable.begin(), reachable.end());
+    }
+    if ((flags & kParamFieldWritten) != 0) {
+      for (uint32 node : reachable) {
+        nodes[node]->fieldWritten = true;
+        changed = nodes[node]->contents.insert(kUnknownNode).second || changed;
+      }
+    }
+  }
+  MapleVector<MustDefMeNode> *mustDefs = stmt.GetMustDefList();
+  if (mustDefs != nullptr && !mustDefs->empty()) {
+    changed = AddPointsTo(*mustDefs->front().GetLHS(), returned) || changed;
+  }
+  return changed;
+}
+
+bool EscapeAnalysis::ProcessStmt(MeStmt &stmt) {
+  switch (stmt.GetOp()) {
+    case OP_dassign:
+    case OP_maydassign: {
+      PointsToSet objs;
+      GetPointsTo(stmt, *stmt.GetRHS(), objs);
+      VarMeExpr *lhs = stmt.GetVarLHS();
+      if (!ssaTab.GetOriginalStFromID(lhs->GetOStIdx())->IsLocal()) {
+        return AddContents(kUnknownNode, objs);
+      }
+      return AddPointsTo(*lhs, objs);
+    }
+    case OP_regassign: {
+      PointsToSet objs;
+      GetPointsTo(stmt, *stmt.GetRHS(), objs);
+      return AddPointsTo(*stmt.GetLHS(), objs);
+    }
+    case OP_iassign: {
+      PointsToSet bases;
+      PointsToSet objs;
+      GetPointsTo(stmt, *static_cast<IassignMeStmt&>(stmt).GetLHSVal()->GetBase(), bases);
+      GetPointsTo(stmt, *stmt.GetRHS(), objs);
+      bool changed = false;
+      for (uint32 base : bases) {
+        nodes[base]->fieldWritten = true;
+        changed = AddContents(base, objs) || changed;
+      }
+      return changed;
+    }
+    case OP_return: {
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        PointsToSet objs;
+        GetPointsTo(stmt, *stmt.GetOpnd(i), objs);
+        returnedNodes.insert(objs.begin(), objs.end());
+      }
+      return false;
+    }
+    case OP_throw: {
+      PointsToSet objs;
+      GetPointsTo(stmt, *stmt.GetOpnd(0), objs);
+      return AddContents(kUnknownNode, objs);
+    }
+    default:
+      break;
+  }
+  if (kOpcodeInfo.IsCall(stmt.GetOp())) {
+    return ProcessCall(stmt);
+  }
+  return false;
+}
+
+void EscapeAnalysis::PropagateEscapeState() {
+  std::vector<uint32> workList;
+  for (uint32 node : returnedNodes) {
+    nodes[node]->returned = true;
+    nodes[node]->state = std::max(nodes[node]->state, kArgEscape);
+  }
+  for (uint32 i = 0; i < nodes.size(); ++i) {
+    workList.push_back(i);
+  }
+  while (!workList.empty()) {
+    EscapeNode &node = *nodes[workList.back()];
+    workList.pop_back();
+    for (uint32 content : node.contents) {
+      if (nodes[content]->state < node.state) {
+        nodes[content]->state = node.state;
+        workList.push_back(content);
+      }
+    }
+  }
+  for (EscapeNode *node : nodes) {
+    for (uint32 content : node->contents) {
+      if (!IsInitialEdge(*node, *nodes[content]) && content != kUnknownNode) {
+        nodes[content]->captured = true;
+      }
+    }
+  }
+}
+
+// Only what happens to the caller's objects matters to the caller: the formal and the objects reachable
+// from it on entry. Storing them anywhere the caller may see again loses track of them as well.
+void EscapeAnalysis::RecordParamSummary() {
+  // the body of a native is empty until its stub is generated, and the native code may keep anything
+  // it is passed; without a summary its callers take every argument as escaping
+  if (func.GetMirFunc()->IsAnyNative()) {
+    return;
+  }
+  auto *summary = mirModule.GetMemPool()->New<MapleVector<uint8>>(formalNodes.size(), 0,
+                                                                   mirModule.GetMPAllocator().Adapter());
+  for (EscapeNode *node : nodes) {
+    if (node->kind != kEscapeNodeFormal && node->kind != kEscapeNodeFormalContent) {
+      continue;
+    }
+    uint8 &flags = (*summary)[node->formalIndex];
+    if (node->state == kGlobalEscape) {
+      flags |= kParamEscapeGlobal;
+    }
+    if (node->returned) {
+      flags |= kParamReturned;
+    }
+    if (node->fieldWritten) {
+      flags |= kParamFieldWritten;
+    }
+  }
+  for (EscapeNode *node : nodes) {
+    if (node->state == kNoEscape) {
+      continue;
+    }
+    for (uint32 content : node->contents) {
+      const EscapeNode &contentNode = *nodes[content];
+      if ((contentNode.kind == kEscapeNodeFormal || contentNode.kind == kEscapeNodeFormalContent) &&
+          !IsInitialEdge(*node, contentNode)) {
+        (*summary)[contentNode.formalIndex] |= kParamEscapeGlobal;
+      }
+    }
+  }
+  mirModule.SetParamEscapeSummary(func.GetMirFunc()->GetPuidx(), summary);
+}
+
+void EscapeAnalysis::Run() {
+  CreateNodes();
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    auto eIt = func.valid_end();
+    for (auto bIt = func.valid_begin(); bIt != eIt; ++bIt) {
+      BB &bb = **bIt;
+      changed = ProcessPhis(bb) || changed;
+      for (auto &stmt : bb.GetMeStmts()) {
+        changed = ProcessStmt(stmt) || changed;
+      }
+    }
+  }
+  PropagateEscapeState();
+  RecordParamSummary();
+  if (enabledDebug) {
+    Dump();
+  }
+}
+
+EscapeState EscapeAnalysis::GetEscapeState(const MeStmt &stmt, const MeExpr &expr) const {
+  PointsToSet objs;
+  GetPointsTo(stmt, expr, objs);
+  EscapeState state = kNoEscape;
+  for (uint32 obj : objs) {
+    state = std::max(state, nodes[obj]->state);
+  }
+  return state;
+}
+
+bool EscapeAnalysis::IsObjectUntouchedByCall(const MeStmt &call, const MeExpr &expr) const {
+  PointsToSet objs;
+  GetPointsTo(call, expr, objs);
+  if (objs.size() != 1) {
+    return false;
+  }
+  uint32 obj = *objs.begin();
+  const EscapeNode &node = *nodes[obj];
+  // a captured object may be reached through some other object as well
+  if (node.kind != kEscapeNodeAlloc || node.state == kGlobalEscape || node.captured) {
+    return false;
+  }
+  const MapleVector<uint8> *summary = GetCallSummary(call);
+  if (summary == nullptr) {
+    return false;
+  }
+  for (size_t i = 0; i < call.NumMeStmtOpnds(); ++i) {
+    PointsToSet args;
+    GetPointsTo(call, *call.GetOpnd(i), args);
+    if (args.find(obj) == args.end()) {
+      continue;
+    }
+    if (i >= summary->size() || ((*summary)[i] & (kParamEscapeGlobal | kParamFieldWritten)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void EscapeAnalysis::Dump() const {
+  static const char *stateNames[] = { "NoEscape", "ArgEscape", "GlobalEscape" };
+  LogInfo::MapleLogger() << "\n============== Escape analysis of " << func.GetName() << " =============\n";
+  for (const EscapeNode *node : nodes) {
+    if (node->kind != kEscapeNodeAlloc) {
+      continue;
+    }
+    LogInfo::MapleLogger() << stateNames[node->state] << (node->captured ? " captured" : "")
+                           << (node->fieldWritten ? " written" : "") << ": ";
+    node->allocStmt->Dump(func.GetIRMap());
+  }
+  const MapleVector<uint8> *summary = mirModule.GetParamEscapeSummary(func.GetMirFunc()->GetPuidx());
+  for (size_t i = 0; summary != nullptr && i < summary->size(); ++i) {
+    LogInfo::MapleLogger() << "formal " << i << ":" << (((*summary)[i] & kParamEscapeGlobal) ? " global" : "")
+                           << (((*summary)[i] & kParamReturned) ? " returned" : "")
+                           << (((*summary)[i] & kParamFieldWritten) ? " written" : "") << '\n';
+  }
+}
+
+AnalysisResult *MeDoEscapeAnalysis::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+  if (func->GetIRMap() == nullptr) {
+    auto *hmap = static_cast<MeIRMap*>(m->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+    CHECK_FATAL(hmap != nullptr, "hssamap has problem");
+    func->SetIRMap(hmap);
+  }
+  CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
+  MemPool *escapeMp = NewMemPool();
+  auto *escapeAnalysis = escapeMp->New<EscapeAnalysis>(*escapeMp, *func, DEBUGFUNC(func));
+  escapeAnalysis->Run();
+  return escapeAnalysis;
+}
+}  // namespace maple
@@ -13,6 +13,8 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "me_inequality_graph.h"
+#include <algorithm>
+#include <limits>
 
 namespace {
 constexpr maple::int32 kUpperBound = -1;
@@ -326,7 +328,7 @@ void InequalityGraph::DumpDotFile(IRMap &irMap, DumpType dumpType) const {
   fileBuf.close();
 }
 
-bool ABCD::DemandProve(const MeExpr &arrayNode, const MeExpr &idx) {
+bool ABCD::DemandProve(const MeExpr &arrayNode, const MeExpr &idx, const std::vector<InequalEdge*> &excluded) {
   ESSABaseNode &aNode = inequalityGraph->GetNode(arrayNode);
   ESSABaseNode *idxNode = nullptr;
   if (idx.GetMeOp() == kMeOpVar) {
@@ -336,15 +338,31 @@ bool ABCD::DemandProve(const MeExpr &arrayNode, const MeExpr &idx) {
     idxNode = &(inequalityGraph->GetNode(static_cast<const ConstMeExpr&>(idx).GetIntValue()));
   }
   ESSABaseNode &zNode = inequalityGraph->GetNode(0);
-  bool upperResult = ABCD::DemandProve(aNode, *idxNode, kUpper);
-  bool lowerResult = ABCD::DemandProve(zNode, *idxNode, kLower);
-  return upperResult && lowerResult;
+  std::vector<const InequalEdge*> excludedEdges;
+  for (InequalEdge *edge : excluded) {
+    CHECK_FATAL(queryDependentEdges.find(edge) != queryDependentEdges.end(), "must be");
+    edge->SetEdgeTypeInValid();
+    excludedEdges.push_back(edge);
+  }
+  std::sort(excludedEdges.begin(), excludedEdges.end());
+  (void)excludedEdges.erase(std::unique(excludedEdges.begin(), excludedEdges.end()), excludedEdges.end());
+  uint32 newContext = static_cast<uint32>(queryContexts.size()) + 1;
+  queryContext = queryContexts.emplace(std::move(excludedEdges), newContext).first->second;
+  bool result = ABCD::DemandProve(aNode, *idxNode, kUpper) && ABCD::DemandProve(zNode, *idxNode, kLower);
+  for (InequalEdge *edge : excluded) {
+    edge->SetEdgeTypeValid();
+  }
+  return result;
 }
 
 bool ABCD::DemandProve(ESSABaseNode &firstNode, ESSABaseNode &secondNode, EdgeType edgeType) {
   std::unique_ptr<InequalEdge> e =
       std::make_unique<InequalEdge>(edgeType == kUpper ? kUpperBound : kLowerBound, edgeType);
   active.clear();
+  activeDepth.clear();
+  recursiveCount = 0;
+  minDependDepth = std::numeric_limits<size_t>::max();
+  usesQueryEdge = false;
   ProveResult res = Prove(firstNode, secondNode, *e.get());
   return res == kTrue;
 }
@@ -356,52 +374,132 @@ void ABCD::PrintTracing() const {
   std::cout << '\n';
 }
 
+// an edge of the kind being proven is usable unless disabled; a disabled one makes the proof
+// depend on whoever disabled it
+bool ABCD::IsUsableEdge(const InequalEdge &in, EdgeType type) {
+  EdgeType inType = in.GetEdgeType();
+  if (inType == type || inType == kNone) {
+    if (queryDependentEdges.find(&in) != queryDependentEdges.end()) {
+      usesQueryEdge = true;
+    }
+    return true;
+  }
+  EdgeType invalidType = type == kUpper ? kUpperInvalid : kLowerInvalid;
+  if (inType == invalidType || inType == kNoneInvalid) {
+    auto it = invalidPairDepth.find(&in);
+    if (it != invalidPairDepth.end()) {
+      minDependDepth = std::min(minDependDepth, it->second);
+    } else {
+      usesQueryEdge = true;  // excluded from the current query
+    }
+  }
+  return false;
+}
+
+void ABCD::InvalidatePairEdge(InequalEdge &in) {
+  InequalEdge *pairEdge = in.GetPairEdge();
+  if (pairEdge != nullptr) {
+    pairEdge->SetEdgeTypeInValid();
+    invalidPairDepth[pairEdge] = tracing.size();
+  }
+}
+
+void ABCD::ValidatePairEdge(InequalEdge &in) {
+  InequalEdge *pairEdge = in.GetPairEdge();
+  if (pairEdge != nullptr) {
+    pairEdge->SetEdgeTypeValid();
+    (void)invalidPairDepth.erase(pairEdge);
+  }
+}
+
+// key is looked up in the shared context and in the context of the current query
+bool ABCD::LookupCache(const ProveCacheKey &key, int64 bound, ProveResult &res) const {
+  EdgeType type = std::get<2>(key);
+  ProveCacheKey contextKey = key;
+  for (uint32 context : { kSharedProveContext, queryContext }) {
+    std::get<3>(contextKey) = context;
+    auto it = proveCache.find(contextKey);
+    if (it == proveCache.end()) {
+      continue;
+    }
+    const ProveCacheEntry &entry = it->second;
+    if (entry.hasTrue && IsWeakerBound(type, bound, entry.trueBound)) {
+      res = kTrue;
+      return true;
+    }
+    if (entry.hasFalse && IsWeakerBound(type, entry.falseBound, bound)) {
+      res = kFalse;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ABCD::UpdateCache(ProveCacheKey key, int64 bound, ProveResult res) {
+  EdgeType type = std::get<2>(key);
+  if (usesQueryEdge) {
+    std::get<3>(key) = queryContext;
+  }
+  ProveCacheEntry &entry = proveCache[key];
+  if (res == kTrue) {
+    if (!entry.hasTrue || IsWeakerBound(type, entry.trueBound, bound)) {
+      entry.hasTrue = true;
+      entry.trueBound = bound;
+    }
+  } else if (res == kFalse) {
+    if (!entry.hasFalse || IsWeakerBound(type, bound, entry.falseBound)) {
+      entry.hasFalse = true;
+      entry.falseBound = bound;
+    }
+  }
+}
+
 ProveResult ABCD::Prove(ESSABaseNode &aNode, ESSABaseNode &bNode, InequalEdge &edge) {
   ++recursiveCount;
   if (recursiveCount > kDFSLimit) {
     return kFalse;
   }
-
-  tracing.push_back(&bNode);
   if (&aNode == &bNode) {
-    if (edge.GreaterEqual(0)) {
-      tracing.pop_back();
-      return kTrue;
-    } else {
-      tracing.pop_back();
-      return kFalse;
-    }
+    return edge.GreaterEqual(0) ? kTrue : kFalse;
   }
-  bool hasPreNode = false;
-  auto constEdge = (edge.GetEdgeType() == kUpper) ? bNode.GetInWithConstEdgeMap() : bNode.GetOutWithConstEdgeMap();
-  for (auto iter = constEdge.begin(); iter != constEdge.end(); ++iter) {
-    if (iter->second->GetEdgeType() == edge.GetEdgeType() || iter->second->GetEdgeType() == EdgeType::kNone) {
-      hasPreNode = true;
-      break;
-    }
+  ProveCacheKey key(&aNode, &bNode, edge.GetEdgeType(), kSharedProveContext);
+  ProveResult res = kFalse;
+  if (LookupCache(key, edge.GetConstValue(), res)) {
+    return res;
   }
-  if (bNode.GetKind() == kPhiNode) {
-    hasPreNode = true;
+
+  tracing.push_back(&bNode);
+  size_t depth = tracing.size();
+  size_t outerDependDepth = minDependDepth;
+  bool outerUsesQueryEdge = usesQueryEdge;
+  minDependDepth = std::numeric_limits<size_t>::max();
+  usesQueryEdge = false;
+  bool hasPreNode = bNode.GetKind() == kPhiNode;
+  const auto &constEdge = (edge.GetEdgeType() == kUpper) ? bNode.GetInWithConstEdgeMap()
+                                                         : bNode.GetOutWithConstEdgeMap();
+  for (auto iter = constEdge.begin(); !hasPreNode && iter != constEdge.end(); ++iter) {
+    hasPreNode = IsUsableEdge(*iter->second, edge.GetEdgeType());
   }
+  auto activeIt = active.find(&bNode);
   if (!hasPreNode) {
-    tracing.pop_back();
-    return kFalse;
+    res = kFalse;
+  } else if (activeIt != active.end()) {
+    minDependDepth = std::min(minDependDepth, activeDepth[&bNode]);
+    res = activeIt->second->LessEqual(edge) ? kReduced : kFalse;
+  } else {
+    active[&bNode] = &edge;
+    activeDepth[&bNode] = depth;
+    res = bNode.GetKind() == kPhiNode ? UpdateCacheResult(aNode, bNode, edge, Min)
+                                      : UpdateCacheResult(aNode, bNode, edge, Max);
+    (void)active.erase(&bNode);
+    (void)activeDepth.erase(&bNode);
   }
-
-  if (active.find(&bNode) != active.end()) {
-    if (active.find(&bNode)->second->LessEqual(edge)) {
-      tracing.pop_back();
-      return kReduced;
-    } else {
-      tracing.pop_back();
-      return kFalse;
-    }
+  // only a result that does not depend on the path to this node may be memoized
+  if (res != kReduced && minDependDepth >= depth && recursiveCount <= kDFSLimit) {
+    UpdateCache(key, edge.GetConstValue(), res);
   }
-
-  active[&bNode] = &edge;
-  ProveResult res = bNode.GetKind() == kPhiNode ? UpdateCacheResult(aNode, bNode, edge, Min)
-                                                : UpdateCacheResult(aNode, bNode, edge, Max);
-  active.erase(&bNode);
+  minDependDepth = std::min(outerDependDepth, minDependDepth);
+  usesQueryEdge = outerUsesQueryEdge || usesQueryEdge;
   tracing.pop_back();
   return res;
 }
@@ -411,39 +509,33 @@ ProveResult ABCD::UpdateCacheResult(ESSABaseNode &aNode, ESSABaseNode &bNode, In
   if (meet == Min) {
     CHECK_FATAL(bNode.GetKind() == kPhiNode, "must be");
     auto& bPhiNode = static_cast<ESSAPhiNode&>(bNode);
-    auto constEdgeMap = (edge.GetEdgeType() == kUpper) ? bPhiNode.GetInPhiEdgeMap() : bPhiNode.GetOutPhiEdgeMap();
+    const auto &constEdgeMap = (edge.GetEdgeType() == kUpper) ? bPhiNode.GetInPhiEdgeMap()
+                                                              : bPhiNode.GetOutPhiEdgeMap();
     for (auto iter = constEdgeMap.begin(); iter != constEdgeMap.end(); ++iter) {
       if (((res == kTrue) && (meet == Max)) || ((res == kFalse) && (meet == Min))) {
         break;
       }
       InequalEdge *in = iter->second;
-      if (in->GetEdgeType() == edge.GetEdgeType() || in->GetEdgeType() == kNone) {
+      if (IsUsableEdge(*in, edge.GetEdgeType())) {
         InequalEdge nextEdge(edge, *in);
-        if (in->GetPairEdge()) {
-          in->GetPairEdge()->SetEdgeTypeInValid();
-        }
+        InvalidatePairEdge(*in);
         res = meet(res, Prove(aNode, *(iter->first), nextEdge));
-        if (in->GetPairEdge()) {
-          in->GetPairEdge()->SetEdgeTypeValid();
-        }
+        ValidatePairEdge(*in);
       }
     }
   }
-  auto constEdgeMap = (edge.GetEdgeType() == kUpper) ? bNode.GetInWithConstEdgeMap() : bNode.GetOutWithConstEdgeMap();
+  const auto &constEdgeMap = (edge.GetEdgeType() == kUpper) ? bNode.GetInWithConstEdgeMap()
+                                                            : bNode.GetOutWithConstEdgeMap();
   for (auto iter = constEdgeMap.begin(); iter != constEdgeMap.end(); ++iter) {
     if (res == kTrue) {
       break;
     }
     InequalEdge *in = iter->second;
-    if (in->GetEdgeType() == edge.GetEdgeType() || in->GetEdgeType() == kNone) {
+    if (IsUsableEdge(*in, edge.GetEdgeType())) {
       InequalEdge nextEdge(edge, *in);
-      if (in->GetPairEdge()) {
-        in->GetPairEdge()->SetEdgeTypeInValid();
-      }
+      InvalidatePairEdge(*in);
       res = Max(res, Prove(aNode, *(iter->first), nextEdge));
-      if (in->GetPairEdge()) {
-        in->GetPairEdge()->SetEdgeTypeValid();
-      }
+      ValidatePairEdge(*in);
     }
   }
   return res;
@@ -1276,8 +1276,8 @@ bool MeStmt::IsTheSameWorkcand(const MeStmt &mestmt) const {
     if (this->GetVarLHS()->GetOStIdx() != mestmt.GetVarLHS()->GetOStIdx()) {
       return false;
     }
-  } else if (op == OP_intrinsiccallwithtype) {
-    if (static_cast<const IntrinsiccallMeStmt*>(this)->GetTyIdx() !=
+  } else if (op == OP_intrinsiccall || op == OP_intrinsiccallwithtype) {
+    if (op == OP_intrinsiccallwithtype && static_cast<const IntrinsiccallMeStmt*>(this)->GetTyIdx() !=
         static_cast<const IntrinsiccallMeStmt &>(mestmt).GetTyIdx()) {
       return false;
     }
@@ -0,0 +1,483 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_ivopts.h"
+#include "me_option.h"
+
+// An offset induction variable off mirrors the basic induction variable iv it is made from:
+//   preheader:  off0 = array(a, init) - a
+//   head:       off1 = phi(off0, off2)     iv1 = phi(init, iv2)
+//   body:       ... iread(a + off1) ...    ... iread(array(a, iv1)) ...
+//               iv2 = iv1 + step
+//               off2 = off1 + step * elemsize
+// so a + off1 equals array(a, iv1) wherever iv1 is available. off is a plain integer: it does not
+// depend on where a collector moves the object a refers to, and a itself stays live in the loop.
+// Only the accesses that come before the increment of iv are rewritten: then the live ranges of off1
+// and off2 do not overlap and all versions of off can share one preg when the SSA form is left.
+namespace maple {
+bool MeIVOpts::IsInvariant(MeExpr &expr, const LoopDesc &loop) const {
+  switch (expr.GetMeOp()) {
+    case kMeOpConst:
+    case kMeOpAddrof:
+    case kMeOpAddroffunc:
+      return true;
+    case kMeOpVar: {
+      BB *defBB = static_cast<VarMeExpr&>(expr).DefByBB();
+      return defBB == nullptr || !loop.Has(*defBB);
+    }
+    case kMeOpReg: {
+      BB *defBB = static_cast<RegMeExpr&>(expr).DefByBB();
+      return defBB == nullptr || !loop.Has(*defBB);
+    }
+    case kMeOpOp:
+    case kMeOpNary: {
+      if (expr.GetOp() != OP_intrinsicop && expr.GetMeOp() == kMeOpNary) {
+        return false;
+      }
+      for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+        MeExpr *opnd = expr.GetOpnd(i);
+        if (opnd != nullptr && !IsInvariant(*opnd, loop)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+bool MeIVOpts::IsCandidateIV(const VarMeExpr &var) const {
+  const OriginalSt *ost = irMap.GetSSATab().GetOriginalStFromID(var.GetOStIdx());
+  return ost != nullptr && ost->IsSymbolOst() && ost->IsLocal() && !ost->IsAddressTaken() && !ost->IsVolatile() &&
+         IsPrimitiveInteger(var.GetPrimType());
+}
+
+bool MeIVOpts::FindBasicIV(const LoopDesc &loop, MeVarPhiNode &phi, BasicIV &iv) const {
+  BB &head = *loop.head;
+  if (phi.GetOpnds().size() != head.GetPred().size()) {
+    return false;
+  }
+  for (size_t i = 0; i < head.GetPred().size(); ++i) {
+    if (head.GetPred(i) == loop.preheader) {
+      iv.init = phi.GetOpnd(i);
+    } else if (head.GetPred(i) == loop.latch) {
+      iv.next = phi.GetOpnd(i);
+    }
+  }
+  VarMeExpr *lhs = phi.GetLHS();
+  if (iv.init == nullptr || iv.next == nullptr || lhs == nullptr || !IsCandidateIV(*lhs)) {
+    return false;
+  }
+  if (iv.next->GetDefBy() != kDefByStmt || iv.next->GetDefStmt()->GetOp() != OP_dassign) {
+    return false;
+  }
+  auto *incStmt = static_cast<DassignMeStmt*>(iv.next->GetDefStmt());
+  if (incStmt->GetBB() == nullptr || !loop.Has(*incStmt->GetBB())) {
+    return false;
+  }
+  MeExpr *rhs = incStmt->GetRHS();
+  if (rhs->GetMeOp() != kMeOpOp || (rhs->GetOp() != OP_add && rhs->GetOp() != OP_sub) ||
+      rhs->GetPrimType() != lhs->GetPrimType()) {
+    return false;
+  }
+  MeExpr *stepExpr = nullptr;
+  if (rhs->GetOpnd(0) == lhs) {
+    stepExpr = rhs->GetOpnd(1);
+  } else if (rhs->GetOp() == OP_add && rhs->GetOpnd(1) == lhs) {
+    stepExpr = rhs->GetOpnd(0);
+  }
+  if (stepExpr == nullptr || stepExpr->GetMeOp() != kMeOpConst ||
+      static_cast<ConstMeExpr*>(stepExpr)->GetConstVal()->GetKind() != kConstInt) {
+    return false;
+  }
+  int64 step = static_cast<ConstMeExpr*>(stepExpr)->GetIntValue();
+  iv.step = rhs->GetOp() == OP_add ? step : -step;
+  iv.phi = &phi;
+  iv.incStmt = incStmt;
+  return iv.step != 0;
+}
+
+void MeIVOpts::CollectBBsAfterInc(const LoopDesc &loop, const BasicIV &iv) {
+  bbsAfterInc.clear();
+  std::vector<BB*> workList;
+  workList.push_back(iv.incStmt->GetBB());
+  while (!workList.empty()) {
+    BB *bb = workList.back();
+    workList.pop_back();
+    for (BB *succ : bb->GetSucc()) {
+      if (succ == loop.head || !loop.Has(*succ) || bbsAfterInc.find(succ->GetBBId()) != bbsAfterInc.end()) {
+        continue;
+      }
+      bbsAfterInc.insert(succ->GetBBId());
+      workList.push_back(succ);
+    }
+  }
+}
+
+bool MeIVOpts::SeesIVOnHead(const MeStmt &stmt, const BasicIV &iv) const {
+  const BB *bb = stmt.GetBB();
+  if (bbsAfterInc.find(bb->GetBBId()) != bbsAfterInc.end()) {
+    return false;
+  }
+  if (bb != iv.incStmt->GetBB()) {
+    return true;
+  }
+  for (auto &curStmt : bb->GetMeStmts()) {
+    if (&curStmt == &stmt) {
+      return true;
+    }
+    if (&curStmt == iv.incStmt) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// the distance between the addresses of two consecutive elements, the same as the lowerer uses;
+// 0 for the arrays not handled
+int64 MeIVOpts::GetElemSize(const NaryMeExpr &array) {
+  MIRType *type = GlobalTables::GetTypeTable().GetTypeFromTyIdx(array.GetTyIdx());
+  if (type == nullptr || type->GetKind() != kTypePointer) {
+    return 0;
+  }
+  MIRType *arrayType = static_cast<MIRPtrType*>(type)->GetPointedType();
+  MIRType *elemType = nullptr;
+  if (arrayType->GetKind() == kTypeFArray || arrayType->GetKind() == kTypeJArray) {
+    elemType = static_cast<MIRFarrayType*>(arrayType)->GetElemType();
+  } else if (arrayType->GetKind() == kTypeArray && static_cast<MIRArrayType*>(arrayType)->GetDim() == 1) {
+    elemType = GlobalTables::GetTypeTable().GetTypeFromTyIdx(static_cast<MIRArrayType*>(arrayType)->GetElemTyIdx());
+  }
+  // elements of reference arrays are laid out by the back end
+  if (elemType == nullptr || elemType->GetKind() != kTypeScalar) {
+    return 0;
+  }
+  return static_cast<int64>(elemType->GetSize());
+}
+
+// offsets are integers as wide as the addresses they are added to
+PrimType MeIVOpts::GetOffsetType(const NaryMeExpr &array) {
+  return GetPrimTypeSize(array.GetPrimType()) == 4 ? PTY_i32 : PTY_i64;
+}
+
+bool MeIVOpts::IsReducibleArray(const MeExpr &expr, const LoopDesc &loop, const BasicIV &iv) const {
+  if (expr.GetOp() != OP_array || expr.GetNumOpnds() != 2) {
+    return false;
+  }
+  const auto &array = static_cast<const NaryMeExpr&>(expr);
+  PrimType primType = array.GetPrimType();
+  if (array.GetBoundCheck() || (primType != PTY_ptr && primType != PTY_a32 && primType != PTY_a64)) {
+    return false;
+  }
+  return array.GetOpnd(1) == iv.phi->GetLHS() && IsInvariant(*array.GetOpnd(0), loop) && GetElemSize(array) != 0;
+}
+
+void MeIVOpts::CollectArrays(MeExpr &expr, const LoopDesc &loop, const BasicIV &iv,
+                             std::vector<NaryMeExpr*> &arrays) const {
+  if (IsReducibleArray(expr, loop, iv)) {
+    auto *array = static_cast<NaryMeExpr*>(&expr);
+    if (std::find(arrays.begin(), arrays.end(), array) == arrays.end()) {
+      arrays.push_back(array);
+    }
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectArrays(*opnd, loop, iv, arrays);
+    }
+  }
+}
+
+MeExpr *MeIVOpts::CreateArrayAt(const NaryMeExpr &array, MeExpr &index) {
+  NaryMeExpr newArray(&irMap.GetIRMapAlloc(), kInvalidExprID, array);
+  newArray.SetOpnd(1, &index);
+  return irMap.HashMeExpr(newArray);
+}
+
+// array(a, index) - a, the lowerer adds the same header and scaled index to a
+MeExpr *MeIVOpts::CreateOffsetAt(const NaryMeExpr &array, MeExpr &index) {
+  return irMap.CreateMeExprBinary(OP_sub, GetOffsetType(array), *CreateArrayAt(array, index), *array.GetOpnd(0));
+}
+
+MeIVOpts::OffsetIV MeIVOpts::CreateOffsetIV(const LoopDesc &loop, const BasicIV &iv, NaryMeExpr &array) {
+  PrimType offsetType = GetOffsetType(array);
+  RegMeExpr *init = irMap.CreateRegMeExpr(offsetType);
+  OffsetIV offsetIV;
+  offsetIV.array = &array;
+  offsetIV.cur = irMap.CreateRegMeExprVersion(*init);
+  offsetIV.next = irMap.CreateRegMeExprVersion(*init);
+
+  BB &preheader = *loop.preheader;
+  MeStmt *initStmt = irMap.CreateRegassignMeStmt(*init, *CreateOffsetAt(array, *iv.init), preheader);
+  preheader.InsertMeStmtLastBr(initStmt);
+
+  BB &head = *loop.head;
+  MeRegPhiNode *phi = irMap.CreateMeRegPhi(*offsetIV.cur);
+  phi->SetDefBB(&head);
+  for (BB *pred : head.GetPred()) {
+    RegMeExpr *opnd = pred == loop.preheader ? init : offsetIV.next;
+    phi->GetOpnds().push_back(opnd);
+    (void)opnd->GetPhiUseSet().insert(phi);
+  }
+  head.GetMeRegPhiList()[offsetIV.cur->GetOstIdx()] = phi;
+
+  BB &incBB = *iv.incStmt->GetBB();
+  MeExpr *stride = irMap.CreateIntConstMeExpr(iv.step * GetElemSize(array), offsetType);
+  MeExpr *advance = irMap.CreateMeExprBinary(OP_add, offsetType, *offsetIV.cur, *stride);
+  MeStmt *advanceStmt = irMap.CreateRegassignMeStmt(*offsetIV.next, *advance, incBB);
+  advanceStmt->CopyBase(*iv.incStmt);
+  incBB.InsertMeStmtAfter(iv.incStmt, advanceStmt);
+  return offsetIV;
+}
+
+void MeIVOpts::StrengthReduce(const LoopDesc &loop, const BasicIV &iv, std::vector<OffsetIV> &offsetIVs) {
+  std::vector<NaryMeExpr*> arrays;
+  std::vector<MeStmt*> users;
+  for (BBId bbId : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbId);
+    for (auto &stmt : bb->GetMeStmts()) {
+      if (!SeesIVOnHead(stmt, iv)) {
+        continue;
+      }
+      bool used = false;
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        MeExpr *opnd = stmt.GetOpnd(i);
+        if (opnd == nullptr) {
+          continue;
+        }
+        std::vector<NaryMeExpr*> stmtArrays;
+        CollectArrays(*opnd, loop, iv, stmtArrays);
+        used = used || !stmtArrays.empty();
+        for (NaryMeExpr *array : stmtArrays) {
+          if (std::find(arrays.begin(), arrays.end(), array) == arrays.end()) {
+            arrays.push_back(array);
+          }
+        }
+      }
+      if (used) {
+        users.push_back(&stmt);
+      }
+    }
+  }
+  // arrays of the same type have the same header and element size, hence the same offsets
+  std::map<TyIdx, size_t> offsetIVOfType;
+  for (NaryMeExpr *array : arrays) {
+    auto it = offsetIVOfType.find(array->GetTyIdx());
+    if (it == offsetIVOfType.end()) {
+      it = offsetIVOfType.emplace(array->GetTyIdx(), offsetIVs.size()).first;
+      offsetIVs.push_back(CreateOffsetIV(loop, iv, *array));
+    }
+    MeExpr *address = irMap.CreateMeExprBinary(OP_add, array->GetPrimType(), *array->GetOpnd(0),
+                                               *offsetIVs[it->second].cur);
+    for (MeStmt *stmt : users) {
+      (void)irMap.ReplaceMeExprStmt(*stmt, *array, *address);
+    }
+    ++reducedArrays;
+  }
+}
+
+bool MeIVOpts::IsNonNegative(const MeExpr &expr) {
+  switch (expr.GetMeOp()) {
+    case kMeOpConst:
+      return IsPrimitiveInteger(expr.GetPrimType()) && static_cast<const ConstMeExpr&>(expr).GeZero();
+    case kMeOpNary:
+      return expr.GetOp() == OP_intrinsicop &&
+             static_cast<const NaryMeExpr&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH;
+    case kMeOpVar: {
+      const auto &var = static_cast<const VarMeExpr&>(expr);
+      if (var.GetDefBy() != kDefByStmt || var.GetDefStmt()->GetOp() != OP_dassign) {
+        return false;
+      }
+      return IsNonNegative(*static_cast<DassignMeStmt*>(var.GetDefStmt())->GetRHS());
+    }
+    case kMeOpReg: {
+      const auto &reg = static_cast<const RegMeExpr&>(expr);
+      if (reg.GetDefBy() != kDefByStmt || reg.GetDefStmt()->GetOp() != OP_regassign) {
+        return false;
+      }
+      return IsNonNegative(*static_cast<RegassignMeStmt*>(reg.GetDefStmt())->GetRHS());
+    }
+    default:
+      return false;
+  }
+}
+
+bool MeIVOpts::HasOtherUses(const MeExpr &expr, const MeExpr &target) const {
+  if (&expr == &target) {
+    return true;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr && HasOtherUses(*opnd, target)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// true if iv has uses other than its own increment and phi and the exit test
+bool MeIVOpts::IsIVUsedElsewhere(const BasicIV &iv, const MeStmt &test) const {
+  const VarMeExpr *cur = iv.phi->GetLHS();
+  for (BB *bb : func.GetAllBBs()) {
+    if (bb == nullptr) {
+      continue;
+    }
+    for (auto &varPhi : bb->GetMevarPhiList()) {
+      for (VarMeExpr *opnd : varPhi.second->GetOpnds()) {
+        if (opnd == cur || (opnd == iv.next && varPhi.second != iv.phi)) {
+          return true;
+        }
+      }
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      if (&stmt == &test || &stmt == iv.incStmt) {
+        continue;
+      }
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        MeExpr *opnd = stmt.GetOpnd(i);
+        if (opnd != nullptr && (HasOtherUses(*opnd, *cur) || HasOtherUses(*opnd, *iv.next))) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// Replaces iv < n (in any of its four spellings) by off < array(a, n) - a. Mapping iv to its offset
+// in a keeps the order only when no offset overflows: iv counts up by one from a non-negative start
+// and n is non-negative, so iv stays within [0, max(init, n)].
+bool MeIVOpts::ReplaceTest(const LoopDesc &loop, const BasicIV &iv, const OffsetIV &offsetIV, MeStmt &test) {
+  MeExpr *cond = test.GetOpnd(0);
+  if (cond->GetMeOp() != kMeOpOp) {
+    return false;
+  }
+  auto *cmp = static_cast<OpMeExpr*>(cond);
+  Opcode op = cmp->GetOp();
+  if (!IsSignedInteger(cmp->GetOpndType())) {
+    return false;
+  }
+  size_t ivIdx = (cmp->GetOpnd(0) == iv.phi->GetLHS() || cmp->GetOpnd(0) == iv.next) ? 0 : 1;
+  MeExpr *ivOpnd = cmp->GetOpnd(ivIdx);
+  MeExpr *bound = cmp->GetOpnd(1 - ivIdx);
+  bool strictBelow = (ivIdx == 0 && (op == OP_lt || op == OP_ge)) || (ivIdx == 1 && (op == OP_gt || op == OP_le));
+  if (!strictBelow || iv.step != 1 || !IsNonNegative(*iv.init) || !IsInvariant(*bound, loop) ||
+      !IsNonNegative(*bound)) {
+    return false;
+  }
+  RegMeExpr *offset = nullptr;
+  if (ivOpnd == iv.next) {
+    offset = offsetIV.next;
+  } else if (ivOpnd == iv.phi->GetLHS() && SeesIVOnHead(test, iv)) {
+    offset = offsetIV.cur;
+  } else {
+    return false;
+  }
+  PrimType offsetType = GetOffsetType(*offsetIV.array);
+  RegMeExpr *limit = irMap.CreateRegMeExpr(offsetType);
+  MeStmt *limitStmt = irMap.CreateRegassignMeStmt(*limit, *CreateOffsetAt(*offsetIV.array, *bound), *loop.preheader);
+  loop.preheader->InsertMeStmtLastBr(limitStmt);
+  MeExpr *newCond = irMap.CreateMeExprCompare(op, cmp->GetPrimType(), offsetType, ivIdx == 0 ? *offset : *limit,
+                                              ivIdx == 0 ? *limit : *offset);
+  test.SetOpnd(0, newCond);
+  ++replacedTests;
+  return true;
+}
+
+void MeIVOpts::ReplaceExitTests(const LoopDesc &loop, const BasicIV &iv, const OffsetIV &offsetIV) {
+  for (BBId bbId : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbId);
+    MeStmt *last = bb->GetLastMe();
+    if (last == nullptr || !last->IsCondBr()) {
+      continue;
+    }
+    bool isExit = false;
+    for (BB *succ : bb->GetSucc()) {
+      isExit = isExit || !loop.Has(*succ);
+    }
+    MeExpr *cond = last->GetOpnd(0);
+    if (!isExit || !(HasOtherUses(*cond, *iv.phi->GetLHS()) || HasOtherUses(*cond, *iv.next))) {
+      continue;
+    }
+    if (!IsIVUsedElsewhere(iv, *last)) {
+      (void)ReplaceTest(loop, iv, offsetIV, *last);
+    }
+    return;
+  }
+}
+
+bool MeIVOpts::IsInnermost(const LoopDesc &loop) const {
+  for (LoopDesc *other : identLoops.GetMeLoops()) {
+    if (other->parent == &loop) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MeIVOpts::OptimizeLoop(const LoopDesc &loop) {
+  if (loop.preheader == nullptr || loop.latch == nullptr || loop.HasTryBB() || loop.head->GetPred().size() != 2 ||
+      !IsInnermost(loop)) {
+    return false;
+  }
+  std::vector<MeVarPhiNode*> phis;
+  for (auto &varPhi : loop.head->GetMevarPhiList()) {
+    if (varPhi.second->GetIsLive()) {
+      phis.push_back(varPhi.second);
+    }
+  }
+  bool changed = false;
+  for (MeVarPhiNode *phi : phis) {
+    BasicIV iv;
+    if (!FindBasicIV(loop, *phi, iv)) {
+      continue;
+    }
+    CollectBBsAfterInc(loop, iv);
+    std::vector<OffsetIV> offsetIVs;
+    StrengthReduce(loop, iv, offsetIVs);
+    if (offsetIVs.empty()) {
+      continue;
+    }
+    changed = true;
+    ReplaceExitTests(loop, iv, offsetIVs.front());
+  }
+  return changed;
+}
+
+bool MeIVOpts::Run() {
+  bool changed = false;
+  for (LoopDesc *loop : identLoops.GetMeLoops()) {
+    changed = OptimizeLoop(*loop) || changed;
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "ivopts: " << reducedArrays << " array addresses strength reduced, " << replacedTests
+                           << " exit tests replaced in " << func.GetName() << '\n';
+  }
+  return changed;
+}
+
+AnalysisResult *MeDoIVOpts::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+  auto *irMap = static_cast<MeIRMap*>(m->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+  CHECK_NULL_FATAL(irMap);
+  auto *identLoops = static_cast<IdentifyLoops*>(m->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_NULL_FATAL(identLoops);
+  MeIVOpts ivOpts(*func, *irMap, *identLoops, DEBUGFUNC(func));
+  if (ivOpts.Run() && DEBUGFUNC(func)) {
+    LogInfo::MapleLogger() << "\n============== After IV opts =============" << '\n';
+    func->Dump(false);
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -398,7 +398,8 @@ void MeDoLoopCanon::AddPreheader(MeFunction &func) {
   }
 }
 
-void MeDoLoopCanon::InsertNewExitBB(MeFunction &func, LoopDesc &loop) {
+// dom, when not null, is kept valid across the new exit bbs
+void MeDoLoopCanon::InsertNewExitBB(MeFunction &func, LoopDesc &loop, Dominance *dom) {
   for (auto pair : loop.inloopBB2exitBBs) {
     BB *curBB = func.GetBBFromID(pair.first);
     for (auto succBB : *pair.second) {
@@ -423,6 +424,9 @@ void MeDoLoopCanon::InsertNewExitBB(MeFunction &func, LoopDesc &loop) {
         curBB->ReplaceSucc(succBB, newExitBB);
         --index;
         succBB->AddPred(*newExitBB, index);
+        if (dom != nullptr) {
+          dom->UpdateAfterSplitEdge(*curBB, *newExitBB, *succBB);
+        }
 
         loop.ReplaceInloopBB2exitBBs(*curBB, *succBB, *newExitBB);
         if (curBB->GetStmtNodes().empty()) {
@@ -443,7 +447,7 @@ void MeDoLoopCanon::InsertNewExitBB(MeFunction &func, LoopDesc &loop) {
   }
 }
 
-void MeDoLoopCanon::InsertExitBB(MeFunction &func, LoopDesc &loop) {
+void MeDoLoopCanon::InsertExitBB(MeFunction &func, LoopDesc &loop, Dominance *dom) {
   std::set<BB*> traveledBBs;
   std::queue<BB*> inLoopBBs;
   inLoopBBs.push(loop.head);
@@ -472,10 +476,11 @@ void MeDoLoopCanon::InsertExitBB(MeFunction &func, LoopDesc &loop) {
       }
     }
   }
-  InsertNewExitBB(func, loop);
+  InsertNewExitBB(func, loop, dom);
 }
 
-void MeDoLoopCanon::SplitCondGotBB(MeFunction &func, LoopDesc &loop) {
+// return true if the cfg is changed
+bool MeDoLoopCanon::SplitCondGotBB(MeFunction &func, LoopDesc &loop) {
   auto exitBB = func.GetBBFromID(loop.inloopBB2exitBBs.begin()->first);
   StmtNode *lastStmt = &(exitBB->GetStmtNodes().back());
   if (lastStmt->GetOpCode() != OP_brfalse && lastStmt->GetOpCode() != OP_brtrue && lastStmt->GetOpCode() != OP_switch) {
@@ -489,7 +494,7 @@ void MeDoLoopCanon::SplitCondGotBB(MeFunction &func, LoopDesc &loop) {
     }
   }
   if (notOnlyHasBrStmt) {
-    return;
+    return false;
   }
   BB *newFallthru = func.NewBasicBlock();
   newFallthru->SetKind(kBBFallthru);
@@ -520,6 +525,7 @@ void MeDoLoopCanon::SplitCondGotBB(MeFunction &func, LoopDesc &loop) {
   }
   exitBB->RemoveAllPred();
   newFallthru->AddSucc(*exitBB);
+  return true;
 }
 
 bool MeDoLoopCanon::IsDoWhileLoop(MeFunction &func, const LoopDesc &loop) const {
@@ -553,6 +559,9 @@ void MeDoLoopCanon::ExecuteLoopNormalization(MeFunction &func,  MeFuncResultMgr
   if (meLoop == nullptr) {
     return;
   }
+  // the dominance the loops are built on is updated across the new exit bbs, so that later phases
+  // do not compute it again; splitting a block is not handled and drops it
+  auto *newDom = static_cast<Dominance*>(m->FindAnalysisResult(MeFuncPhase_DOMINANCE, &func));
   for (auto loop : meLoop->GetMeLoops()) {
     if (loop->HasTryBB()) {
       continue;
@@ -560,12 +569,12 @@ void MeDoLoopCanon::ExecuteLoopNormalization(MeFunction &func,  MeFuncResultMgr
 
     if (!loop->IsCanonicalLoop()) {
       CHECK_FATAL(loop->inloopBB2exitBBs.size() == 0, "must be zero");
-      InsertExitBB(func, *loop);
+      InsertExitBB(func, *loop, newDom);
       loop->SetIsCanonicalLoop(true);
     }
     if (loop->inloopBB2exitBBs.size() == 1 && loop->inloopBB2exitBBs.begin()->second->size() == 1 &&
-        IsDoWhileLoop(func, *loop)) {
-      SplitCondGotBB(func, *loop);
+        IsDoWhileLoop(func, *loop) && SplitCondGotBB(func, *loop)) {
+      newDom = nullptr;
     }
   }
   if (DEBUGFUNC(&func)) {
@@ -573,8 +582,12 @@ void MeDoLoopCanon::ExecuteLoopNormalization(MeFunction &func,  MeFuncResultMgr
     func.Dump(true);
     func.GetTheCfg()->DumpToFile("cfgafterLoopNormalization");
   }
-  m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, &func);
   m->InvalidAnalysisResult(MeFuncPhase_MELOOP, &func);
+  if (newDom != nullptr) {
+    newDom->UpdateTreeOrders();
+  } else {
+    m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, &func);
+  }
 }
 
 AnalysisResult *MeDoLoopCanon::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
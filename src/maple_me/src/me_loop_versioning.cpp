@@ -0,0 +1,459 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_loop_versioning.h"
+#include <algorithm>
+#include <map>
+#include "mir_builder.h"
+#include "me_option.h"
+
+// The loops looked for have been canonicalized to do-while form: head, body and a test block T
+// that is the latch or the only pred of an empty latch. T branches back while the induction
+// variable iv, incremented by 1 exactly once per iteration in a block dominating T, compares
+// below an invariant bound n. On loop head iv is either its value on entry, lo, or a value T
+// found below n, so the accesses a[iv] evaluated before the increment all stay within [0, len(a))
+// if, on entry,
+//   lo >= 0, a != null, lo < len(a), and n <= len(a) (n < len(a) when T tests iv <= n).
+// Those checks are inserted between the preheader and the head; when they all pass, a clone of
+// the loop without the bounds checks of these accesses is run instead. Both loops stay canonical,
+// each with a fallthru preheader of its own.
+namespace maple {
+namespace {
+constexpr size_t kMaxStmtsToVersion = 64;  // the loop is cloned as a whole
+}  // namespace
+
+void LoopVersioning::CollectAddrTaken(const BaseNode &expr) {
+  if (expr.GetOpCode() == OP_addrof) {
+    (void)addrTaken.insert(static_cast<const AddrofNode&>(expr).GetStIdx());
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    CollectAddrTaken(*expr.Opnd(i));
+  }
+}
+
+void LoopVersioning::CollectLoopDefs(const LoopDesc &loop) {
+  loopDefs.clear();
+  for (BBId bbID : loop.loopBBs) {
+    for (auto &stmt : func.GetBBFromID(bbID)->GetStmtNodes()) {
+      if (stmt.GetOpCode() == OP_dassign) {
+        (void)loopDefs.insert(static_cast<DassignNode&>(stmt).GetStIdx());
+      }
+      CallReturnVector *returnValues = stmt.GetCallReturnVector();
+      if (returnValues == nullptr) {
+        continue;
+      }
+      for (auto &returnValue : *returnValues) {
+        (void)loopDefs.insert(returnValue.first);
+      }
+    }
+  }
+}
+
+bool LoopVersioning::IsInvariantLocal(const BaseNode &expr) const {
+  if (expr.GetOpCode() != OP_dread) {
+    return false;
+  }
+  auto &dread = static_cast<const AddrofNode&>(expr);
+  StIdx stIdx = dread.GetStIdx();
+  return dread.GetFieldID() == 0 && stIdx.Islocal() && addrTaken.find(stIdx) == addrTaken.end() &&
+         loopDefs.find(stIdx) == loopDefs.end();
+}
+
+bool LoopVersioning::IsInvariantBound(const BaseNode &expr) const {
+  if (expr.GetPrimType() != PTY_i32) {
+    return false;
+  }
+  switch (expr.GetOpCode()) {
+    case OP_constval:
+      return true;
+    case OP_dread:
+      return IsInvariantLocal(expr);
+    case OP_intrinsicop:
+      return static_cast<const IntrinsicopNode&>(expr).GetIntrinsic() == INTRN_JAVA_ARRAY_LENGTH &&
+             expr.NumOpnds() == 1 && expr.Opnd(0)->GetPrimType() == PTY_ref && IsInvariantLocal(*expr.Opnd(0));
+    default:
+      return false;
+  }
+}
+
+bool LoopVersioning::IsIvRead(const BaseNode &expr, const StIdx &ivStIdx) const {
+  if (expr.GetOpCode() != OP_dread || expr.GetPrimType() != PTY_i32) {
+    return false;
+  }
+  auto &dread = static_cast<const AddrofNode&>(expr);
+  return dread.GetStIdx() == ivStIdx && dread.GetFieldID() == 0;
+}
+
+// iv = iv + 1
+bool LoopVersioning::IsIncrement(const StmtNode &stmt, const StIdx &ivStIdx) const {
+  if (stmt.GetOpCode() != OP_dassign) {
+    return false;
+  }
+  auto &dassign = static_cast<const DassignNode&>(stmt);
+  const BaseNode *rhs = dassign.GetRHS();
+  if (dassign.GetFieldID() != 0 || rhs->GetOpCode() != OP_add || rhs->GetPrimType() != PTY_i32) {
+    return false;
+  }
+  const BaseNode *opnd0 = rhs->Opnd(0);
+  const BaseNode *opnd1 = rhs->Opnd(1);
+  if (opnd0->GetOpCode() == OP_constval) {
+    std::swap(opnd0, opnd1);
+  }
+  if (!IsIvRead(*opnd0, ivStIdx) || opnd1->GetOpCode() != OP_constval) {
+    return false;
+  }
+  const MIRConst *constVal = static_cast<const ConstvalNode*>(opnd1)->GetConstVal();
+  return constVal->GetKind() == kConstInt && constVal->IsOne();
+}
+
+bool LoopVersioning::IsVersionableArray(const BaseNode &expr, const Candidate &cand) const {
+  if (expr.GetOpCode() != OP_array) {
+    return false;
+  }
+  auto &array = static_cast<const ArrayNode&>(expr);
+  return array.GetBoundsCheck() && array.NumOpnds() == 2 && array.Opnd(0)->GetPrimType() == PTY_ref &&
+         IsInvariantLocal(*array.Opnd(0)) && IsIvRead(*array.Opnd(1), cand.ivStIdx);
+}
+
+BB *LoopVersioning::GetTestBB(const LoopDesc &loop) const {
+  BB *testBB = loop.latch;
+  if (testBB == nullptr) {
+    return nullptr;
+  }
+  if (testBB->GetKind() == kBBFallthru && testBB->IsEmpty() && testBB->GetPred().size() == 1) {
+    testBB = testBB->GetPred(0);
+  }
+  if (testBB->GetKind() != kBBCondGoto || !loop.Has(*testBB) || testBB->GetSucc().size() != 2) {
+    return nullptr;
+  }
+  if (loop.Has(*testBB->GetSucc(0)) == loop.Has(*testBB->GetSucc(1))) {
+    return nullptr;
+  }
+  return testBB;
+}
+
+// find iv and n from the condition that keeps the loop going
+bool LoopVersioning::AnalyzeTest(const LoopDesc &loop, const BB &testBB, Candidate &cand) const {
+  auto &condGoto = static_cast<const CondGotoNode&>(testBB.GetStmtNodes().back());
+  const BaseNode *cond = condGoto.Opnd(0);
+  Opcode op = cond->GetOpCode();
+  if ((op != OP_lt && op != OP_le && op != OP_gt && op != OP_ge) ||
+      static_cast<const CompareNode*>(cond)->GetOpndType() != PTY_i32) {
+    return false;
+  }
+  bool continueOnTrue = (condGoto.GetOpCode() == OP_brtrue) == loop.Has(*testBB.GetSucc(1));
+  if (!continueOnTrue) {
+    op = (op == OP_lt) ? OP_ge : (op == OP_le) ? OP_gt : (op == OP_gt) ? OP_le : OP_lt;
+  }
+  BaseNode *lhs = cond->Opnd(0);
+  BaseNode *rhs = cond->Opnd(1);
+  if (rhs->GetOpCode() == OP_dread && lhs->GetOpCode() != OP_dread) {
+    std::swap(lhs, rhs);
+    op = (op == OP_lt) ? OP_gt : (op == OP_le) ? OP_ge : (op == OP_gt) ? OP_lt : OP_le;
+  }
+  if (op != OP_lt && op != OP_le) {
+    return false;
+  }
+  if (lhs->GetOpCode() != OP_dread || lhs->GetPrimType() != PTY_i32) {
+    return false;
+  }
+  auto *ivRead = static_cast<AddrofNode*>(lhs);
+  if (ivRead->GetFieldID() != 0 || !ivRead->GetStIdx().Islocal() ||
+      addrTaken.find(ivRead->GetStIdx()) != addrTaken.end() || !IsInvariantBound(*rhs)) {
+    return false;
+  }
+  cand.ivStIdx = ivRead->GetStIdx();
+  cand.bound = rhs;
+  cand.inclusive = (op == OP_le);
+  return true;
+}
+
+// the statements evaluated before the increment in an iteration, once it is known to be the only
+// definition of iv in the loop and to happen before the test
+bool LoopVersioning::CollectCheckedStmts(const BB &testBB, Candidate &cand) const {
+  const LoopDesc &loop = *cand.loop;
+  BB *incBB = nullptr;
+  const StmtNode *incStmt = nullptr;
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    for (auto &stmt : bb->GetStmtNodes()) {
+      bool definesIv = stmt.GetOpCode() == OP_dassign && static_cast<DassignNode&>(stmt).GetStIdx() == cand.ivStIdx;
+      CallReturnVector *returnValues = stmt.GetCallReturnVector();
+      if (returnValues != nullptr) {
+        for (auto &returnValue : *returnValues) {
+          definesIv = definesIv || returnValue.first == cand.ivStIdx;
+        }
+      }
+      if (!definesIv) {
+        continue;
+      }
+      if (incStmt != nullptr || !IsIncrement(stmt, cand.ivStIdx)) {
+        return false;
+      }
+      incBB = bb;
+      incStmt = &stmt;
+    }
+  }
+  if (incStmt == nullptr || !dom.Dominate(*incBB, testBB)) {
+    return false;
+  }
+  // blocks reached from the increment without going around the loop again
+  std::set<BBId> afterInc;
+  std::vector<BB*> workList(incBB->GetSucc().begin(), incBB->GetSucc().end());
+  while (!workList.empty()) {
+    BB *bb = workList.back();
+    workList.pop_back();
+    if (bb == loop.head || !loop.Has(*bb) || !afterInc.insert(bb->GetBBId()).second) {
+      continue;
+    }
+    workList.insert(workList.end(), bb->GetSucc().begin(), bb->GetSucc().end());
+  }
+  if (afterInc.find(incBB->GetBBId()) != afterInc.end()) {
+    return false;
+  }
+  for (BBId bbID : loop.loopBBs) {
+    if (afterInc.find(bbID) != afterInc.end()) {
+      continue;
+    }
+    for (auto &stmt : func.GetBBFromID(bbID)->GetStmtNodes()) {
+      (void)cand.checkedStmts.insert(&stmt);
+      if (&stmt == incStmt) {
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+void LoopVersioning::CollectArrayBases(const BaseNode &expr, Candidate &cand) const {
+  if (IsVersionableArray(expr, cand)) {
+    StIdx baseStIdx = static_cast<const AddrofNode*>(expr.Opnd(0))->GetStIdx();
+    if (std::find(cand.bases.begin(), cand.bases.end(), baseStIdx) == cand.bases.end()) {
+      cand.bases.push_back(baseStIdx);
+    }
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    CollectArrayBases(*expr.Opnd(i), cand);
+  }
+}
+
+void LoopVersioning::ClearBoundsChecks(BaseNode &expr, const Candidate &cand) const {
+  if (IsVersionableArray(expr, cand)) {
+    static_cast<ArrayNode&>(expr).SetBoundsCheck(false);
+  }
+  for (size_t i = 0; i < expr.NumOpnds(); ++i) {
+    ClearBoundsChecks(*expr.Opnd(i), cand);
+  }
+}
+
+bool LoopVersioning::IsCandidateLoop(const LoopDesc &loop) const {
+  if (loop.HasTryBB() || !loop.IsCanonicalLoop() || loop.preheader == nullptr ||
+      loop.preheader == func.GetCommonEntryBB() || loop.preheader->GetKind() != kBBFallthru ||
+      loop.preheader->GetSucc().size() != 1 || loop.preheader->GetAttributes(kBBAttrIsTry) ||
+      loop.head->GetPred().size() != 2) {
+    return false;
+  }
+  for (LoopDesc *other : identLoops.GetMeLoops()) {
+    if (other->parent == &loop) {
+      return false;  // innermost loops only
+    }
+  }
+  size_t stmtCount = 0;
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    if (bb->GetKind() != kBBFallthru && bb->GetKind() != kBBGoto && bb->GetKind() != kBBCondGoto) {
+      return false;
+    }
+    if (bb->GetAttributes(kBBAttrIsTry) || bb->GetAttributes(kBBAttrIsCatch)) {
+      return false;
+    }
+    for (auto it = bb->GetStmtNodes().begin(); it != bb->GetStmtNodes().end(); ++it) {
+      if (++stmtCount > kMaxStmtsToVersion) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+BaseNode *LoopVersioning::CreateDread(const StIdx &stIdx, PrimType primType) const {
+  return mirModule.CurFuncCodeMemPool()->New<AddrofNode>(OP_dread, primType, stIdx, 0);
+}
+
+BaseNode *LoopVersioning::CreateArrayLength(const StIdx &arrayStIdx) const {
+  MapleVector<BaseNode*> opnds(mirModule.GetCurFuncCodeMPAllocator().Adapter());
+  opnds.push_back(CreateDread(arrayStIdx, PTY_ref));
+  return mirModule.GetMIRBuilder()->CreateExprIntrinsicop(INTRN_JAVA_ARRAY_LENGTH, OP_intrinsicop,
+                                                          *GlobalTables::GetTypeTable().GetInt32(), opnds);
+}
+
+// the conditions the clone relies on, in the order they are evaluated; the length of an array is
+// only asked for once it is known not to be null
+void LoopVersioning::CreateEntryChecks(const Candidate &cand, std::vector<BaseNode*> &conds) const {
+  MIRBuilder *builder = mirModule.GetMIRBuilder();
+  MIRType &boolType = *GlobalTables::GetTypeTable().GetUInt1();
+  MIRType &i32Type = *GlobalTables::GetTypeTable().GetInt32();
+  MIRType &refType = *GlobalTables::GetTypeTable().GetRef();
+  MapleAllocator &codeAlloc = mirModule.GetCurFuncCodeMPAllocator();
+  if (cand.bound->GetOpCode() == OP_intrinsicop) {
+    conds.push_back(builder->CreateExprCompare(OP_ne, boolType, refType, cand.bound->Opnd(0)->CloneTree(codeAlloc),
+                                               builder->CreateIntConst(0, PTY_ref)));
+  }
+  conds.push_back(builder->CreateExprCompare(OP_ge, boolType, i32Type, CreateDread(cand.ivStIdx, PTY_i32),
+                                             builder->CreateIntConst(0, PTY_i32)));
+  for (const StIdx &baseStIdx : cand.bases) {
+    conds.push_back(builder->CreateExprCompare(OP_ne, boolType, refType, CreateDread(baseStIdx, PTY_ref),
+                                               builder->CreateIntConst(0, PTY_ref)));
+    conds.push_back(builder->CreateExprCompare(OP_lt, boolType, i32Type, CreateDread(cand.ivStIdx, PTY_i32),
+                                               CreateArrayLength(baseStIdx)));
+    conds.push_back(builder->CreateExprCompare(cand.inclusive ? OP_lt : OP_le, boolType, i32Type,
+                                               cand.bound->CloneTree(codeAlloc), CreateArrayLength(baseStIdx)));
+  }
+}
+
+BB *LoopVersioning::NewBBOutsideLoop(const BB &preheader, BBKind kind) {
+  BB *bb = func.NewBasicBlock();
+  bb->SetKind(kind);
+  bb->SetAttributes(kBBAttrArtificial);
+  if (preheader.GetAttributes(kBBAttrIsInLoop)) {
+    bb->SetAttributes(kBBAttrIsInLoop);
+  }
+  return bb;
+}
+
+// preheader -> check 1 -> ... -> check k -> fastEntry -> clone of the loop
+//                 |                  |
+//                 +------------------+---> slowEntry -> original loop
+void LoopVersioning::Version(const Candidate &cand) {
+  LoopDesc &loop = *cand.loop;
+  BB &preheader = *loop.preheader;
+  BB &head = *loop.head;
+  std::map<BBId, BB*> clones;
+  for (BBId bbID : loop.loopBBs) {
+    BB *bb = func.GetBBFromID(bbID);
+    BB *newBB = func.NewBasicBlock();
+    newBB->SetKind(bb->GetKind());
+    newBB->SetAttributes(kBBAttrIsInLoop);
+    if (bb->GetAttributes(kBBAttrArtificial)) {
+      newBB->SetAttributes(kBBAttrArtificial);
+    }
+    func.CloneBasicBlock(*newBB, *bb);
+    auto origIt = bb->GetStmtNodes().begin();
+    for (auto &stmt : newBB->GetStmtNodes()) {
+      if (cand.checkedStmts.find(&*origIt) != cand.checkedStmts.end()) {
+        ClearBoundsChecks(stmt, cand);
+      }
+      ++origIt;
+    }
+    clones[bbID] = newBB;
+  }
+  for (auto &clone : clones) {
+    BB *bb = func.GetBBFromID(clone.first);
+    BB *newBB = clone.second;
+    for (BB *succ : bb->GetSucc()) {
+      auto it = clones.find(succ->GetBBId());
+      newBB->AddSucc(it == clones.end() ? *succ : *it->second);
+    }
+    if (newBB->GetKind() == kBBGoto && loop.Has(*bb->GetSucc(0))) {
+      static_cast<GotoNode&>(newBB->GetStmtNodes().back()).SetOffset(func.GetOrCreateBBLabel(*newBB->GetSucc(0)));
+    } else if (newBB->GetKind() == kBBCondGoto && loop.Has(*bb->GetSucc(1))) {
+      static_cast<CondGotoNode&>(newBB->GetStmtNodes().back()).SetOffset(
+          func.GetOrCreateBBLabel(*newBB->GetSucc(1)));
+    }
+  }
+  BB *slowEntry = NewBBOutsideLoop(preheader, kBBFallthru);
+  head.ReplacePred(&preheader, slowEntry);
+  LabelIdx slowLabel = func.GetOrCreateBBLabel(*slowEntry);
+  std::vector<BaseNode*> conds;
+  CreateEntryChecks(cand, conds);
+  BB *prev = &preheader;
+  for (BaseNode *cond : conds) {
+    BB *checkBB = NewBBOutsideLoop(preheader, kBBCondGoto);
+    checkBB->AddStmtNode(mirModule.GetMIRBuilder()->CreateStmtCondGoto(cond, OP_brfalse, slowLabel));
+    prev->AddSucc(*checkBB);
+    if (prev != &preheader) {
+      prev->AddSucc(*slowEntry);
+    }
+    prev = checkBB;
+  }
+  BB *fastEntry = NewBBOutsideLoop(preheader, kBBFallthru);
+  prev->AddSucc(*fastEntry);
+  prev->AddSucc(*slowEntry);
+  fastEntry->AddSucc(*clones[head.GetBBId()]);
+}
+
+bool LoopVersioning::Run() {
+  for (BB *bb : func.GetAllBBs()) {
+    if (bb == nullptr) {
+      continue;
+    }
+    for (auto &stmt : bb->GetStmtNodes()) {
+      CollectAddrTaken(stmt);
+    }
+  }
+  std::vector<Candidate> candidates;
+  for (LoopDesc *loop : identLoops.GetMeLoops()) {
+    if (!IsCandidateLoop(*loop)) {
+      continue;
+    }
+    BB *testBB = GetTestBB(*loop);
+    if (testBB == nullptr) {
+      continue;
+    }
+    CollectLoopDefs(*loop);
+    Candidate cand;
+    cand.loop = loop;
+    if (!AnalyzeTest(*loop, *testBB, cand) || !CollectCheckedStmts(*testBB, cand)) {
+      continue;
+    }
+    for (const StmtNode *stmt : cand.checkedStmts) {
+      CollectArrayBases(*stmt, cand);
+    }
+    if (!cand.bases.empty()) {
+      candidates.push_back(cand);
+    }
+  }
+  // innermost loops do not share blocks, versioning one leaves the others as they were found
+  for (const Candidate &cand : candidates) {
+    if (enabledDebug) {
+      LogInfo::MapleLogger() << "loop versioning: loop with head BB " << cand.loop->head->GetBBId() << " versioned on "
+                             << cand.bases.size() << " arrays\n";
+    }
+    CollectLoopDefs(*cand.loop);
+    Version(cand);
+  }
+  return !candidates.empty();
+}
+
+AnalysisResult *MeDoLoopVersioning::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+  if (!func->GetMIRModule().IsJavaModule()) {
+    return nullptr;
+  }
+  auto *dom = static_cast<Dominance*>(m->GetAnalysisResult(MeFuncPhase_DOMINANCE, func));
+  CHECK_NULL_FATAL(dom);
+  auto *identLoops = static_cast<IdentifyLoops*>(m->GetAnalysisResult(MeFuncPhase_MELOOP, func));
+  CHECK_NULL_FATAL(identLoops);
+  LoopVersioning loopVersioning(*func, *identLoops, *dom, DEBUGFUNC(func));
+  if (!loopVersioning.Run()) {
+    return nullptr;
+  }
+  m->InvalidAnalysisResult(MeFuncPhase_MELOOP, func);
+  m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+  if (DEBUGFUNC(func)) {
+    LogInfo::MapleLogger() << "\n============== After loop versioning =============" << '\n';
+    func->Dump(true);
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -67,6 +67,9 @@ bool MeOption::rcLowering = true;
 bool MeOption::optDirectCall = false;
 bool MeOption::propAtPhi = true;
 bool MeOption::dseKeepRef = false;
+bool MeOption::memPoolStat = false;
+bool MeOption::releaseDeadResults = false;
+bool MeOption::escapeAnalysis = true;
 
 enum OptionIndex {
   kMeHelp = kCommonOptionEnd + 1,
@@ -114,6 +117,9 @@ enum OptionIndex {
   kLpreSpeculate,
   kNoLpreSpeculate,
   kSpillatCatch,
+  kMeMemPoolStat,
+  kReleaseDeadResults,
+  kEscapeAnalysis,
 };
 
 const Descriptor kUsage[] = {
@@ -448,6 +454,37 @@ const Descriptor kUsage[] = {
     "  --no-regreadatreturn        \tDisable regreadatreturn\n",
     "me",
     {} },
+  { kMeMemPoolStat,
+    kEnable,
+    nullptr,
+    "mempool-stat",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --mempool-stat              \tDump the mempool usage of each phase and the peak of each function\n"
+    "  --no-mempool-stat           \tDon't dump mempool usage\n",
+    "me",
+    {} },
+  { kReleaseDeadResults,
+    kEnable,
+    nullptr,
+    "release-dead-results",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --release-dead-results      \tRelease an analysis result once the last phase using it has run\n"
+    "  --no-release-dead-results   \tKeep analysis results until the function is done\n",
+    "me",
+    {} },
+  { kEscapeAnalysis,
+    kEnable,
+    nullptr,
+    "escape-analysis",
+    kBuildTypeExperimental,
+    kArgCheckPolicyBool,
+    "  --escape-analysis           \tLet new objects passed to calls that leave them alone keep their unwritten\n"
+    "                              \tfields in rclowering, so stores there need no decrement of the old value\n"
+    "  --no-escape-analysis        \tDisable escape-analysis\n",
+    "me",
+    {} },
   { kUnknown,
     0,
     nullptr,
@@ -642,6 +679,15 @@ bool MeOption::SolveOptions(const std::vector<mapleOption::Option> &opts, bool i
       case kSpillatCatch:
         spillAtCatch = (opt.Type() == kEnable);
         break;
+      case kMeMemPoolStat:
+        memPoolStat = (opt.Type() == kEnable);
+        break;
+      case kReleaseDeadResults:
+        releaseDeadResults = (opt.Type() == kEnable);
+        break;
+      case kEscapeAnalysis:
+        escapeAnalysis = (opt.Type() == kEnable);
+        break;
       default:
         WARN(kLncWarn, "input invalid key for me " + opt.OptionKey());
         break;
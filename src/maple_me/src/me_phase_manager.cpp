@@ -13,6 +13,8 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "me_phase_manager.h"
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -25,10 +27,13 @@
 #include "me_profile_gen.h"
 #include "me_profile_use.h"
 #include "me_loop_canon.h"
+#include "me_loop_versioning.h"
 #include "me_abco.h"
 #include "me_dse.h"
 #include "me_hdse.h"
 #include "me_prop.h"
+#include "me_sccp.h"
+#include "me_ivopts.h"
 #include "me_rename2preg.h"
 #include "me_ssa_lpre.h"
 #include "me_ssa_epre.h"
@@ -40,6 +45,7 @@
 #include "me_ssa_devirtual.h"
 #include "me_delegate_rc.h"
 #include "me_analyze_rc.h"
+#include "me_escape_analysis.h"
 #include "me_may2dassign.h"
 #include "me_loop_analysis.h"
 #include "me_ssa.h"
@@ -50,10 +56,114 @@
 #include "gen_check_cast.h"
 #include "me_ssa_tab.h"
 #include "mpl_timer.h"
+#include "trace_event.h"
 
 #define JAVALANG (mirModule.IsJavaModule())
 
 namespace maple {
+namespace {
+// Phases that may ask for the result of an analysis, the analysis itself included. Keep it in sync with
+// the GetAnalysisResult calls of the phases: a result released too early is recomputed when asked for,
+// and alias classification, for one, must not run twice. A consumer missing here is found the first
+// time it makes a released result be recomputed and kept as one from then on. Results not listed here
+// are kept until the function is done, the SSATab and the IRMap being held by MeFunction and the
+// dominance by the IRMap.
+const std::map<MePhaseID, std::vector<MePhaseID>> &GetResultConsumers() {
+  static const std::map<MePhaseID, std::vector<MePhaseID>> resultConsumers = {
+    { MeFuncPhase_SSA, { MeFuncPhase_SSA } },
+    { MeFuncPhase_ALIASCLASS, { MeFuncPhase_ALIASCLASS, MeFuncPhase_STOREPRE, MeFuncPhase_ANALYZERC,
+                                MeFuncPhase_SSARENAME2PREG } },
+    { MeFuncPhase_MELOOP, { MeFuncPhase_MELOOP, MeFuncPhase_LOOPCANON, MeFuncPhase_LOOPVERSIONING, MeFuncPhase_IVOPTS,
+                            MeFuncPhase_SSALPRE } },
+    { MeFuncPhase_BBLAYOUT, { MeFuncPhase_BBLAYOUT, MeFuncPhase_EMIT } },
+    { MeFuncPhase_MEABCOPT, { MeFuncPhase_MEABCOPT } },
+    { MeFuncPhase_CONDBASEDNPC, { MeFuncPhase_CONDBASEDNPC } },
+    { MeFuncPhase_CONDBASEDRC, { MeFuncPhase_CONDBASEDRC, MeFuncPhase_ANALYZERC } },
+    { MeFuncPhase_DELEGATERC, { MeFuncPhase_DELEGATERC, MeFuncPhase_ANALYZERC } },
+    { MeFuncPhase_ESCAPEANALYSIS, { MeFuncPhase_ESCAPEANALYSIS, MeFuncPhase_RCLOWERING } },
+  };
+  return resultConsumers;
+}
+}  // namespace
+
+void MeFuncPhaseManager::ComputeResultLastUses() {
+  resultLastUses.clear();
+  size_t phaseIndex = 0;
+  for (auto it = PhaseSequenceBegin(); it != PhaseSequenceEnd(); ++it, ++phaseIndex) {
+    auto id = static_cast<MePhaseID>(GetPhaseId(it));
+    for (const auto &resultConsumer : GetResultConsumers()) {
+      const std::vector<MePhaseID> &consumers = resultConsumer.second;
+      if (std::find(consumers.begin(), consumers.end(), id) != consumers.end()) {
+        resultLastUses[resultConsumer.first] = phaseIndex;
+      }
+    }
+    for (const auto &foundConsumer : foundConsumers) {
+      if (foundConsumer.second.find(id) != foundConsumer.second.end()) {
+        resultLastUses[foundConsumer.first] = std::max(resultLastUses[foundConsumer.first], phaseIndex);
+      }
+    }
+  }
+  resultLastUsesSeqSize = GetPhaseSequence()->size();
+}
+
+// free the results no phase after phaseIndex asks for, so that their mempools do not pile up
+void MeFuncPhaseManager::ReleaseDeadResults(MeFunction &func, size_t phaseIndex) {
+  for (const auto &lastUse : resultLastUses) {
+    if (lastUse.second > phaseIndex) {
+      continue;
+    }
+    AnalysisResult *result = arFuncManager.FindAnalysisResult(lastUse.first, &func);
+    if (result == nullptr) {
+      continue;
+    }
+    if (MeOption::memPoolStat) {
+      memPoolStat.releasedBytes += result->GetMempool()->GetAllocatedSize();
+    }
+    arFuncManager.InvalidAnalysisResult(lastUse.first, &func);
+    (void)releasedResults.insert(lastUse.first);
+  }
+}
+
+// a released result kept again after phase has run was recomputed for it, so phase is one more consumer
+void MeFuncPhaseManager::CheckRecomputedResults(MeFunction &func, const MeFuncPhase &phase, size_t phaseIndex) {
+  for (auto it = releasedResults.begin(); it != releasedResults.end();) {
+    if (arFuncManager.FindAnalysisResult(*it, &func) == nullptr) {
+      ++it;
+      continue;
+    }
+    if (MeOption::memPoolStat) {
+      MeFuncPhase *analysis = arFuncManager.GetAnalysisPhase(*it);
+      LogInfo::MapleLogger() << "[mempool] " << phase.PhaseName() << " recomputed the released "
+                             << (analysis == nullptr ? "" : analysis->PhaseName()) << " result of "
+                             << func.GetName() << '\n';
+    }
+    (void)foundConsumers[*it].insert(phase.GetPhaseId());
+    resultLastUses[*it] = std::max(resultLastUses[*it], phaseIndex);
+    it = releasedResults.erase(it);
+  }
+}
+
+// called when phase has run but before its mempools are released, which is when the function peaks
+void MeFuncPhaseManager::RecordMemPoolStat(MeFunction &func, const MeFuncPhase &phase) {
+  size_t phaseBytes = phase.GetMemPoolSize();
+  size_t resultBytes = arFuncManager.GetResultMemPoolSize(&func);
+  size_t funcBytes = func.GetMemPool()->GetAllocatedSize() + func.GetVersMp()->GetAllocatedSize();
+  LogInfo::MapleLogger() << "[mempool] " << std::left << std::setw(16) << phase.PhaseName() << std::right
+                         << " phase used/reserved " << phaseBytes << "/" << phase.GetMemPoolReservedSize()
+                         << " results used " << resultBytes << " function used " << funcBytes << '\n';
+  size_t liveBytes = phaseBytes + resultBytes + funcBytes;
+  if (liveBytes > memPoolStat.peakBytes) {
+    memPoolStat.peakBytes = liveBytes;
+    memPoolStat.peakPhase = phase.PhaseName();
+  }
+}
+
+void MeFuncPhaseManager::DumpMemPoolStat(const MeFunction &func) const {
+  LogInfo::MapleLogger() << "[mempool] " << func.GetName() << ": peak " << memPoolStat.peakBytes << " bytes in "
+                         << memPoolStat.peakPhase << ", " << memPoolStat.releasedBytes
+                         << " bytes of results released early\n";
+}
+
 void MeFuncPhaseManager::RunFuncPhase(MeFunction *func, MeFuncPhase *phase) {
   // 1. check options.enable(phase.id())
   // 2. options.tracebeforePhase(phase.id()) dumpIR before
@@ -65,7 +175,14 @@ void MeFuncPhaseManager::RunFuncPhase(MeFunction *func, MeFuncPhase *phase) {
   AnalysisResult *analysisRes = nullptr;
   MePhaseID phaseID = phase->GetPhaseId();
   if ((func->NumBBs() > 0) || (phaseID == MeFuncPhase_EMIT)) {
+    TraceScope traceScope("me", phase->PhaseName(), func->GetName());
     analysisRes = phase->Run(func, &arFuncManager, modResMgr);
+    if (TraceEventRecorder::IsEnabled()) {
+      traceScope.SetMemPoolBytes(phase->GetMemPoolSize());
+    }
+    if (MeOption::memPoolStat) {
+      RecordMemPoolStat(*func, *phase);
+    }
     phase->ReleaseMemPool(analysisRes == nullptr ? nullptr : analysisRes->GetMempool());
     phase->ClearString();
   }
@@ -149,6 +266,13 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
   }
   std::string phaseName = "";
   MeFuncPhase *changeCFGPhase = nullptr;
+  // results outlive the function in ipa, they are released in IPACleanUp
+  bool releaseDeadResults = MeOption::releaseDeadResults && !ipa;
+  if (releaseDeadResults && resultLastUsesSeqSize != GetPhaseSequence()->size()) {
+    ComputeResultLastUses();
+  }
+  memPoolStat = MemPoolStat();
+  releasedResults.clear();
   // each function level phase
   bool dumpFunc = FuncFilter(MeOption::dumpFunc, func.GetName());
   size_t phaseIndex = 0;
@@ -177,6 +301,10 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
       p->ClearChangeCFG();
       break;
     }
+    if (releaseDeadResults) {
+      CheckRecomputedResults(func, *p, phaseIndex);
+      ReleaseDeadResults(func, phaseIndex);
+    }
   }
   if (!ipa) {
     GetAnalysisResultManager()->InvalidAllResults();
@@ -186,11 +314,13 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
       CHECK_FATAL(false, "phases in ipa will not chang cfg.");
     }
     // do all the phases start over
+    releasedResults.clear();
     MemPool *versMemPool = memPoolCtrler.NewMemPool("second verst mempool");
     MeFunction function(&mirModule, mirFunc, funcMP, versMemPool, meInput);
     function.PartialInit(true);
     function.Prepare(rangeNum);
-    for (auto it = PhaseSequenceBegin(); it != PhaseSequenceEnd(); ++it) {
+    phaseIndex = 0;
+    for (auto it = PhaseSequenceBegin(); it != PhaseSequenceEnd(); ++it, ++phaseIndex) {
       PhaseID id = GetPhaseId(it);
       auto *p = static_cast<MeFuncPhase*>(GetPhase(id));
       if (p == changeCFGPhase) {
@@ -207,9 +337,16 @@ void MeFuncPhaseManager::Run(MIRFunction *mirFunc, uint64 rangeNum, const std::s
         }
         LogInfo::MapleLogger() << ">>>>> Second time Dump after End <<<<<\n\n";
       }
+      if (releaseDeadResults) {
+        CheckRecomputedResults(function, *p, phaseIndex);
+        ReleaseDeadResults(function, phaseIndex);
+      }
     }
     GetAnalysisResultManager()->InvalidAllResults();
   }
+  if (MeOption::memPoolStat) {
+    DumpMemPoolStat(func);
+  }
   if (!ipa) {
     memPoolCtrler.DeleteMemPool(funcMP);
   }
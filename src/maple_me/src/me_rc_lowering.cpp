@@ -598,7 +598,9 @@ void RCLowering::InitializedObjectFields(MeStmt &stmt) {
     }
   } else {
     for (auto iter : call.GetOpnds()) {
-      gcMallocObjects.erase(iter);
+      if (escapeAnalysis == nullptr || !escapeAnalysis->IsObjectUntouchedByCall(call, *iter)) {
+        gcMallocObjects.erase(iter);
+      }
     }
   }
 }
@@ -1015,6 +1017,10 @@ AnalysisResult *MeDoRCLowering::Run(MeFunction *func, MeFuncResultMgr *funcResMg
   }
   CHECK_FATAL(func->GetMeSSATab() != nullptr, "ssatab has problem");
   RCLowering rcLowering(*func, DEBUGFUNC(func));
+  if (MeOption::escapeAnalysis) {
+    rcLowering.SetEscapeAnalysis(
+        static_cast<EscapeAnalysis*>(funcResMgr->GetAnalysisResult(MeFuncPhase_ESCAPEANALYSIS, func)));
+  }
 
   rcLowering.Prepare();
   rcLowering.PreRCLower();
@@ -1022,6 +1028,7 @@ AnalysisResult *MeDoRCLowering::Run(MeFunction *func, MeFuncResultMgr *funcResMg
   // handle all the extra RC work
   rcLowering.PostRCLower();
   rcLowering.Finish();
+  funcResMgr->InvalidAnalysisResult(MeFuncPhase_ESCAPEANALYSIS, func);
   return nullptr;
 }
 }  // namespace maple
@@ -0,0 +1,590 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "me_sccp.h"
+#include "me_cfg.h"
+#include "me_option.h"
+
+// This phase propagates constants through the SSA graph while finding out which blocks can be
+// executed at all. Two worklists drive it: newly executable cfg edges, whose target block gets
+// its phis re-evaluated and, the first time, its statements visited; and SSA versions whose lattice
+// value went down, whose uses in executable blocks are visited again. Lattice values only go down
+// from top to a constant to bottom, so the propagation terminates.
+namespace maple {
+MeSCCP::LatticeValue MeSCCP::Meet(const LatticeValue &a, const LatticeValue &b) {
+  if (a.kind == kLatticeTop) {
+    return b;
+  }
+  if (b.kind == kLatticeTop) {
+    return a;
+  }
+  if (a.kind == kLatticeBottom || b.kind == kLatticeBottom || a.value != b.value) {
+    return Bottom();
+  }
+  return a;
+}
+
+void MeSCCP::CollectUses(MeExpr &expr, MeStmt &stmt) {
+  if (expr.GetMeOp() == kMeOpVar || expr.GetMeOp() == kMeOpReg) {
+    stmtUses[expr.GetExprID()].push_back(&stmt);
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectUses(*opnd, stmt);
+    }
+  }
+}
+
+void MeSCCP::BuildUses() {
+  size_t exprNum = static_cast<size_t>(irMap.GetExprID());
+  values.assign(exprNum, LatticeValue());
+  stmtUses.assign(exprNum, std::vector<MeStmt*>());
+  phiUses.assign(exprNum, std::vector<PhiUse>());
+  executableBBs.assign(func.GetAllBBs().size(), false);
+  for (BB *bb : func.GetAllBBs()) {
+    if (bb == nullptr) {
+      continue;
+    }
+    for (auto &varPhi : bb->GetMevarPhiList()) {
+      for (VarMeExpr *opnd : varPhi.second->GetOpnds()) {
+        if (opnd != nullptr) {
+          phiUses[opnd->GetExprID()].push_back(PhiUse{ bb, varPhi.second, nullptr });
+        }
+      }
+    }
+    for (auto &regPhi : bb->GetMeRegPhiList()) {
+      for (RegMeExpr *opnd : regPhi.second->GetOpnds()) {
+        if (opnd != nullptr) {
+          phiUses[opnd->GetExprID()].push_back(PhiUse{ bb, nullptr, regPhi.second });
+        }
+      }
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+        MeExpr *opnd = stmt.GetOpnd(i);
+        if (opnd != nullptr) {
+          CollectUses(*opnd, stmt);
+        }
+      }
+    }
+  }
+}
+
+MeSCCP::LatticeValue &MeSCCP::GetValue(const MeExpr &expr) {
+  static LatticeValue bottom = Bottom();
+  auto id = static_cast<size_t>(expr.GetExprID());
+  // exprs created while rewriting are not tracked
+  return id < values.size() ? values[id] : bottom;
+}
+
+void MeSCCP::SetValue(MeExpr &expr, const LatticeValue &value) {
+  auto id = static_cast<size_t>(expr.GetExprID());
+  if (id >= values.size()) {
+    return;
+  }
+  LatticeValue merged = Meet(values[id], value);
+  if (merged != values[id]) {
+    values[id] = merged;
+    ssaWorkList.push_back(&expr);
+  }
+}
+
+// the value of a var or reg version, as far as its definition has been visited
+MeSCCP::LatticeValue MeSCCP::EvaluateDef(MeExpr &expr) {
+  if (!IsTrackedType(expr.GetPrimType())) {
+    return Bottom();
+  }
+  if (expr.GetMeOp() == kMeOpVar) {
+    auto &var = static_cast<VarMeExpr&>(expr);
+    if ((var.GetDefBy() == kDefByStmt && var.GetDefStmt()->GetOp() == OP_dassign) || var.GetDefBy() == kDefByPhi) {
+      return GetValue(expr);
+    }
+    return Bottom();
+  }
+  auto &reg = static_cast<RegMeExpr&>(expr);
+  if (!reg.IsNormalReg()) {
+    return Bottom();
+  }
+  if ((reg.GetDefBy() == kDefByStmt && reg.GetDefStmt()->GetOp() == OP_regassign) || reg.GetDefBy() == kDefByPhi) {
+    return GetValue(expr);
+  }
+  return Bottom();
+}
+
+// evaluate an operation whose operands are all constants with the tree-level folder
+MeSCCP::LatticeValue MeSCCP::FoldOp(OpMeExpr &expr, const std::vector<LatticeValue> &opnds) {
+  std::vector<ConstvalNode> constNodes;
+  constNodes.reserve(opnds.size());
+  for (size_t i = 0; i < opnds.size(); ++i) {
+    PrimType opndType = expr.GetOpnd(i)->GetPrimType();
+    MIRIntConst *intConst = GlobalTables::GetIntConstTable().GetOrCreateIntConst(
+        opnds[i].value, *GlobalTables::GetTypeTable().GetPrimType(opndType));
+    constNodes.emplace_back(opndType, intConst);
+  }
+  Opcode op = expr.GetOp();
+  PrimType primType = expr.GetPrimType();
+  BaseNode *folded = nullptr;
+  switch (op) {
+    case OP_abs:
+    case OP_bnot:
+    case OP_lnot:
+    case OP_neg: {
+      UnaryNode node(op, primType, &constNodes[0]);
+      folded = constantFold.Fold(&node);
+      break;
+    }
+    case OP_ceil:
+    case OP_floor:
+    case OP_round:
+    case OP_trunc:
+    case OP_cvt: {
+      TypeCvtNode node(op, primType, expr.GetOpndType(), &constNodes[0]);
+      folded = constantFold.Fold(&node);
+      break;
+    }
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits: {
+      ExtractbitsNode node(op, primType, expr.GetBitsOffSet(), expr.GetBitsSize(), &constNodes[0]);
+      folded = constantFold.Fold(&node);
+      break;
+    }
+    case OP_eq:
+    case OP_ne:
+    case OP_ge:
+    case OP_gt:
+    case OP_le:
+    case OP_lt:
+    case OP_cmp: {
+      CompareNode node(op, primType, expr.GetOpndType(), &constNodes[0], &constNodes[1]);
+      folded = constantFold.Fold(&node);
+      break;
+    }
+    default: {
+      BinaryNode node(op, primType, &constNodes[0], &constNodes[1]);
+      folded = constantFold.Fold(&node);
+      break;
+    }
+  }
+  if (folded == nullptr || folded->GetOpCode() != OP_constval) {
+    return Bottom();  // e.g. a division by zero, left to throw at run time
+  }
+  MIRConst *constVal = static_cast<ConstvalNode*>(folded)->GetConstVal();
+  if (constVal == nullptr || constVal->GetKind() != kConstInt) {
+    return Bottom();
+  }
+  return Const(static_cast<MIRIntConst*>(constVal)->GetValue());
+}
+
+MeSCCP::LatticeValue MeSCCP::EvaluateOp(OpMeExpr &expr) {
+  if (!IsTrackedType(expr.GetPrimType())) {
+    return Bottom();
+  }
+  switch (expr.GetOp()) {
+    case OP_select: {
+      LatticeValue cond = Evaluate(*expr.GetOpnd(0));
+      if (cond.kind == kLatticeConst) {
+        return Evaluate(*expr.GetOpnd(cond.value != 0 ? 1 : 2));
+      }
+      if (cond.kind == kLatticeTop) {
+        return cond;
+      }
+      return Meet(Evaluate(*expr.GetOpnd(1)), Evaluate(*expr.GetOpnd(2)));
+    }
+    case OP_abs:
+    case OP_bnot:
+    case OP_lnot:
+    case OP_neg:
+    case OP_ceil:
+    case OP_floor:
+    case OP_round:
+    case OP_trunc:
+    case OP_cvt:
+    case OP_sext:
+    case OP_zext:
+    case OP_extractbits:
+    case OP_add:
+    case OP_sub:
+    case OP_mul:
+    case OP_div:
+    case OP_rem:
+    case OP_ashr:
+    case OP_lshr:
+    case OP_shl:
+    case OP_max:
+    case OP_min:
+    case OP_band:
+    case OP_bior:
+    case OP_bxor:
+    case OP_land:
+    case OP_lior:
+    case OP_cand:
+    case OP_cior:
+    case OP_eq:
+    case OP_ne:
+    case OP_ge:
+    case OP_gt:
+    case OP_le:
+    case OP_lt:
+    case OP_cmp:
+      break;
+    default:
+      return Bottom();
+  }
+  std::vector<LatticeValue> opnds;
+  bool hasTop = false;
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    LatticeValue opnd = Evaluate(*expr.GetOpnd(i));
+    if (opnd.kind == kLatticeBottom) {
+      return opnd;
+    }
+    hasTop = hasTop || opnd.kind == kLatticeTop;
+    opnds.push_back(opnd);
+  }
+  if (hasTop) {
+    return LatticeValue();
+  }
+  return FoldOp(expr, opnds);
+}
+
+MeSCCP::LatticeValue MeSCCP::Evaluate(MeExpr &expr) {
+  switch (expr.GetMeOp()) {
+    case kMeOpConst: {
+      MIRConst *constVal = static_cast<ConstMeExpr&>(expr).GetConstVal();
+      if (!IsTrackedType(expr.GetPrimType()) || constVal->GetKind() != kConstInt) {
+        return Bottom();
+      }
+      return Const(static_cast<MIRIntConst*>(constVal)->GetValue());
+    }
+    case kMeOpVar:
+    case kMeOpReg:
+      return EvaluateDef(expr);
+    case kMeOpOp:
+      return EvaluateOp(static_cast<OpMeExpr&>(expr));
+    default:
+      return Bottom();
+  }
+}
+
+void MeSCCP::AddEdge(BB &pred, BB &succ) {
+  if (!IsEdgeExecutable(pred, succ)) {
+    cfgWorkList.push_back(std::make_pair(&pred, &succ));
+  }
+}
+
+bool MeSCCP::IsEdgeExecutable(const BB &pred, const BB &succ) const {
+  return executableEdges.find(std::make_pair(pred.GetBBId(), succ.GetBBId())) != executableEdges.end();
+}
+
+BB *MeSCCP::GetSwitchTarget(SwitchMeStmt &switchStmt, int64 value) {
+  LabelIdx label = switchStmt.GetDefaultLabel();
+  for (auto &casePair : switchStmt.GetSwitchTable()) {
+    if (casePair.first == value) {
+      label = casePair.second;
+      break;
+    }
+  }
+  return func.GetLabelBBAt(label);
+}
+
+void MeSCCP::VisitVarPhi(const BB &bb, MeVarPhiNode &phi) {
+  LatticeValue result;
+  if (!IsTrackedType(phi.GetLHS()->GetPrimType())) {
+    result = Bottom();
+  }
+  for (size_t i = 0; i < phi.GetOpnds().size() && result.kind != kLatticeBottom; ++i) {
+    if (!IsEdgeExecutable(*bb.GetPred(i), bb)) {
+      continue;
+    }
+    VarMeExpr *opnd = phi.GetOpnd(i);
+    result = Meet(result, opnd == nullptr ? Bottom() : Evaluate(*opnd));
+  }
+  SetValue(*phi.GetLHS(), result);
+}
+
+void MeSCCP::VisitRegPhi(const BB &bb, MeRegPhiNode &phi) {
+  LatticeValue result;
+  if (!IsTrackedType(phi.GetLHS()->GetPrimType())) {
+    result = Bottom();
+  }
+  for (size_t i = 0; i < phi.GetOpnds().size() && result.kind != kLatticeBottom; ++i) {
+    if (!IsEdgeExecutable(*bb.GetPred(i), bb)) {
+      continue;
+    }
+    RegMeExpr *opnd = phi.GetOpnd(i);
+    result = Meet(result, opnd == nullptr ? Bottom() : Evaluate(*opnd));
+  }
+  SetValue(*phi.GetLHS(), result);
+}
+
+void MeSCCP::VisitPhis(BB &bb) {
+  for (auto &varPhi : bb.GetMevarPhiList()) {
+    VisitVarPhi(bb, *varPhi.second);
+  }
+  for (auto &regPhi : bb.GetMeRegPhiList()) {
+    VisitRegPhi(bb, *regPhi.second);
+  }
+}
+
+void MeSCCP::VisitStmt(MeStmt &stmt) {
+  BB &bb = *stmt.GetBB();
+  switch (stmt.GetOp()) {
+    case OP_dassign: {
+      auto &dassign = static_cast<DassignMeStmt&>(stmt);
+      VarMeExpr *lhs = dassign.GetVarLHS();
+      MeExpr *rhs = dassign.GetRHS();
+      bool tracked = IsTrackedType(lhs->GetPrimType()) && rhs->GetPrimType() == lhs->GetPrimType() &&
+                     !lhs->IsVolatile(irMap.GetSSATab());
+      SetValue(*lhs, tracked ? Evaluate(*rhs) : Bottom());
+      break;
+    }
+    case OP_regassign: {
+      auto &regassign = static_cast<RegassignMeStmt&>(stmt);
+      RegMeExpr *lhs = regassign.GetRegLHS();
+      MeExpr *rhs = regassign.GetRHS();
+      bool tracked = IsTrackedType(lhs->GetPrimType()) && rhs->GetPrimType() == lhs->GetPrimType();
+      SetValue(*lhs, tracked ? Evaluate(*rhs) : Bottom());
+      break;
+    }
+    case OP_brtrue:
+    case OP_brfalse: {
+      if (bb.GetAttributes(kBBAttrIsTry) || bb.GetSucc().size() != 2) {
+        break;  // all successors made executable by VisitBB
+      }
+      LatticeValue cond = Evaluate(*static_cast<CondGotoMeStmt&>(stmt).GetOpnd());
+      if (cond.kind == kLatticeConst) {
+        bool taken = (cond.value != 0) == (stmt.GetOp() == OP_brtrue);
+        AddEdge(bb, *bb.GetSucc(taken ? 1 : 0));
+      } else if (cond.kind == kLatticeBottom) {
+        AddEdge(bb, *bb.GetSucc(0));
+        AddEdge(bb, *bb.GetSucc(1));
+      }
+      break;
+    }
+    case OP_switch: {
+      if (bb.GetAttributes(kBBAttrIsTry)) {
+        break;
+      }
+      auto &switchStmt = static_cast<SwitchMeStmt&>(stmt);
+      LatticeValue cond = Evaluate(*switchStmt.GetOpnd());
+      if (cond.kind == kLatticeTop) {
+        break;
+      }
+      BB *target = nullptr;
+      if (cond.kind == kLatticeConst && IsSignedInteger(switchStmt.GetOpnd()->GetPrimType())) {
+        target = GetSwitchTarget(switchStmt, cond.value);
+      }
+      if (target != nullptr) {
+        AddEdge(bb, *target);
+      } else {
+        for (BB *succ : bb.GetSucc()) {
+          AddEdge(bb, *succ);
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void MeSCCP::VisitBB(BB &bb) {
+  for (auto &stmt : bb.GetMeStmts()) {
+    VisitStmt(stmt);
+  }
+  MeStmt *lastStmt = bb.GetLastMe();
+  bool branchDecides = !bb.GetAttributes(kBBAttrIsTry) && lastStmt != nullptr &&
+                       ((lastStmt->IsCondBr() && bb.GetSucc().size() == 2) || lastStmt->GetOp() == OP_switch);
+  if (!branchDecides) {
+    for (BB *succ : bb.GetSucc()) {
+      AddEdge(bb, *succ);
+    }
+  }
+}
+
+void MeSCCP::Propagate() {
+  BB *commonEntry = func.GetCommonEntryBB();
+  for (BB *entry : commonEntry->GetSucc()) {
+    AddEdge(*commonEntry, *entry);
+  }
+  while (!cfgWorkList.empty() || !ssaWorkList.empty()) {
+    if (!cfgWorkList.empty()) {
+      std::pair<BB*, BB*> edge = cfgWorkList.back();
+      cfgWorkList.pop_back();
+      BB &bb = *edge.second;
+      if (!executableEdges.insert(std::make_pair(edge.first->GetBBId(), bb.GetBBId())).second) {
+        continue;
+      }
+      VisitPhis(bb);
+      if (!executableBBs[bb.GetBBId()]) {
+        executableBBs[bb.GetBBId()] = true;
+        VisitBB(bb);
+      }
+      continue;
+    }
+    MeExpr *def = ssaWorkList.back();
+    ssaWorkList.pop_back();
+    for (PhiUse &use : phiUses[def->GetExprID()]) {
+      if (!executableBBs[use.bb->GetBBId()]) {
+        continue;
+      }
+      if (use.varPhi != nullptr) {
+        VisitVarPhi(*use.bb, *use.varPhi);
+      } else {
+        VisitRegPhi(*use.bb, *use.regPhi);
+      }
+    }
+    for (MeStmt *use : stmtUses[def->GetExprID()]) {
+      if (executableBBs[use->GetBB()->GetBBId()]) {
+        VisitStmt(*use);
+      }
+    }
+  }
+}
+
+// make branch an unconditional transfer to target, dropping the other edges of bb
+void MeSCCP::ReplaceBranch(BB &bb, MeStmt &branch, BB &target) {
+  bool toFallthru = branch.IsCondBr() && &target == bb.GetSucc(0);
+  for (size_t i = bb.GetSucc().size(); i > 0; --i) {
+    BB *succ = bb.GetSucc(i - 1);
+    if (succ != &target) {
+      succ->RemovePred(bb);
+    }
+  }
+  if (toFallthru) {
+    bb.RemoveMeStmt(&branch);
+    bb.SetKind(kBBFallthru);
+  } else {
+    GotoNode gotoNode(OP_goto);
+    auto *gotoStmt = irMap.New<GotoMeStmt>(&gotoNode);
+    gotoStmt->SetOffset(func.GetOrCreateBBLabel(target));
+    gotoStmt->SetSrcPos(branch.GetSrcPosition());
+    bb.ReplaceMeStmt(&branch, gotoStmt);
+    bb.SetKind(kBBGoto);
+  }
+  ++foldedBranches;
+}
+
+void MeSCCP::FoldBranch(BB &bb, MeStmt &branch) {
+  if (bb.GetAttributes(kBBAttrIsTry)) {
+    return;
+  }
+  if (branch.IsCondBr()) {
+    if (bb.GetSucc().size() != 2) {
+      return;
+    }
+    LatticeValue cond = Evaluate(*static_cast<CondGotoMeStmt&>(branch).GetOpnd());
+    if (cond.kind == kLatticeConst) {
+      bool taken = (cond.value != 0) == (branch.GetOp() == OP_brtrue);
+      ReplaceBranch(bb, branch, *bb.GetSucc(taken ? 1 : 0));
+    }
+  } else if (branch.GetOp() == OP_switch) {
+    auto &switchStmt = static_cast<SwitchMeStmt&>(branch);
+    LatticeValue cond = Evaluate(*switchStmt.GetOpnd());
+    if (cond.kind != kLatticeConst || !IsSignedInteger(switchStmt.GetOpnd()->GetPrimType())) {
+      return;
+    }
+    BB *target = GetSwitchTarget(switchStmt, cond.value);
+    if (target != nullptr) {
+      ReplaceBranch(bb, branch, *target);
+    }
+  }
+}
+
+// the largest subexprs known to be constant
+void MeSCCP::CollectConstExprs(MeExpr &expr, std::vector<MeExpr*> &constExprs) {
+  MeExprOp meOp = expr.GetMeOp();
+  if (meOp == kMeOpConst) {
+    return;
+  }
+  if ((meOp == kMeOpVar || meOp == kMeOpReg || meOp == kMeOpOp) && Evaluate(expr).kind == kLatticeConst) {
+    constExprs.push_back(&expr);
+    return;
+  }
+  if (meOp != kMeOpOp && meOp != kMeOpNary && meOp != kMeOpIvar) {
+    return;
+  }
+  for (size_t i = 0; i < expr.GetNumOpnds(); ++i) {
+    MeExpr *opnd = expr.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectConstExprs(*opnd, constExprs);
+    }
+  }
+}
+
+void MeSCCP::ReplaceConstUses(MeStmt &stmt) {
+  std::vector<MeExpr*> constExprs;
+  for (size_t i = 0; i < stmt.NumMeStmtOpnds(); ++i) {
+    MeExpr *opnd = stmt.GetOpnd(i);
+    if (opnd != nullptr) {
+      CollectConstExprs(*opnd, constExprs);
+    }
+  }
+  for (MeExpr *constExpr : constExprs) {
+    LatticeValue value = Evaluate(*constExpr);
+    MeExpr *replacement = irMap.CreateIntConstMeExpr(value.value, constExpr->GetPrimType());
+    if (irMap.ReplaceMeExprStmt(stmt, *constExpr, *replacement)) {
+      ++replacedUses;
+    }
+  }
+}
+
+bool MeSCCP::Rewrite() {
+  size_t bbNum = func.GetAllBBs().size();
+  for (size_t i = 0; i < bbNum; ++i) {
+    BB *bb = func.GetAllBBs().at(i);
+    if (bb == nullptr || !executableBBs[i]) {
+      continue;
+    }
+    for (auto &stmt : bb->GetMeStmts()) {
+      ReplaceConstUses(stmt);
+    }
+    MeStmt *lastStmt = bb->GetLastMe();
+    if (lastStmt != nullptr) {
+      FoldBranch(*bb, *lastStmt);
+    }
+  }
+  return foldedBranches != 0;
+}
+
+bool MeSCCP::Run() {
+  BuildUses();
+  Propagate();
+  bool cfgChanged = Rewrite();
+  if (cfgChanged) {
+    func.GetTheCfg()->UnreachCodeAnalysis(true);
+  }
+  if (enabledDebug) {
+    LogInfo::MapleLogger() << "sccp: " << replacedUses << " uses replaced by constants, " << foldedBranches
+                           << " branches folded\n";
+  }
+  return cfgChanged;
+}
+
+AnalysisResult *MeDoSCCP::Run(MeFunction *func, MeFuncResultMgr *m, ModuleResultMgr*) {
+  auto *irMap = static_cast<MeIRMap*>(m->GetAnalysisResult(MeFuncPhase_IRMAP, func));
+  CHECK_NULL_FATAL(irMap);
+  MeSCCP sccp(*func, *irMap, DEBUGFUNC(func));
+  if (sccp.Run()) {
+    m->InvalidAnalysisResult(MeFuncPhase_DOMINANCE, func);
+  }
+  if (DEBUGFUNC(func)) {
+    LogInfo::MapleLogger() << "\n============== After SCCP =============" << '\n';
+    func->Dump(false);
+  }
+  return nullptr;
+}
+}  // namespace maple
@@ -23,8 +23,39 @@
 // should NOT trust the isLive flag in phi nodes.
 // accumulate the BBs that are in the iterated dominance frontiers of bb in
 // the set dfset, visiting each BB only once
-namespace maple {
+namespace {
+using namespace maple;
+
+bool IsClinitCheck(const MeStmt &stmt) {
+  if (stmt.GetOp() != OP_intrinsiccall && stmt.GetOp() != OP_intrinsiccallwithtype) {
+    return false;
+  }
+  MIRIntrinsicID intrinsic = static_cast<const IntrinsiccallMeStmt&>(stmt).GetIntrinsic();
+  return intrinsic == INTRN_JAVA_CLINIT_CHECK || intrinsic == INTRN_MPL_CLINIT_CHECK;
+}
+
+// An idempotent intrinsic call is redundant when an identical call is available, so it is handled
+// like the other statement candidates: the occurrences are unified, an insertion is made where it
+// is partially available and anticipated, e.g. in the preheader of a loop re-checking it on every
+// iteration, and the redundant ones are deleted. Its chi list only models the runtime call and
+// does not kill the candidate, which is only killed by redefining its operands.
+bool IsIdempotentCandidate(const IntrinsiccallMeStmt &intrnStmt) {
+  if (!IntrinDesc::intrinTable[intrnStmt.GetIntrinsic()].IsIdempotent()) {
+    return false;
+  }
+  if (IsClinitCheck(intrnStmt) && !MeOption::clinitPre) {
+    return false;
+  }
+  for (size_t i = 0; i < intrnStmt.NumMeStmtOpnds(); ++i) {
+    if (!intrnStmt.GetOpnd(i)->IsLeaf()) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
 
+namespace maple {
 void MeStmtPre::GetIterDomFrontier(const BB &bb, MapleSet<uint32> &dfSet, std::vector<bool> &visitedMap) const {
   CHECK_FATAL(bb.GetBBId() < visitedMap.size(), "index out of range in MeStmtPre::GetIterDomFrontier");
   if (visitedMap[bb.GetBBId()]) {
@@ -111,9 +142,7 @@ void MeStmtPre::CodeMotion() {
                 call->GetMustDefList()->front().UpdateLHS(*newVarVersion);
               }
             }
-            if (insertedOcc->GetOpcodeOfMeStmt() == OP_intrinsiccallwithtype &&
-                (static_cast<IntrinsiccallMeStmt*>(insertedOcc->GetMeStmt())->GetIntrinsic() ==
-                 INTRN_JAVA_CLINIT_CHECK)) {
+            if (IsClinitCheck(*insertedOcc->GetMeStmt())) {
               BB *insertBB = insertedOcc->GetBB();
               // insert at earlist point in BB, but after statements required
               // to be first statement in BB
@@ -954,31 +983,10 @@ void MeStmtPre::BuildWorkListBB(BB *bb) {
         VersionStackChiListUpdate(*dassMeStmt.GetChiList());
         break;
       }
+      case OP_intrinsiccall:
       case OP_intrinsiccallwithtype: {
         auto &intrnStmt = static_cast<IntrinsiccallMeStmt&>(stmt);
-        VersionStackChiListUpdate(*intrnStmt.GetChiList());
-        if (!MeOption::clinitPre) {
-          VersionStackChiListUpdate(*intrnStmt.GetChiList());
-          break;
-        }
-        if (intrnStmt.GetIntrinsic() == INTRN_JAVA_CLINIT_CHECK) {
-          (void)CreateStmtRealOcc(stmt, seqStmt);
-        }
-        break;
-      }
-      case OP_intrinsiccall: {
-        auto &intrnStmt = static_cast<IntrinsiccallMeStmt&>(stmt);
-        bool allOperandsAreLeaf = true;
-        for (size_t i = 0; i < intrnStmt.NumMeStmtOpnds(); ++i) {
-          if (!intrnStmt.GetOpnd(i)->IsLeaf()) {
-            allOperandsAreLeaf = false;
-            break;
-          }
-        }
-        if (!allOperandsAreLeaf) {
-          break;
-        }
-        if (intrnStmt.GetIntrinsic() == INTRN_MPL_BOUNDARY_CHECK) {
+        if (IsIdempotentCandidate(intrnStmt)) {
           (void)CreateStmtRealOcc(stmt, seqStmt);
         }
         VersionStackChiListUpdate(*intrnStmt.GetChiList());
@@ -21,6 +21,7 @@
 #include "maple_string.h"
 #include "mempool_allocator.h"
 #include "option.h"
+#include "trace_event.h"
 
 namespace maple {
 using PhaseID = int;
@@ -69,6 +70,23 @@ class Phase {
     return memPool;
   }
 
+  // bytes allocated from the mempools this phase still holds
+  size_t GetMemPoolSize() const {
+    size_t size = 0;
+    for (const MemPool *memPool : memPools) {
+      size += memPool->GetAllocatedSize();
+    }
+    return size;
+  }
+
+  size_t GetMemPoolReservedSize() const {
+    size_t size = 0;
+    for (const MemPool *memPool : memPools) {
+      size += memPool->GetReservedSize();
+    }
+    return size;
+  }
+
   // release all mempool use in this phase except exclusion
   void ReleaseMemPool(const MemPool *exclusion) {
     for (MemPool *memPool : memPools) {
@@ -102,26 +120,32 @@ class AnalysisResultManager {
 
   // analysis result use global mempool and allocator
   AnalysisResult *GetAnalysisResult(PhaseIDT id, UnitIR *ir) {
-    ASSERT(ir != nullptr, "ir is null in AnalysisResultManager::GetAnalysisResult");
-    std::pair<PhaseIDT, UnitIR*> key = std::make_pair(id, ir);
-    if (analysisResults.find(key) != analysisResults.end()) {
-      return analysisResults[key];
-    }
+    return RunAnalysis(id, ir, [this, ir](PhaseT &anaPhase) { return anaPhase.Run(ir, this); });
+  }
 
-    PhaseT *anaPhase = GetAnalysisPhase(id);
-    if (std::string(anaPhase->PhaseName()) == Options::skipPhase) {
-      return nullptr;
-    }
+  // for the analyses of a unit that use the results of the module as well
+  template <typename ModuleResultMgrT>
+  AnalysisResult *GetAnalysisResult(PhaseIDT id, UnitIR *ir, ModuleResultMgrT *moduleResMgr) {
+    return RunAnalysis(id, ir, [this, ir, moduleResMgr](PhaseT &anaPhase) {
+      return anaPhase.Run(ir, this, moduleResMgr);
+    });
+  }
 
-    AnalysisResult *result = anaPhase->Run(ir, this);
-    // allow invoke phases whose return value is nullptr using GetAnalysisResult
-    if (result == nullptr) {
-      anaPhase->ReleaseMemPool(nullptr);
-      return nullptr;
+  // the kept result of id for ir, never runs the analysis
+  AnalysisResult *FindAnalysisResult(PhaseIDT id, UnitIR *ir) const {
+    auto it = analysisResults.find(std::make_pair(id, ir));
+    return (it == analysisResults.end()) ? nullptr : it->second;
+  }
+
+  // bytes allocated from the mempools of all results kept for ir
+  size_t GetResultMemPoolSize(const UnitIR *ir) const {
+    size_t size = 0;
+    for (auto it = analysisResults.begin(); it != analysisResults.end(); ++it) {
+      if (it->first.second == ir) {
+        size += it->second->GetMempool()->GetAllocatedSize();
+      }
     }
-    anaPhase->ReleaseMemPool(result->GetMempool());
-    analysisResults[key] = result; // add r to analysisResults
-    return result;
+    return size;
   }
 
   void AddResult(PhaseIDT id, UnitIR &ir, AnalysisResult &ar) {
@@ -150,6 +174,15 @@ class AnalysisResultManager {
     }
   }
 
+  // for phases that keep the result of keptID up to date themselves
+  void InvalidIRbaseAnalysisResultExcept(UnitIR &ir, PhaseIDT keptID) {
+    for (auto it = analysisPhases.begin(); it != analysisPhases.end(); ++it) {
+      if (it->first != keptID) {
+        InvalidAnalysisResult(it->first, &ir);
+      }
+    }
+  }
+
   void InvalidAllResults() {
     for (auto it = analysisResults.begin(); it != analysisResults.end(); ++it) {
       AnalysisResult *r = it->second;
@@ -177,6 +210,34 @@ class AnalysisResultManager {
   }
 
  private:
+  template <typename RunT>
+  AnalysisResult *RunAnalysis(PhaseIDT id, UnitIR *ir, const RunT &run) {
+    ASSERT(ir != nullptr, "ir is null in AnalysisResultManager::GetAnalysisResult");
+    std::pair<PhaseIDT, UnitIR*> key = std::make_pair(id, ir);
+    if (analysisResults.find(key) != analysisResults.end()) {
+      return analysisResults[key];
+    }
+
+    PhaseT *anaPhase = GetAnalysisPhase(id);
+    if (std::string(anaPhase->PhaseName()) == Options::skipPhase) {
+      return nullptr;
+    }
+
+    TraceScope traceScope("analysis", anaPhase->PhaseName());
+    AnalysisResult *result = run(*anaPhase);
+    if (TraceEventRecorder::IsEnabled()) {
+      traceScope.SetMemPoolBytes(anaPhase->GetMemPoolSize());
+    }
+    // allow invoke phases whose return value is nullptr using GetAnalysisResult
+    if (result == nullptr) {
+      anaPhase->ReleaseMemPool(nullptr);
+      return nullptr;
+    }
+    anaPhase->ReleaseMemPool(result->GetMempool());
+    analysisResults[key] = result; // add r to analysisResults
+    return result;
+  }
+
   MapleAllocator *allocator; // allocator used in local field
   using analysisResultKey = std::pair<PhaseIDT, UnitIR*>;
   MapleMap<analysisResultKey, AnalysisResult*> analysisResults;
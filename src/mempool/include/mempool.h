@@ -101,6 +101,28 @@ class MemPool {
     return name;
   }
 
+  // Bytes handed out by this pool so far, used by compile-time tracing and statistics only
+  size_t GetAllocatedSize() const {
+    size_t size = 0;
+    for (const auto *blocks : { &memBlockStack, &largeMemBlockStack }) {
+      for (const MemPoolCtrler::MemBlock *block : BlocksOf(*blocks)) {
+        size += block->origSize - block->available;
+      }
+    }
+    return size;
+  }
+
+  // Bytes of the blocks this pool holds, used or not
+  size_t GetReservedSize() const {
+    size_t size = 0;
+    for (const auto *blocks : { &memBlockStack, &largeMemBlockStack }) {
+      for (const MemPoolCtrler::MemBlock *block : BlocksOf(*blocks)) {
+        size += block->origSize;
+      }
+    }
+    return size;
+  }
+
   template <class T>
   T *Clone(const T &t) {
     void *p = Malloc(sizeof(T));
@@ -136,6 +158,17 @@ class MemPool {
   static constexpr size_t kMemBlockOverhead = (BITS_ALIGN(sizeof(MemPoolCtrler::MemBlock)));
   MemPoolCtrler::MemBlock *GetLargeMemBlock(size_t size);  // Raw allocate large memory block
   MemPoolCtrler::MemBlock *GetMemBlock();
+  using MemBlockStack = std::stack<MemPoolCtrler::MemBlock*>;
+  // The stacks are laid out by the prebuilt pool implementation, so walk their underlying
+  // container in place instead of copying and popping them
+  static const MemBlockStack::container_type &BlocksOf(const MemBlockStack &blocks) {
+    struct Access : MemBlockStack {
+      static const container_type &Get(const MemBlockStack &stack) {
+        return stack.*&Access::c;
+      }
+    };
+    return Access::Get(blocks);
+  }
   MemPoolCtrler *ctrler;  // Hookup controller object
   std::string name;       // Name of the memory pool
   // Save the memory block stack
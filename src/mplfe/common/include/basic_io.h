@@ -160,6 +160,8 @@ class BasicIORead {
   void ReadBufferChar(char *dst, uint32 length, bool &success);
   std::string ReadString(uint32 length);
   std::string ReadString(uint32 length, bool &success);
+  // skip length bytes and return them in place, valid as long as the file stays mapped
+  const uint8 *ReadBufferInPlace(uint32 length);
 
   const uint8 *GetBuffer(uint32 size) const {
     if (pos + size > file.GetLength()) {
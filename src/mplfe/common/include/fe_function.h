@@ -50,6 +50,10 @@ class FEFunction {
     srcFileName = fileName;
   }
 
+  MIRFunction &GetMIRFunction() {
+    return mirFunction;
+  }
+
   void Init() {
     InitImpl();
   }
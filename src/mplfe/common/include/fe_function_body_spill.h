@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#ifndef MPLFE_INCLUDE_COMMON_FE_FUNCTION_BODY_SPILL_H
+#define MPLFE_INCLUDE_COMMON_FE_FUNCTION_BODY_SPILL_H
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include "mir_module.h"
+#include "mir_function.h"
+
+namespace maple {
+// Keeps the dumped MIR of the functions translated in batches in a temporary file, so that their
+// bodies can be released before the next batch is translated. The mpl is written from the file once
+// every function has been translated, with the functions in their module order.
+class FEFunctionBodySpill {
+ public:
+  FEFunctionBodySpill() = default;
+  ~FEFunctionBodySpill();
+
+  // dumps func and releases its body; returns the bytes of MIR released
+  size_t Spill(MIRFunction &func);
+  // writes the module as MIRModule::OutputAsciiMpl("", false) does, taking spilled functions from the file
+  bool OutputAsciiMpl(MIRModule &module) const;
+
+  bool IsEmpty() const {
+    return spilledFuncs.empty();
+  }
+
+ private:
+  bool DumpSpilled(const MIRFunction &func) const;
+
+  FILE *spillFile = nullptr;
+  long spillSize = 0;
+  // puIdx -> offset and length of the dumped function in spillFile
+  std::unordered_map<PUIdx, std::pair<long, size_t>> spilledFuncs;
+};
+}  // namespace maple
+#endif  // MPLFE_INCLUDE_COMMON_FE_FUNCTION_BODY_SPILL_H
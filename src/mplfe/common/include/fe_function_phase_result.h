@@ -19,6 +19,7 @@
 #include <list>
 #include "types_def.h"
 #include "fe_timer_ns.h"
+#include "trace_event.h"
 
 namespace maple {
 class FEFunctionPhaseResult {
@@ -39,6 +40,7 @@ class FEFunctionPhaseResult {
 
   void Start() {
     if (enable && recordTime) {
+      traceBegin = TraceEventRecorder::Clock::now();
       timer.Start();
     }
   }
@@ -55,6 +57,11 @@ class FEFunctionPhaseResult {
     enable = true;
   }
 
+  // name of the method the phases run on, reported with each phase in the trace-event file
+  void SetTraceUnit(const std::string &unit) {
+    traceUnit = unit;
+  }
+
   void RegisterPhaseName(const std::string &name) {
     if (enable && recordTime) {
       currPhaseName = name;
@@ -66,6 +73,7 @@ class FEFunctionPhaseResult {
     if (enable && recordTime) {
       currPhaseName = name;
       phaseNames.push_back(name);
+      traceBegin = TraceEventRecorder::Clock::now();
       timer.Start();
     }
   }
@@ -78,6 +86,8 @@ class FEFunctionPhaseResult {
   std::string currPhaseName = "";
   std::list<std::string> phaseNames;
   std::map<std::string, int64> phaseTimes;
+  std::string traceUnit = "";
+  TraceEventRecorder::Clock::time_point traceBegin;
 };
 }  // namespace maple
 #endif  // MPLFE_INCLUDE_COMMON_FE_FUNCTION_PHASE_RESULT_H
\ No newline at end of file
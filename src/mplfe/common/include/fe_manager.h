@@ -19,6 +19,7 @@
 #include "mir_builder.h"
 #include "fe_type_manager.h"
 #include "fe_java_string_manager.h"
+#include "fe_function_body_spill.h"
 
 namespace maple {
 class FEManager {
@@ -43,6 +44,11 @@ class FEManager {
     return manager->builder;
   }
 
+  static FEFunctionBodySpill &GetFunctionBodySpill() {
+    ASSERT(manager, "manager is not initialize");
+    return manager->bodySpill;
+  }
+
   static void Init(MIRModule &moduleIn) {
     manager = new FEManager(moduleIn);
   }
@@ -61,6 +67,7 @@ class FEManager {
   FETypeManager typeManager;
   FEJavaStringManager javaStringManager;
   MIRBuilder builder;
+  FEFunctionBodySpill bodySpill;
   explicit FEManager(MIRModule &moduleIn)
       : module(moduleIn), typeManager(module), javaStringManager(moduleIn), builder(&module) {}
   ~FEManager() = default;
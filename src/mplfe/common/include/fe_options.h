@@ -78,6 +78,14 @@ class FEOptions {
     return inputMpltFiles;
   }
 
+  void SetIsMpltSnapshot(bool flag) {
+    isMpltSnapshot = flag;
+  }
+
+  bool IsMpltSnapshot() const {
+    return isMpltSnapshot;
+  }
+
   // output control options
   void SetIsGenMpltOnly(bool flag) {
     isGenMpltOnly = flag;
@@ -262,6 +270,14 @@ class FEOptions {
     return isReleaseAfterEmit;
   }
 
+  void SetFuncBatchSize(uint32 size) {
+    funcBatchSize = size;
+  }
+
+  uint32 GetFuncBatchSize() const {
+    return funcBatchSize;
+  }
+
   void AddDumpJBCFuncName(const std::string &funcName) {
     if (!funcName.empty()) {
       CHECK_FATAL(dumpJBCFuncNames.insert(funcName).second, "dumpJBCFuncNames insert failed");
@@ -284,6 +300,7 @@ class FEOptions {
   std::list<std::string> inputMpltFilesFromSys;
   std::list<std::string> inputMpltFilesFromApk;
   std::list<std::string> inputMpltFiles;
+  bool isMpltSnapshot = false;
 
   // output control options
   bool isGenMpltOnly;
@@ -317,6 +334,7 @@ class FEOptions {
   uint32 nthreads;
   bool dumpThreadTime;
   bool isReleaseAfterEmit = false;
+  uint32 funcBatchSize = 0;  // 0 for all the functions at once
 
   FEOptions();
   ~FEOptions() = default;
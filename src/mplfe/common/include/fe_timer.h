@@ -19,6 +19,7 @@
 #include "mpl_timer.h"
 #include "mpl_logging.h"
 #include "fe_options.h"
+#include "trace_event.h"
 
 namespace maple {
 class FETimer {
@@ -33,6 +34,9 @@ class FETimer {
   }
 
   void StartAndDump(const std::string &message) {
+    if (TraceEventRecorder::IsEnabled()) {
+      traceBegin = TraceEventRecorder::Clock::now();
+    }
     if (!FEOptions::GetInstance().IsDumpTime()) {
       return;
     }
@@ -42,6 +46,7 @@ class FETimer {
   }
 
   void StopAndDumpTimeMS(const std::string &message) {
+    Trace(message);
     if (!FEOptions::GetInstance().IsDumpTime()) {
       return;
     }
@@ -51,6 +56,7 @@ class FETimer {
   }
 
   void StopAndDumpTimeS(const std::string &message) {
+    Trace(message);
     if (!FEOptions::GetInstance().IsDumpTime()) {
       return;
     }
@@ -60,7 +66,15 @@ class FETimer {
   }
 
  private:
+  void Trace(const std::string &message) const {
+    if (TraceEventRecorder::IsEnabled()) {
+      TraceEventRecorder::GetInstance().AddCompleteEvent("mplfe", message, "", traceBegin,
+                                                         TraceEventRecorder::Clock::now());
+    }
+  }
+
   MPLTimer timer;
+  TraceEventRecorder::Clock::time_point traceBegin;
 };  // class FETimer
 }  // namespace maple
 #endif  // MPLFE_INCLUDE_COMMON_FE_TIMER_H
\ No newline at end of file
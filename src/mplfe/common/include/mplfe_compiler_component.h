@@ -113,6 +113,15 @@ class MPLFECompilerComponent {
   virtual std::string GetComponentNameImpl() const;
   virtual bool ParallelableImpl() const;
   virtual void DumpPhaseTimeTotalImpl() const;
+  // With --func-batch-size the functions are not all created by PreProcessWithFunction, but this many at a
+  // time by CreateFunctionBatchImpl, which returns false when there are none left.
+  virtual bool CreateFunctionBatchImpl(uint32 batchSize) {
+    return false;
+  }
+
+  // spill the MIR bodies of the functions processed so far, release them and create the next batch,
+  // false if there is none
+  bool NextFunctionBatch();
 
   MIRModule &module;
   MIRSrcLang srcLang;
@@ -55,6 +55,7 @@ class MPLFEOptions : public maple::MapleDriverOptionBase {
   bool ProcessInputMplt(const mapleOption::Option &opt);
   bool ProcessInputMpltFromSys(const mapleOption::Option &opt);
   bool ProcessInputMpltFromApk(const mapleOption::Option &opt);
+  bool ProcessMpltSnapshot(const mapleOption::Option &opt);
 
   // output control options
   bool ProcessOutputPath(const mapleOption::Option &opt);
@@ -68,6 +69,7 @@ class MPLFEOptions : public maple::MapleDriverOptionBase {
   bool ProcessDumpTime(const mapleOption::Option &opt);
   bool ProcessDumpPhaseTime(const mapleOption::Option &opt);
   bool ProcessDumpPhaseTimeDetail(const mapleOption::Option &opt);
+  bool ProcessTraceJson(const mapleOption::Option &opt);
 
   // java compiler options
   bool ProcessModeForJavaStaticFieldName(const mapleOption::Option &opt);
@@ -86,6 +88,7 @@ class MPLFEOptions : public maple::MapleDriverOptionBase {
   bool ProcessNThreads(const mapleOption::Option &opt);
   bool ProcessDumpThreadTime(const mapleOption::Option &opt);
   bool ProcessReleaseAfterEmit(const mapleOption::Option &opt);
+  bool ProcessFuncBatchSize(const mapleOption::Option &opt);
 
   // non-option process
   void ProcessInputFiles(const std::vector<std::string> &inputs);
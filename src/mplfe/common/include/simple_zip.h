@@ -106,8 +106,8 @@ class ZipLocalFile {
   void ProcessCompressedFile(BasicIORead &io, uint32 start, uint32 end);
 
   std::unique_ptr<ZipLocalFileHeader> header;
-  uint8 *compData = nullptr;
-  uint8 *unCompData = nullptr;
+  const uint8 *unCompData = nullptr;  // in the mapped zip file for stored entries, else unCompBuffer
+  uint8 *unCompBuffer = nullptr;
   uint32 unCompDataSize = 0;
   std::unique_ptr<ZipDataDescriptor> dataDesc;
   bool isCompressed = false;
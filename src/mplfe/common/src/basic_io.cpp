@@ -45,7 +45,14 @@ bool BasicIOMapFile::OpenAndMap() {
   long end = lseek(fd, 0L, SEEK_END);
   if (end > start) {
     length = static_cast<size_t>(end - start);
-    ptrMemMap = static_cast<uint8*>(mmap(NULL, length, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, start));
+    void *addr = mmap(NULL, length, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, start);
+    if (addr == MAP_FAILED) {
+      FATAL(kLncFatal, "Unable to map %s.\nError %d in mmap()", fileName.c_str(), errno);
+      return false;
+    }
+    // class files and jars are read front to back, let the kernel read ahead and drop the pages behind
+    (void)madvise(addr, length, MADV_SEQUENTIAL);
+    ptrMemMap = static_cast<uint8*>(addr);
     ptr = ptrMemMap;
     return true;
   } else {
@@ -316,6 +323,12 @@ std::string BasicIORead::ReadString(uint32 length) {
   return std::string(pchar, length);
 }
 
+const uint8 *BasicIORead::ReadBufferInPlace(uint32 length) {
+  const uint8 *p = GetSafeBuffer(length);
+  pos += length;
+  return p;
+}
+
 std::string BasicIORead::ReadString(uint32 length, bool &success) {
   const void *p = GetBuffer(length);
   const char *pchar = static_cast<const char*>(p);
@@ -31,9 +31,11 @@ FEFunction::FEFunction(MIRFunction &argMIRFunction, const std::unique_ptr<FEFunc
       feirStmtTail(nullptr),
       feirBBHead(nullptr),
       feirBBTail(nullptr),
-      phaseResult(FEOptions::GetInstance().IsDumpPhaseTimeDetail() || FEOptions::GetInstance().IsDumpPhaseTime()),
+      phaseResult(FEOptions::GetInstance().IsDumpPhaseTimeDetail() || FEOptions::GetInstance().IsDumpPhaseTime() ||
+                  TraceEventRecorder::IsEnabled()),
       phaseResultTotal(argPhaseResultTotal),
       mirFunction(argMIRFunction) {
+  phaseResult.SetTraceUnit(mirFunction.GetName());
 }
 
 FEFunction::~FEFunction() {
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+#include "fe_function_body_spill.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "mpl_logging.h"
+
+namespace maple {
+FEFunctionBodySpill::~FEFunctionBodySpill() {
+  if (spillFile != nullptr) {
+    (void)fclose(spillFile);
+    spillFile = nullptr;
+  }
+}
+
+size_t FEFunctionBodySpill::Spill(MIRFunction &func) {
+  if (func.GetBody() == nullptr) {
+    return 0;
+  }
+  if (spillFile == nullptr) {
+    // removed by the system once closed
+    spillFile = tmpfile();
+    CHECK_FATAL(spillFile != nullptr, "unable to create the file the function bodies are spilled to");
+  }
+  CHECK_FATAL(fseek(spillFile, spillSize, SEEK_SET) == 0, "unable to spill the body of a function");
+  std::ostringstream text;
+  std::streambuf *backup = LogInfo::MapleLogger().rdbuf();
+  LogInfo::MapleLogger().rdbuf(text.rdbuf());
+  func.Dump();
+  LogInfo::MapleLogger().rdbuf(backup);
+  const std::string &str = text.str();
+  CHECK_FATAL(fwrite(str.data(), sizeof(char), str.size(), spillFile) == str.size(),
+              "unable to spill the body of a function");
+  spilledFuncs[func.GetPuidx()] = std::make_pair(spillSize, str.size());
+  spillSize += static_cast<long>(str.size());
+  size_t released = func.GetCodeMempool()->GetAllocatedSize();
+  func.ReleaseCodeMemory();
+  return released;
+}
+
+bool FEFunctionBodySpill::DumpSpilled(const MIRFunction &func) const {
+  auto it = spilledFuncs.find(func.GetPuidx());
+  if (it == spilledFuncs.end()) {
+    return false;
+  }
+  std::vector<char> text(it->second.second);
+  CHECK_FATAL(fseek(spillFile, it->second.first, SEEK_SET) == 0 &&
+              fread(text.data(), sizeof(char), text.size(), spillFile) == text.size(),
+              "unable to read back the body of a function");
+  (void)LogInfo::MapleLogger().write(text.data(), static_cast<std::streamsize>(text.size()));
+  return true;
+}
+
+bool FEFunctionBodySpill::OutputAsciiMpl(MIRModule &module) const {
+  const std::string &fileName = module.GetFileName();
+  std::string::size_type lastDot = fileName.find_last_of('.');
+  std::string outFileName = (lastDot == std::string::npos) ? fileName : fileName.substr(0, lastDot);
+  outFileName.append((module.GetFlavor() >= kMmpl) ? ".mmpl" : ".mpl");
+  std::ofstream mplFile(outFileName, std::ios::trunc);
+  if (!mplFile.is_open()) {
+    return false;
+  }
+  std::streambuf *backup = LogInfo::MapleLogger().rdbuf();
+  LogInfo::MapleLogger().rdbuf(mplFile.rdbuf());
+  module.DumpGlobals(false);
+  for (MIRFunction *func : module.GetFunctionList()) {
+    if (!DumpSpilled(*func)) {
+      func->Dump();
+    }
+  }
+  LogInfo::MapleLogger().rdbuf(backup);
+  mplFile.close();
+  return true;
+}
+}  // namespace maple
@@ -54,6 +54,10 @@ bool FEFunctionPhaseResult::Finish(bool isSuccess) {
     CHECK_FATAL(!currPhaseName.empty(), "Phase Name is empty");
     int64 t = timer.GetTimeNS();
     phaseTimes[currPhaseName] = t;
+    if (TraceEventRecorder::IsEnabled()) {
+      TraceEventRecorder::GetInstance().AddCompleteEvent("mplfe", currPhaseName, traceUnit, traceBegin,
+                                                         TraceEventRecorder::Clock::now());
+    }
   }
   return success;
 }
@@ -237,7 +237,7 @@ void FEInputStructHelper::ProcessFieldDef() {
       if (fieldHelper->IsStatic()) {
         mirStructType->GetStaticFields().push_back(fieldHelper->GetMIRFieldPair());
       } else {
-        mirStructType->GetFields().push_back(fieldHelper->GetMIRFieldPair());
+        mirStructType->PushbackField(fieldHelper->GetMIRFieldPair());
       }
     } else {
       ERR(kLncErr, "Error occurs in ProcessFieldDef for %s", GetStructNameOrin().c_str());
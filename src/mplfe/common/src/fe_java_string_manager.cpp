@@ -140,7 +140,30 @@ bool FEJavaStringManager::IsAllASCII(const std::u16string &strU16) {
   if (strU16.length() == 0) {
     return false;
   }
-  for (size_t i = 0; i < strU16.length(); ++i) {
+  size_t i = 0;
+#if CHAR_MAX == 0x7F
+  // 16 bytes at a time: a unit is taken when its lower byte is 0 and its upper byte is below CHAR_MAX,
+  // which adding 1 to the upper byte tells by its top bit. An upper byte of 0xFF has the top bit set
+  // already, so what it carries into the next unit does not matter.
+  // Where char is unsigned, the units are only checked one by one.
+  constexpr uint64 kLowerBytes = 0x00FF00FF00FF00FFULL;
+  constexpr uint64 kUpperByteOne = 0x0100010001000100ULL;
+  constexpr uint64 kUpperByteTop = 0x8000800080008000ULL;
+  constexpr size_t kUnitsPerWord = sizeof(uint64) / sizeof(char16_t);
+  constexpr size_t kUnitsPerChunk = kUnitsPerWord * 2;
+  const char16_t *data = strU16.data();
+  for (; i + kUnitsPerChunk <= strU16.length(); i += kUnitsPerChunk) {
+    uint64 words[2];
+    errno_t err = memcpy_s(words, sizeof(words), data + i, sizeof(words));
+    CHECK_FATAL(err == EOK, "memcpy_s failed");
+    uint64 lower = (words[0] | words[1]) & kLowerBytes;
+    uint64 upper = (words[0] | (words[0] + kUpperByteOne) | words[1] | (words[1] + kUpperByteOne)) & kUpperByteTop;
+    if ((lower | upper) != 0) {
+      return false;
+    }
+  }
+#endif
+  for (; i < strU16.length(); ++i) {
     uint16 val = ExchangeBytesPosition(strU16[i]);
     if (val >= CHAR_MAX) {
       return false;
@@ -214,6 +237,7 @@ MIRAggConst *FEJavaStringManager::CreateByteArrayConst(const std::u16string &str
 
 std::vector<uint8> FEJavaStringManager::SwapBytes(const std::u16string &strU16) {
   std::vector<uint8> out;
+  out.reserve((strU16.length() + 1) * sizeof(char16_t));
   for (size_t i = 0; i < strU16.length(); ++i) {
     uint16 c16 = strU16[i];
     out.push_back((c16 & 0xFF00) >> 8);
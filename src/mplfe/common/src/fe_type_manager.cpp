@@ -20,6 +20,7 @@
 #include "global_tables.h"
 #include "fe_timer.h"
 #include "fe_config_parallel.h"
+#include "fe_options.h"
 #include "feir_type_helper.h"
 
 namespace maple {
@@ -74,8 +75,11 @@ bool FETypeManager::LoadMplts(const std::list<std::string> &mpltNames, FETypeFla
 
 bool FETypeManager::LoadMplt(const std::string &mpltName, FETypeFlag flag) {
   BinaryMplt binMplt(module);
-  if (!binMplt.Import(mpltName)) {
-    // not a binary mplt
+  bool useSnapshot = FEOptions::GetInstance().IsMpltSnapshot() && flag == FETypeFlag::kSrcMpltSys;
+  if (!binMplt.Import(mpltName) && !(useSnapshot && binMplt.ImportSnapshot(mpltName))) {
+    // a text mplt, whose snapshot only holds its own types when it is the first thing loaded
+    bool takeSnapshot = useSnapshot && module.GetClassList().empty() &&
+                        GlobalTables::GetConstPool().GetImportedLiteralNames().empty();
     std::ifstream file(mpltName);
     if (!file.is_open()) {
       ERR(kLncErr, "unable to open mplt file %s", mpltName.c_str());
@@ -88,6 +92,9 @@ bool FETypeManager::LoadMplt(const std::string &mpltName, FETypeFlag flag) {
       return false;
     }
     file.close();
+    if (takeSnapshot && !binMplt.ExportSnapshot(mpltName)) {
+      WARN(kLncWarn, "unable to write the snapshot of mplt file %s", mpltName.c_str());
+    }
   }
   UpdateStructNameTypeMapFromTypeTable(mpltName, flag);
   UpdateNameFuncMapFromTypeTable();
@@ -120,7 +120,12 @@ void MPLFECompiler::ExportMpltFile() {
 void MPLFECompiler::ExportMplFile() {
   FETimer timer;
   timer.StartAndDump("Output mpl");
-  module.OutputAsciiMpl("", false);
+  FEFunctionBodySpill &bodySpill = FEManager::GetFunctionBodySpill();
+  if (bodySpill.IsEmpty()) {
+    module.OutputAsciiMpl("", false);
+  } else {
+    CHECK_FATAL(bodySpill.OutputAsciiMpl(module), "unable to write the mpl file");
+  }
   timer.StopAndDumpTimeMS("Output mpl");
 }
 
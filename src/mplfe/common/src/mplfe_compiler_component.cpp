@@ -17,6 +17,8 @@
 #include "fe_macros.h"
 #include "fe_timer.h"
 #include "fe_config_parallel.h"
+#include "fe_manager.h"
+#include "global_tables.h"
 
 namespace maple {
 // ---------- FEFunctionProcessTask ----------
@@ -62,11 +64,13 @@ bool MPLFECompilerComponent::ProcessFunctionSerialImpl() {
   FETimer timer;
   timer.StartAndDump(ss.str());
   FE_INFO_LEVEL(FEOptions::kDumpLevelInfo, "===== Process %s =====", ss.str().c_str());
-  for (const std::unique_ptr<FEFunction> &function : functions) {
-    ASSERT(function != nullptr, "nullptr check");
-    function->Process();
-    function->Finish();
-  }
+  do {
+    for (const std::unique_ptr<FEFunction> &function : functions) {
+      ASSERT(function != nullptr, "nullptr check");
+      function->Process();
+      function->Finish();
+    }
+  } while (NextFunctionBatch());
   timer.StopAndDumpTimeMS(ss.str());
   return true;
 }
@@ -77,16 +81,39 @@ bool MPLFECompilerComponent::ProcessFunctionParallelImpl(uint32 nthreads) {
   FETimer timer;
   timer.StartAndDump(ss.str());
   FE_INFO_LEVEL(FEOptions::kDumpLevelInfo, "===== Process %s =====", ss.str().c_str());
-  FEFunctionProcessSchedular schedular(ss.str());
-  for (const std::unique_ptr<FEFunction> &function : functions) {
-    schedular.AddFunctionProcessTask(function);
-  }
-  schedular.SetDumpTime(FEOptions::GetInstance().IsDumpThreadTime());
-  (void)schedular.RunTask(nthreads, true);
+  do {
+    if (functions.empty()) {
+      continue;
+    }
+    FEFunctionProcessSchedular schedular(ss.str());
+    for (const std::unique_ptr<FEFunction> &function : functions) {
+      schedular.AddFunctionProcessTask(function);
+    }
+    schedular.SetDumpTime(FEOptions::GetInstance().IsDumpThreadTime());
+    (void)schedular.RunTask(nthreads, true);
+    // the worker threads have finished, so no FieldID lookup is running
+    GlobalTables::GetTypeTable().ReleaseStaleFlatFieldTables();
+  } while (NextFunctionBatch());
   timer.StopAndDumpTimeMS(ss.str());
   return true;
 }
 
+bool MPLFECompilerComponent::NextFunctionBatch() {
+  uint32 batchSize = FEOptions::GetInstance().GetFuncBatchSize();
+  if (batchSize == 0) {
+    return false;
+  }
+  // the functions have been emitted to MIR, their FEIR goes with them and their MIR is spilled
+  size_t releasedSize = 0;
+  for (const std::unique_ptr<FEFunction> &function : functions) {
+    releasedSize += FEManager::GetFunctionBodySpill().Spill(function->GetMIRFunction());
+  }
+  FE_INFO_LEVEL(FEOptions::kDumpLevelInfo, "batch of %zu functions done, %zu bytes of MIR spilled",
+                functions.size(), releasedSize);
+  functions.clear();
+  return CreateFunctionBatchImpl(batchSize);
+}
+
 std::string MPLFECompilerComponent::GetComponentNameImpl() const {
   return "MPLFECompilerComponent";
 }
@@ -13,6 +13,9 @@
  * See the Mulan PSL v1 for more details.
  */
 #include "mplfe_options.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include "fe_options.h"
@@ -20,6 +23,7 @@
 #include "option_parser.h"
 #include "parser_opt.h"
 #include "fe_file_type.h"
+#include "trace_event.h"
 
 namespace maple {
 using namespace mapleOption;
@@ -29,6 +33,7 @@ enum OptionIndex : uint32 {
   // input control options
   kInClass,
   kInJar,
+  kMpltSnapshot,
   // output control options
   kOutputPath,
   kOutputName,
@@ -55,6 +60,7 @@ enum OptionIndex : uint32 {
   kNThreads,
   kDumpThreadTime,
   kReleaseAfterEmit,
+  kFuncBatchSize,
 };
 
 const mapleOption::Descriptor kUsage[] = {
@@ -82,6 +88,9 @@ const mapleOption::Descriptor kUsage[] = {
     mapleOption::kBuildTypeAll, mapleOption::kArgCheckPolicyRequired,
     "  --in-jar file1.jar,file2.jar\n"
     "                         : input jar files", "mplfe", {} },
+  { static_cast<uint32>(kMpltSnapshot), 0, "", "mplt-snapshot",
+    mapleOption::kBuildTypeAll, mapleOption::kArgCheckPolicyNone,
+    "  --mplt-snapshot        : load text mplts from sys through binary snapshots kept next to them", "mplfe", {} },
 
   // output control options
   { static_cast<uint32>(kUnknown), 0, "", "",
@@ -180,6 +189,12 @@ const mapleOption::Descriptor kUsage[] = {
   { static_cast<uint32>(kReleaseAfterEmit), 0, "", "release-after-emit",
     mapleOption::kBuildTypeAll, mapleOption::kArgCheckPolicyNone,
     "  --release-after-emit   : release temp memory after emit", "mplfe", {} },
+  { static_cast<uint32>(kFuncBatchSize), 0, "", "func-batch-size",
+    mapleOption::kBuildTypeAll, mapleOption::kArgCheckPolicyNumeric,
+    "  --func-batch-size num  : create and translate functions num at a time (num > 0), releasing the\n"
+    "                           FEIR, JBC function state and MIR bodies of each batch after it is\n"
+    "                           emitted. The MIR bodies are spilled to a temporary file until the mpl\n"
+    "                           file is written", "mplfe", {} },
   { 0, 0, nullptr, nullptr, mapleOption::kBuildTypeAll, mapleOption::kArgCheckPolicyNone, nullptr, "mplfe", {} }
 };
 
@@ -207,6 +222,8 @@ bool MPLFEOptions::InitFactory() {
                                                 &MPLFEOptions::ProcessInClass);
   RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kInJar),
                                                 &MPLFEOptions::ProcessInJar);
+  RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kMpltSnapshot),
+                                                &MPLFEOptions::ProcessMpltSnapshot);
 
   // output control options
   RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kOutputPath),
@@ -229,6 +246,9 @@ bool MPLFEOptions::InitFactory() {
                                                 &MPLFEOptions::ProcessDumpPhaseTime);
   RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kDumpPhaseTimeDetail),
                                                 &MPLFEOptions::ProcessDumpPhaseTimeDetail);
+  // --trace-json is shared with the other tools, see DriverOptionCommon
+  RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kTraceJson),
+                                                &MPLFEOptions::ProcessTraceJson);
 
   // java bytecode compile options
   RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kJavaStaticFieldName),
@@ -257,6 +277,8 @@ bool MPLFEOptions::InitFactory() {
                                                 &MPLFEOptions::ProcessDumpThreadTime);
   RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kReleaseAfterEmit),
                                                 &MPLFEOptions::ProcessReleaseAfterEmit);
+  RegisterFactoryFunction<OptionProcessFactory>(static_cast<uint32>(kFuncBatchSize),
+                                                &MPLFEOptions::ProcessFuncBatchSize);
   return true;
 }
 
@@ -373,6 +395,11 @@ bool MPLFEOptions::ProcessOutputName(const mapleOption::Option &opt) {
   return true;
 }
 
+bool MPLFEOptions::ProcessMpltSnapshot(const mapleOption::Option &opt) {
+  FEOptions::GetInstance().SetIsMpltSnapshot(true);
+  return true;
+}
+
 bool MPLFEOptions::ProcessGenMpltOnly(const mapleOption::Option &opt) {
   FEOptions::GetInstance().SetIsGenMpltOnly(true);
   return true;
@@ -408,6 +435,11 @@ bool MPLFEOptions::ProcessDumpPhaseTimeDetail(const mapleOption::Option &opt) {
   return true;
 }
 
+bool MPLFEOptions::ProcessTraceJson(const mapleOption::Option &opt) {
+  TraceEventRecorder::GetInstance().Enable(opt.Args());
+  return true;
+}
+
 // java compiler options
 bool MPLFEOptions::ProcessModeForJavaStaticFieldName(const mapleOption::Option &opt) {
   std::string arg = opt.Args();
@@ -496,6 +528,19 @@ bool MPLFEOptions::ProcessReleaseAfterEmit(const mapleOption::Option &opt) {
   return true;
 }
 
+bool MPLFEOptions::ProcessFuncBatchSize(const mapleOption::Option &opt) {
+  std::string arg = opt.Args();
+  char *end = nullptr;
+  errno = 0;
+  long size = std::strtol(arg.c_str(), &end, 10);
+  if (errno != 0 || end == arg.c_str() || *end != '\0' || size <= 0 || size > INT_MAX) {
+    ERR(kLncErr, "invalid func batch size: %s, a positive number is expected", arg.c_str());
+    return false;
+  }
+  FEOptions::GetInstance().SetFuncBatchSize(static_cast<uint32>(size));
+  return true;
+}
+
 void MPLFEOptions::ProcessInputFiles(const std::vector<std::string> &inputs) {
   FE_INFO_LEVEL(FEOptions::kDumpLevelInfo, "===== Process MPLFEOptions::ProcessInputFiles() =====");
   for (const std::string &inputName : inputs) {
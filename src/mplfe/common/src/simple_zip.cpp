@@ -14,6 +14,7 @@
  */
 #include "simple_zip.h"
 #include <malloc.h>
+#include <cstring>
 #include <zlib.h>
 
 namespace maple {
@@ -60,14 +61,11 @@ std::unique_ptr<ZipDataDescriptor> ZipDataDescriptor::Parse(BasicIORead &io) {
 }
 
 ZipLocalFile::~ZipLocalFile() {
-  if (compData != nullptr) {
-    free(compData);
-    compData = nullptr;
-  }
-  if (unCompData != nullptr) {
-    free(unCompData);
-    unCompData = nullptr;
+  if (unCompBuffer != nullptr) {
+    free(unCompBuffer);
+    unCompBuffer = nullptr;
   }
+  unCompData = nullptr;
 }
 
 std::unique_ptr<ZipLocalFile> ZipLocalFile::Parse(BasicIORead &io) {
@@ -89,10 +87,18 @@ std::unique_ptr<ZipLocalFile> ZipLocalFile::Parse(BasicIORead &io) {
 
 uint32 ZipLocalFile::GetDataEndPos(const BasicIORead &io) {
   const uint8 offsetSize = 4;
+  // all the signatures start with the same byte, which memchr skips to
+  const uint8 sigFirstByte = static_cast<uint8>(kZipSigLocalFile & 0xFF);
   uint32 posDataStart = io.GetPos();
-  uint32 posDataEnd = posDataStart;
-  const uint8 *buf = io.GetSafeBuffer(offsetSize);
-  while (posDataEnd + offsetSize < io.GetFileLength()) {
+  const uint8 *bufStart = io.GetSafeBuffer(offsetSize);
+  const uint8 *bufEnd = bufStart + (io.GetFileLength() - posDataStart - offsetSize);
+  const uint8 *buf = bufStart;
+  while (buf < bufEnd) {
+    buf = static_cast<const uint8*>(memchr(buf, sigFirstByte, static_cast<size_t>(bufEnd - buf)));
+    if (buf == nullptr) {
+      buf = bufEnd;
+      break;
+    }
     uint32 sig = BasicIOEndian::GetUInt32LittleEndian(buf);
     if (sig == kZipSigLocalFile) {
       break;
@@ -105,8 +111,8 @@ uint32 ZipLocalFile::GetDataEndPos(const BasicIORead &io) {
       break;
     }
     ++buf;
-    ++posDataEnd;
   }
+  uint32 posDataEnd = posDataStart + static_cast<uint32>(buf - bufStart);
   CHECK_FATAL(posDataEnd + offsetSize < io.GetFileLength(), "invalid zip file: no data descriptor");
   return posDataEnd;
 }
@@ -114,9 +120,8 @@ uint32 ZipLocalFile::GetDataEndPos(const BasicIORead &io) {
 void ZipLocalFile::ProcessUncompressedFile(BasicIORead &io, uint32 start, uint32 end) {
   unCompDataSize = end - start;
   if (unCompDataSize > 0) {
-    unCompData = static_cast<uint8*>(malloc(unCompDataSize));
-    CHECK_NULL_FATAL(unCompData);
-    io.ReadBufferUInt8(unCompData, unCompDataSize);
+    // stored entries are used in place
+    unCompData = io.ReadBufferInPlace(unCompDataSize);
   }
 }
 
@@ -125,23 +130,23 @@ void ZipLocalFile::ProcessCompressedFile(BasicIORead &io, uint32 start, uint32 e
   if (compDataLength == 0) {
     return;
   }
-  compData = static_cast<uint8*>(malloc(compDataLength));
-  CHECK_NULL_FATAL(compData);
-  io.ReadBufferUInt8(compData, compDataLength);
+  // inflated straight from the mapped zip file
+  const uint8 *compData = io.ReadBufferInPlace(compDataLength);
   dataDesc = ZipDataDescriptor::Parse(io);
   CHECK_FATAL(compDataLength == dataDesc->GetCompSize(), "invalid zip file: wrong compsize");
   if (dataDesc->GetUnCompSize() > 0) {
-    unCompData = static_cast<uint8*>(malloc(dataDesc->GetUnCompSize()));
-    CHECK_NULL_FATAL(unCompData);
+    unCompBuffer = static_cast<uint8*>(malloc(dataDesc->GetUnCompSize()));
+    CHECK_NULL_FATAL(unCompBuffer);
+    unCompData = unCompBuffer;
     z_stream zs;
     zs.zalloc = static_cast<alloc_func>(0);
     zs.zfree = static_cast<free_func>(0);
     int err = inflateInit2(&zs, -MAX_WBITS);
     CHECK_FATAL(err == 0, "inflateInit2 error");
-    zs.next_in = compData;
+    zs.next_in = const_cast<uint8*>(compData);
     zs.avail_in = dataDesc->GetCompSize();
     zs.total_in = 0;
-    zs.next_out = unCompData;
+    zs.next_out = unCompBuffer;
     zs.avail_out = dataDesc->GetUnCompSize();
     zs.total_out = 0;
     err = inflate(&zs, Z_NO_FLUSH);
@@ -150,7 +155,8 @@ void ZipLocalFile::ProcessCompressedFile(BasicIORead &io, uint32 start, uint32 e
     }
     unCompDataSize = dataDesc->GetUnCompSize();
     if (err != Z_OK) {
-      free(unCompData);
+      free(unCompBuffer);
+      unCompBuffer = nullptr;
       unCompData = nullptr;
       unCompDataSize = 0;
       CHECK_FATAL(false, "inflate failed");
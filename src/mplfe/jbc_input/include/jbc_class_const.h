@@ -128,8 +128,9 @@ class JBCConstUTF8 : public JBCConst {
   JBCConstUTF8(MapleAllocator &alloc, JBCConstTag t, const std::string &argStr);
   ~JBCConstUTF8() = default;
 
-  const std::string GetString() const {
-    return MapleStringToStd(str);
+  // the string is only kept interned
+  const std::string &GetString() const {
+    return GlobalTables::GetStrTable().GetStringFromStrIdx(strIdx);
   }
 
   GStrIdx GetStrIdx() const {
@@ -144,7 +145,6 @@ class JBCConstUTF8 : public JBCConst {
  private:
   uint16 length;
   GStrIdx strIdx;
-  MapleString str;
 };
 
 class JBCConst4Byte : public JBCConst {
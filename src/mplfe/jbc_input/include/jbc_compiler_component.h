@@ -17,6 +17,7 @@
 #include "fe_macros.h"
 #include "mplfe_compiler_component.h"
 #include "jbc_input.h"
+#include "jbc_class2fe_helper.h"
 #include "fe_function_phase_result.h"
 
 namespace maple {
@@ -36,11 +37,23 @@ class JBCCompilerComponent : public MPLFECompilerComponent {
   std::string GetComponentNameImpl() const override;
   bool ParallelableImpl() const override;
   void DumpPhaseTimeTotalImpl() const override;
+  bool CreateFunctionBatchImpl(uint32 batchSize) override;
 
  private:
+  // a method whose function is yet to be created
+  struct PendingFunction {
+    FEInputStructHelper *structHelper;
+    JBCClassMethod2FEHelper *methodHelper;
+    MIRFunction *mirFunc;
+  };
+
+  void CreateFunction(const FEInputStructHelper &structHelper, JBCClassMethod2FEHelper &methodHelper,
+                      MIRFunction &mirFunc);
+
   MemPool *mp;
   MapleAllocator allocator;
   jbc::JBCInput jbcInput;
+  std::list<PendingFunction> pendingFunctions;
 };  // class JBCCompilerComponent
 }  // namespace maple
 #endif  // MPLFE_INCLUDE_JBC_COMPILER_COMPONENT_H
\ No newline at end of file
@@ -90,23 +90,32 @@ std::string JBCConst::FullNameToInternalName(const std::string &name) {
 
 // ---------- JBCConstUTF8 ----------
 JBCConstUTF8::JBCConstUTF8(MapleAllocator &alloc, JBCConstTag t)
-    : JBCConst(alloc, t), length(0), strIdx(0), str("", alloc.GetMemPool()) {}
+    : JBCConst(alloc, t), length(0), strIdx(0) {}
 
 JBCConstUTF8::JBCConstUTF8(MapleAllocator &alloc, JBCConstTag t, const std::string &argStr)
-    : JBCConst(alloc, t), str(argStr, alloc.GetMemPool()) {
+    : JBCConst(alloc, t) {
   CHECK_FATAL(t == kConstUTF8, "invalid tag");
-  size_t rawLength = str.length();
+  size_t rawLength = argStr.length();
   CHECK_FATAL(rawLength < UINT16_MAX, "input string is too long");
   length = static_cast<uint16>(rawLength);
-  strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName(MapleStringToStd(str));
+  strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName(argStr);
 }
 
 bool JBCConstUTF8::ParseFileImpl(BasicIORead &io) {
   bool success = false;
   length = io.ReadUInt16(success);
-  str = io.ReadString(length, success);
-  strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName(MapleStringToStd(str));
-  return success;
+  if (!success) {
+    return false;
+  }
+  // interned straight from the mapped bytes, no copy of the string is kept in the pool
+  const uint8 *data = io.GetBuffer(length);
+  if (data == nullptr) {
+    return false;
+  }
+  (void)io.ReadBufferInPlace(length);
+  strIdx = GlobalTables::GetStrTable().GetOrCreateStrIdxFromName(
+      std::string(reinterpret_cast<const char*>(data), length));
+  return true;
 }
 
 bool JBCConstUTF8::PreProcessImpl(const JBCConstPool &constPool) {
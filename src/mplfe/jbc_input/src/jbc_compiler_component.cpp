@@ -92,6 +92,7 @@ bool JBCCompilerComponent::PreProcessWithFunctionImpl() {
   FETimer timer;
   timer.StartAndDump("JBCCompilerComponent::PreProcessWithFunction()");
   FE_INFO_LEVEL(FEOptions::kDumpLevelInfo, "===== Process JBCCompilerComponent::PreProcessWithFunction() =====");
+  bool inBatches = FEOptions::GetInstance().GetFuncBatchSize() != 0;
   for (const std::unique_ptr<FEInputStructHelper> &structHelper : structHelpers) {
     ASSERT(structHelper != nullptr, "nullptr check");
     for (FEInputMethodHelper *methodHelper : structHelper->GetMethodHelpers()) {
@@ -101,18 +102,36 @@ bool JBCCompilerComponent::PreProcessWithFunctionImpl() {
       bool isStatic = methodHelper->IsStatic();
       MIRFunction *mirFunc = FEManager::GetTypeManager().GetMIRFunction(methodNameIdx, isStatic);
       CHECK_NULL_FATAL(mirFunc);
-      std::unique_ptr<FEFunction> feFunction = std::make_unique<JBCFunction>(*jbcMethodHelper, *mirFunc,
-                                                                             phaseResultTotal);
+      // the functions are added to the module here in any case, so they keep their order
       module.AddFunction(mirFunc);
-      feFunction->Init();
-      feFunction->SetSrcFileName(structHelper->GetSrcFileName());
-      functions.push_back(std::move(feFunction));
+      if (inBatches) {
+        pendingFunctions.push_back({ structHelper.get(), jbcMethodHelper, mirFunc });
+      } else {
+        CreateFunction(*structHelper, *jbcMethodHelper, *mirFunc);
+      }
     }
   }
   timer.StopAndDumpTimeMS("JBCCompilerComponent::PreProcessWithFunction()");
   return true;
 }
 
+void JBCCompilerComponent::CreateFunction(const FEInputStructHelper &structHelper,
+                                          JBCClassMethod2FEHelper &methodHelper, MIRFunction &mirFunc) {
+  std::unique_ptr<FEFunction> feFunction = std::make_unique<JBCFunction>(methodHelper, mirFunc, phaseResultTotal);
+  feFunction->Init();
+  feFunction->SetSrcFileName(structHelper.GetSrcFileName());
+  functions.push_back(std::move(feFunction));
+}
+
+bool JBCCompilerComponent::CreateFunctionBatchImpl(uint32 batchSize) {
+  for (uint32 i = 0; i < batchSize && !pendingFunctions.empty(); ++i) {
+    const PendingFunction &pending = pendingFunctions.front();
+    CreateFunction(*pending.structHelper, *pending.methodHelper, *pending.mirFunc);
+    pendingFunctions.pop_front();
+  }
+  return !functions.empty();
+}
+
 std::string JBCCompilerComponent::GetComponentNameImpl() const {
   return "JBCCompilerComponent";
 }
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+// Checks FEJavaStringManager::IsAllASCII against a unit by unit reference around the 16 byte chunks it
+// reads, and with --bench times both.
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "fe_java_string_manager.h"
+
+namespace {
+using maple::FEJavaStringManager;
+
+// the literal units are kept with their bytes swapped
+char16_t Stored(uint16_t val) {
+  return static_cast<char16_t>(static_cast<uint16_t>((val >> 8) | (val << 8)));
+}
+
+bool ReferenceIsAllASCII(const std::u16string &strU16) {
+  if (strU16.empty()) {
+    return false;
+  }
+  for (char16_t unit : strU16) {
+    uint16_t val = static_cast<uint16_t>((static_cast<uint16_t>(unit) >> 8) | (static_cast<uint16_t>(unit) << 8));
+    if (val >= CHAR_MAX) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the values next to each edge the chunked check tests: the lower byte, CHAR_MAX and the carry out of
+// an upper byte of 0xFF
+const std::vector<uint16_t> kBoundaryValues = {
+  0x0000, 0x0001, 0x0041, 0x007E, 0x007F, 0x0080, 0x00FE, 0x00FF, 0x0100, 0x0141,
+  0x017E, 0x7E00, 0x7F00, 0x8000, 0xFE7E, 0xFF00, 0xFF7E, 0xFFFF
+};
+// longer than two chunks, so every length of the tail is met after zero, one and two chunks
+constexpr size_t kMaxLength = 40;
+
+int failures = 0;
+
+void Expect(const std::u16string &str, const char *what) {
+  bool expected = ReferenceIsAllASCII(str);
+  if (FEJavaStringManager::IsAllASCII(str) != expected) {
+    std::cerr << "FAIL " << what << ": length " << str.length() << ", expected " << expected << "\n";
+    ++failures;
+  }
+}
+
+void TestLengths() {
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    Expect(std::u16string(length, Stored('a')), "all ascii");
+    Expect(std::u16string(length, Stored(CHAR_MAX - 1)), "all CHAR_MAX - 1");
+  }
+}
+
+void TestOneUnit() {
+  for (size_t length = 1; length <= kMaxLength; ++length) {
+    for (size_t pos = 0; pos < length; ++pos) {
+      for (uint16_t val : kBoundaryValues) {
+        std::u16string str(length, Stored('a'));
+        str[pos] = Stored(val);
+        Expect(str, "one boundary unit");
+      }
+    }
+  }
+}
+
+// an upper byte of 0xFF carries into the next unit when one is added to it
+void TestAdjacentUnits() {
+  for (size_t length = 2; length <= kMaxLength; ++length) {
+    for (size_t pos = 0; pos + 1 < length; ++pos) {
+      for (uint16_t first : kBoundaryValues) {
+        for (uint16_t second : kBoundaryValues) {
+          std::u16string str(length, Stored('a'));
+          str[pos] = Stored(first);
+          str[pos + 1] = Stored(second);
+          Expect(str, "two boundary units");
+        }
+      }
+    }
+  }
+}
+
+void TestRandom() {
+  std::mt19937 gen(0x5EED);
+  std::uniform_int_distribution<size_t> lengthDist(0, kMaxLength * 4);
+  std::uniform_int_distribution<uint16_t> asciiDist(0, CHAR_MAX - 1);
+  std::uniform_int_distribution<uint16_t> anyDist(0, UINT16_MAX);
+  std::uniform_int_distribution<int> pickDist(0, 63);
+  constexpr int kRandomStrings = 100000;
+  for (int n = 0; n < kRandomStrings; ++n) {
+    std::u16string str(lengthDist(gen), u'\0');
+    for (char16_t &unit : str) {
+      unit = Stored(pickDist(gen) == 0 ? anyDist(gen) : asciiDist(gen));
+    }
+    Expect(str, "random");
+  }
+}
+
+template <typename Check>
+double NanosPerString(const std::vector<std::u16string> &strs, Check check, size_t rounds) {
+  size_t taken = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < rounds; ++r) {
+    for (const std::u16string &str : strs) {
+      taken += check(str) ? 1 : 0;
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  // keeps the checks from being optimized away
+  if (taken == SIZE_MAX) {
+    std::cout << taken;
+  }
+  return std::chrono::duration<double, std::nano>(end - start).count() / (rounds * strs.size());
+}
+
+void Bench() {
+  constexpr size_t kStrings = 1024;
+  constexpr size_t kUnitsPerRound = 1u << 22;
+  for (size_t length : { 4, 8, 15, 16, 17, 32, 64, 256, 4096 }) {
+    std::vector<std::u16string> strs(kStrings, std::u16string(length, Stored('a')));
+    size_t rounds = kUnitsPerRound / (kStrings * length) + 1;
+    double scalar = NanosPerString(strs, ReferenceIsAllASCII, rounds);
+    double chunked = NanosPerString(strs, FEJavaStringManager::IsAllASCII, rounds);
+    std::cout << "length " << length << ": " << scalar << " ns unit by unit, " << chunked << " ns IsAllASCII, "
+              << (scalar / chunked) << "x\n";
+  }
+}
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+    Bench();
+    return 0;
+  }
+  TestLengths();
+  TestOneUnit();
+  TestAdjacentUnits();
+  TestRandom();
+  if (failures != 0) {
+    std::cerr << failures << " failures\n";
+    return 1;
+  }
+  std::cout << "IsAllASCII: all checks passed\n";
+  return 0;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) [2020] Huawei Technologies Co.,Ltd.All rights reserved.
+ *
+ * OpenArkCompiler is licensed under the Mulan PSL v1.
+ * You can use this software according to the terms and conditions of the Mulan PSL v1.
+ * You may obtain a copy of Mulan PSL v1 at:
+ *
+ *     http://license.coscl.org.cn/MulanPSL
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND, EITHER
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT, MERCHANTABILITY OR
+ * FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v1 for more details.
+ */
+// Checks that SimpleZip reads stored entries in place and inflates deflated ones from a mapped jar: a jar
+// mixing both, written the way jar tools write them, reads back with the names and contents put in.
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "simple_zip.h"
+
+namespace {
+using namespace maple;
+
+int failures = 0;
+
+void Expect(bool cond, const std::string &what) {
+  if (!cond) {
+    std::cerr << "FAIL " << what << "\n";
+    ++failures;
+  }
+}
+
+struct Entry {
+  std::string name;
+  std::string data;
+  bool deflated;
+};
+
+void PutUInt16(std::vector<uint8> &out, uint32 value) {
+  out.push_back(static_cast<uint8>(value & 0xFF));
+  out.push_back(static_cast<uint8>((value >> 8) & 0xFF));
+}
+
+void PutUInt32(std::vector<uint8> &out, uint32 value) {
+  PutUInt16(out, value & 0xFFFF);
+  PutUInt16(out, value >> 16);
+}
+
+std::vector<uint8> Deflate(const std::string &data) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  int err = deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  CHECK_FATAL(err == Z_OK, "deflateInit2 error");
+  std::vector<uint8> out(deflateBound(&zs, data.size()));
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  zs.avail_in = static_cast<uInt>(data.size());
+  zs.next_out = out.data();
+  zs.avail_out = static_cast<uInt>(out.size());
+  err = deflate(&zs, Z_FINISH);
+  CHECK_FATAL(err == Z_STREAM_END, "deflate error");
+  out.resize(zs.total_out);
+  (void)deflateEnd(&zs);
+  return out;
+}
+
+// stored entries carry their sizes in the header, deflated ones in a data descriptor after their data
+std::vector<uint8> MakeJar(const std::vector<Entry> &entries) {
+  const uint16 kFlagDataDescriptor = 0x8;
+  const uint16 kMethodStored = 0;
+  const uint16 kMethodDeflated = 8;
+  std::vector<uint8> jar;
+  for (const Entry &entry : entries) {
+    uint32 crc = static_cast<uint32>(crc32(0, reinterpret_cast<const Bytef*>(entry.data.data()),
+                                           static_cast<uInt>(entry.data.size())));
+    std::vector<uint8> payload = entry.deflated ? Deflate(entry.data) :
+                                                  std::vector<uint8>(entry.data.begin(), entry.data.end());
+    PutUInt32(jar, kZipSigLocalFile);
+    PutUInt16(jar, 20);  // version needed to extract
+    PutUInt16(jar, entry.deflated ? kFlagDataDescriptor : 0);
+    PutUInt16(jar, entry.deflated ? kMethodDeflated : kMethodStored);
+    PutUInt16(jar, 0);  // time
+    PutUInt16(jar, 0);  // date
+    PutUInt32(jar, entry.deflated ? 0 : crc);
+    PutUInt32(jar, entry.deflated ? 0 : static_cast<uint32>(payload.size()));
+    PutUInt32(jar, entry.deflated ? 0 : static_cast<uint32>(entry.data.size()));
+    PutUInt16(jar, static_cast<uint32>(entry.name.size()));
+    PutUInt16(jar, 0);  // extra field length
+    jar.insert(jar.end(), entry.name.begin(), entry.name.end());
+    jar.insert(jar.end(), payload.begin(), payload.end());
+    if (entry.deflated) {
+      PutUInt32(jar, kZipSigDataDescriptor);
+      PutUInt32(jar, crc);
+      PutUInt32(jar, static_cast<uint32>(payload.size()));
+      PutUInt32(jar, static_cast<uint32>(entry.data.size()));
+    }
+  }
+  // the entries end where the central directory starts, its content is not read
+  const size_t kCentralDirHeaderSize = 46;
+  PutUInt32(jar, kZipSigCentralDir);
+  jar.resize(jar.size() + kCentralDirHeaderSize - sizeof(uint32), 0);
+  return jar;
+}
+
+std::string ClassLikeData(size_t size, uint32 seed) {
+  std::string data = "\xCA\xFE\xBA\xBE";
+  // repetitive enough to deflate well, and full of the first byte of the zip signatures
+  while (data.size() < size) {
+    data += "PK" + std::to_string(seed++ % 97) + "Ljava/lang/Object;";
+  }
+  data.resize(size);
+  return data;
+}
+
+void TestJar(const std::string &what, const std::vector<Entry> &entries) {
+  std::vector<uint8> jar = MakeJar(entries);
+  char path[] = "/tmp/simple_zip_test_XXXXXX";
+  int fd = mkstemp(path);
+  CHECK_FATAL(fd >= 0, "mkstemp failed");
+  CHECK_FATAL(write(fd, jar.data(), jar.size()) == static_cast<ssize_t>(jar.size()), "write failed");
+  (void)close(fd);
+  BasicIOMapFile file(path);
+  Expect(file.OpenAndMap(), what + ": map");
+  SimpleZip zip(file);
+  Expect(zip.ParseFile(), what + ": parse");
+  const std::list<std::unique_ptr<ZipLocalFile>> &files = zip.GetFiles();
+  Expect(files.size() == entries.size(), what + ": " + std::to_string(files.size()) + " entries read");
+  auto it = files.begin();
+  for (size_t i = 0; i < entries.size() && it != files.end(); ++i, ++it) {
+    const Entry &entry = entries[i];
+    const ZipLocalFile &zipFile = **it;
+    std::string kind = what + ", " + (entry.deflated ? "deflated " : "stored ") + entry.name;
+    Expect(zipFile.GetFileName() == entry.name, kind + ": name " + zipFile.GetFileName());
+    Expect(zipFile.GetUnCompDataSize() == entry.data.size(),
+           kind + ": size " + std::to_string(zipFile.GetUnCompDataSize()));
+    if (zipFile.GetUnCompDataSize() != entry.data.size()) {
+      continue;
+    }
+    const uint8 *data = zipFile.GetUnCompData();
+    Expect(entry.data.empty() || (data != nullptr && memcmp(data, entry.data.data(), entry.data.size()) == 0),
+           kind + ": content");
+    // stored entries are not copied out of the mapping
+    const uint8 *mapBegin = file.GetPtr();
+    const uint8 *mapEnd = mapBegin + file.GetLength();
+    bool inMapping = data != nullptr && data >= mapBegin && data < mapEnd;
+    if (!entry.data.empty()) {
+      Expect(inMapping == !entry.deflated, kind + (inMapping ? ": read from the mapping" : ": copied"));
+    }
+  }
+  file.Close();
+  (void)unlink(path);
+}
+}  // namespace
+
+int main() {
+  TestJar("stored only", { { "a/A.class", ClassLikeData(300, 1), false },
+                           { "a/B.class", ClassLikeData(1, 2), false } });
+  TestJar("deflated only", { { "a/A.class", ClassLikeData(5000, 3), true },
+                             { "a/B.class", ClassLikeData(70000, 4), true } });
+  TestJar("mixed", { { "META-INF/MANIFEST.MF", "Manifest-Version: 1.0\r\n", false },
+                     { "a/A.class", ClassLikeData(4096, 5), true },
+                     { "a/B.class", ClassLikeData(777, 6), false },
+                     { "a/empty/", "", false },
+                     { "a/C.class", ClassLikeData(12345, 7), true },
+                     { "a/Empty.class", "", true },
+                     { "a/D.class", ClassLikeData(64, 8), false } });
+  if (failures != 0) {
+    std::cerr << failures << " failures\n";
+    return 1;
+  }
+  std::cout << "SimpleZip: all checks passed\n";
+  return 0;
+}